@@ -7,6 +7,9 @@
 #include "./TRACE/TRACE.h"
 
 #include "./CAN_IF/CAN_IF.h"
+#include "./COM/COM.h"
+#include "./ISOTP/ISOTP.h"
+#include "./UDS/UDS.h"
 
 /**************************************************************************************************/
 /* Function Name   : main                                                                         */
@@ -22,15 +25,34 @@
 
 int main()
 {
+    INT32U u32_lTick;
+    INT32U u32_lLastTick;
+    
+    /* The diagnostic ISO TP connection registers its IDs before CAN IF builds the filters */
+    UDS_Init();
     CAN_IF_Init();
+    COM_Init();
+    
+    u32_lLastTick = CAN_IF_GetTickCount();
     
-    /* CAN TX data */
-    uint8_t can_tx_data[8] = {1, 2, 3, 9, 4, 8, 7, 7};
-
     while(1)
     {
-        CAN_IF_WriteMsg(2, 0, (INT8U *)&can_tx_data[0], 8);
-        for(INT32U u32_lIndex = 0; u32_lIndex < 1000000; u32_lIndex++);
+        /* Deliver the frames received in the mean time, cyclic frames are sent from the */
+        /* LPIT0 tick of CAN IF                                                          */
+        CAN_IF_MainFunction();
+        
+        /* 1 ms tasks, once per CAN IF tick */
+        u32_lTick = CAN_IF_GetTickCount();
+        if(u32_lTick != u32_lLastTick)
+        {
+            u32_lLastTick = u32_lTick;
+            ISOTP_MainFunction();
+            UDS_MainFunction();
+        }
+        
+        /* Sleep until the next interrupt, the CAN IF tick always runs and wakes the core at least */
+        /* every CAN_IF_TICK_US, for the bus off recovery and the time stamp extension            */
+        __asm volatile("wfi");
     }
 }
 
@@ -53,6 +53,9 @@ int FlexCAN_TestInit(void)
 
 void CAN_Module_Init_Loopback(void)
 {
+    flexcan_bit_timing_config_t bit_timing_config;
+    flexcan_bit_timing_t bit_timing;
+    uint32_t pe_clock;
 
     /* Initialize and configure clocks
      * 	see clock manager component for details
@@ -67,15 +70,24 @@ void CAN_Module_Init_Loopback(void)
     Pins_DRV_Init(NUM_OF_CONFIGURED_PINS, g_pin_mux_InitConfigArr);
 
 
-     /* Initialization of CAN RX/TX  callback function handler */       
-    CAN_Mgr_Init(CAN_TX_Confirmation , CAN_Rx_Notification);
-    
     /* Initialize FlexCAN driver */
     FLEXCAN_DRV_Init(FSL_CANCOM1, &canCom1_State, &canCom1_InitConfig0);
 
-    /* Set bit rate */
-    flexcan_time_segment_t myBitRate = {0x04, 0x07, 0x01, 0x00, 1};
-    FLEXCAN_DRV_SetBitrate(FSL_CANCOM1, &myBitRate);
+     /* Initialization of CAN RX/TX  callback function handler */       
+    CAN_Mgr_Init(FSL_CANCOM1, CAN_TX_Confirmation , CAN_Rx_Notification);
+
+    /* Set bit rate : 500 kbit/s, sample point at 87.5 %, solved for the PE clock */
+    bit_timing_config.bitrate = 500000UL;
+    bit_timing_config.samplePoint = 875U;
+    bit_timing_config.sjw = 2U;
+    bit_timing_config.bitrateFd = 0U;
+    bit_timing_config.samplePointFd = 0U;
+    bit_timing_config.sjwFd = 0U;
+    if ((FLEXCAN_DRV_GetPeClockFreq(FSL_CANCOM1, &pe_clock) == FLEXCAN_STATUS_SUCCESS) &&
+        (FLEXCAN_DRV_ComputeBitTiming(pe_clock, &bit_timing_config, &bit_timing) == FLEXCAN_STATUS_SUCCESS))
+    {
+        FLEXCAN_DRV_SetBitrate(FSL_CANCOM1, &bit_timing.nominal);
+    }
 
     g_dataInfo_rx.data_length = 8U;
     g_dataInfo_rx.msg_id_type = FLEXCAN_MSG_ID_STD;
@@ -56,13 +56,23 @@
 flexcan_state_t canCom1_State; 
 
 const flexcan_user_config_t canCom1_InitConfig0 = {
+#if (CANCOM1_FD_ENABLE == 1U)
+  .fd_enable = true,
+  .pe_clock = FLEXCAN_CLK_SOURCE_SOSCDIV2,
+  .max_num_mb = 7U,
+  .num_id_filters = FLEXCAN_RX_FIFO_ID_FILTERS_8,
+  .is_rx_fifo_needed = false,
+  .flexcanMode = FLEXCAN_LOOPBACK_MODE,     
+  .payload = FLEXCAN_PAYLOAD_SIZE_64,
+#else
   .fd_enable = false,
   .pe_clock = FLEXCAN_CLK_SOURCE_SOSCDIV2,
-  .max_num_mb = 2U,
+  .max_num_mb = 16U,
   .num_id_filters = FLEXCAN_RX_FIFO_ID_FILTERS_8,
   .is_rx_fifo_needed = false,
   .flexcanMode = FLEXCAN_LOOPBACK_MODE,     
   .payload = FLEXCAN_PAYLOAD_SIZE_8,
+#endif
 };
 
 
@@ -27,8 +27,8 @@
 **         FLEXCAN_DRV_RxFifoBlocking          - flexcan_status_t FLEXCAN_DRV_RxFifoBlocking(uint8_t...
 **         FLEXCAN_DRV_RxFifo                  - flexcan_status_t FLEXCAN_DRV_RxFifo(uint8_t instance,flexcan_msgbuff_t * data);
 **         FLEXCAN_DRV_IRQHandler              - void FLEXCAN_DRV_IRQHandler(uint8_t instance);
-**         FLEXCAN_DRV_GetTransmitStatus       - flexcan_status_t FLEXCAN_DRV_GetTransmitStatus(uint32_t instance);
-**         FLEXCAN_DRV_GetReceiveStatus        - flexcan_status_t FLEXCAN_DRV_GetReceiveStatus(uint32_t instance);
+**         FLEXCAN_DRV_GetTransmitStatus       - flexcan_status_t FLEXCAN_DRV_GetTransmitStatus(uint32_t instance,uint32_t mb_idx);
+**         FLEXCAN_DRV_GetReceiveStatus        - flexcan_status_t FLEXCAN_DRV_GetReceiveStatus(uint32_t instance,uint32_t mb_idx);
 **
 **     Copyright : 1997 - 2015 Freescale Semiconductor, Inc. 
 **     All Rights Reserved.
@@ -79,6 +79,10 @@
 
 /*! @brief Device instance number */
 #define FSL_CANCOM1 (0U)
+/*! @brief 1 : CAN FD with 64 byte MBs (7 MBs), 0 : classic CAN with 8 byte MBs (16 MBs) */
+#ifndef CANCOM1_FD_ENABLE
+#define CANCOM1_FD_ENABLE (0U)
+#endif
 /*! @brief Driver state structure which holds driver runtime data */
 extern flexcan_state_t canCom1_State; 
 /*! @brief Common configuration declaration */
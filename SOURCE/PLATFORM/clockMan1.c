@@ -150,6 +150,13 @@ peripheral_clock_config_t peripheralClockConfig0[NUM_OF_CONFIGURED_PERIPHERAL_CL
         .frac             = MULTIPLY_BY_ONE,
         .divider          = DIVIDE_BY_ONE,
     },
+    {
+        .clockName        = PCC_LPIT0_CLOCK,
+        .clkGate          = true,
+        .clkSrc           = CLK_SRC_SIRC,
+        .frac             = MULTIPLY_BY_ONE,
+        .divider          = DIVIDE_BY_ONE,
+    },
     {
         .clockName        = PCC_RTC0_CLOCK,
         .clkGate          = true,
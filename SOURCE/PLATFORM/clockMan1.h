@@ -78,7 +78,7 @@ extern clock_manager_user_config_t clockMan1_InitConfig0;
 extern clock_manager_user_config_t const *g_clockManConfigsArr[];
 
 /*! @brief Count of peripheral clock user configurations */
-#define NUM_OF_CONFIGURED_PERIPHERAL_CLOCKS_0 23U
+#define NUM_OF_CONFIGURED_PERIPHERAL_CLOCKS_0 24U
 
 
 /*! @brief Count of user Callbacks */
@@ -31,6 +31,7 @@
 #define __FSL_FLEXCAN_DRIVER_H__
 
 #include "fsl_flexcan_hal.h"
+#include "fsl_edma_driver.h"
 
 /* TODO - Put back define FSL_FEATURE_SOC_FLEXCAN_COUNT */
 #if 1
@@ -62,22 +63,214 @@ extern const IRQn_Type g_flexcanBusOffIrqId[];
 /*! @brief Table to save message buffer IRQ numbers for FlexCAN instances. */
 extern const IRQn_Type g_flexcanOredMessageBufferIrqId[];
 
+/*! @brief Number of message buffers tracked by the driver state (S32K144 has 32 MBs
+ *         per instance). Bit n of the state bitmaps refers to message buffer n. */
+#define FLEXCAN_MAX_MB_NUM      (32U)
+
+/*! @brief Set to 1 in profiling builds to measure the message buffer ISR with the DWT
+ *         cycle counter. The figures are read back with FLEXCAN_DRV_GetIsrStats(). */
+#ifndef FLEXCAN_ISR_PROFILING
+#define FLEXCAN_ISR_PROFILING   (0U)
+#endif
+
+/*! @brief Number of frames the FlexCAN RX FIFO can hold. */
+#define FLEXCAN_RXFIFO_DEPTH    (6U)
+
+/*! @brief Number of received frames the driver can hold until they are released,
+ *         must be a power of 2. */
+#ifndef FLEXCAN_RX_FRAME_NUM
+#define FLEXCAN_RX_FRAME_NUM    (16U)
+#endif
+
+/*! @brief Largest payload a received frame slot holds, in bytes (64 for CAN FD,
+ *         8 is enough for classic CAN only). */
+#ifndef FLEXCAN_RX_FRAME_PAYLOAD
+#define FLEXCAN_RX_FRAME_PAYLOAD (64U)
+#endif
+
+/*! @brief Payload words of a received frame. */
+#define FLEXCAN_RX_FRAME_WORDS  (FLEXCAN_RX_FRAME_PAYLOAD / 4U)
+
+/*!
+ * @brief Received frame, stored in a driver-owned slot.
+ *
+ * The frame is copied once out of the message buffer (or RX FIFO output) RAM.
+ * Consumers get a read-only view through the Rx callback or
+ * FLEXCAN_DRV_PeekRxFrame() and hand the slot back with FLEXCAN_DRV_ReleaseRxFrame().
+ */
+typedef struct FlexCANRxFrame {
+    uint32_t msgId;                  /*!< Identifier (standard IDs right aligned). */
+    uint32_t cs;                     /*!< Code and status word (EDL, BRS, DLC, IDE, RTR, 16-bit time stamp). */
+    uint32_t timeStamp;              /*!< Reception time, see FLEXCAN_DRV_GetTime(). */
+    uint8_t mbIdx;                   /*!< Message buffer the frame was received in. */
+    uint8_t length;                  /*!< Payload size in bytes. */
+    uint32_t data[FLEXCAN_RX_FRAME_WORDS]; /*!< Payload, byte n of the frame at byte offset n. */
+} flexcan_rx_frame_t;
+
+/*! @brief Received frame slot statistics. */
+typedef struct FlexCANRxFrameStats {
+    uint32_t highWater;              /*!< Highest number of frames waiting for release. */
+    uint32_t overflowCount;          /*!< Frames dropped because no slot was free. */
+} flexcan_rx_frame_stats_t;
+
+/*! @brief FlexCAN RX FIFO statistics (continuous RX FIFO mode). */
+typedef struct FlexCANRxFifoStats {
+    uint32_t frameCount;             /*!< Number of frames read from the RX FIFO. */
+    uint32_t warningCount;           /*!< Number of "FIFO almost full" (IFLAG6) events. */
+    uint32_t overflowCount;          /*!< Number of "FIFO overflow" (IFLAG7) events. */
+} flexcan_rx_fifo_stats_t;
+
+/*!
+ * @brief Frame written by the RX FIFO DMA transfer.
+ *
+ * Raw copy of the 16 bytes of the RX FIFO output. The payload words keep the
+ * FlexCAN byte order (data byte 0 in the most significant byte of data[0]), use
+ * FLEXCAN_DRV_DecodeDmaFrame() to convert a frame to a flexcan_msgbuff_t.
+ */
+typedef struct FlexCANDmaFrame {
+    uint32_t cs;                     /*!< Code and status word (DLC, IDE, RTR, time stamp). */
+    uint32_t id;                     /*!< Identifier word. */
+    uint32_t data[2];                /*!< Payload words. */
+} flexcan_dma_frame_t;
+
+/*! @brief RX FIFO DMA callback, called on half-full and full of the frame ring.
+ *         producerIdx is the index of the next ring slot the DMA will write. */
+typedef void (*flexcan_dma_rx_callback_t)(uint8_t instance, uint32_t producerIdx);
+
+/*! @brief FlexCAN message buffer ISR statistics. */
+typedef struct FlexCANIsrStats {
+    uint32_t isrEntries;             /*!< Number of ISR entries. */
+    uint32_t isrFrames;              /*!< Number of MB/FIFO events serviced. */
+    uint32_t isrCycles;              /*!< Core cycles spent inside the ISR (DWT_CYCCNT). */
+    uint32_t isrMaxCycles;           /*!< Longest single ISR entry in core cycles. */
+} flexcan_isr_stats_t;
+
+/*! @brief Fault confinement state of the node (ESR1[FLTCONF]). */
+typedef enum {
+    FLEXCAN_FAULT_ERROR_ACTIVE = 0U, /*!< Error active. */
+    FLEXCAN_FAULT_ERROR_PASSIVE,     /*!< Error passive, TEC or REC above 127. */
+    FLEXCAN_FAULT_BUS_OFF            /*!< Bus off, TEC above 255. */
+} flexcan_fault_conf_t;
+
+/*! @brief Bus off recovery, see FLEXCAN_DRV_SetBusOffRecovery(). */
+typedef enum {
+    FLEXCAN_BUSOFF_RECOVERY_AUTO = 0U, /*!< Leave bus off after 128 occurrences of 11 recessive bits. */
+    FLEXCAN_BUSOFF_RECOVERY_MANUAL   /*!< Stay in bus off until FLEXCAN_DRV_RecoverBusOff(). */
+} flexcan_busoff_recovery_t;
+
+/*! @brief Event reported through the error callback. */
+typedef enum {
+    FLEXCAN_ERROR_EVENT_PASSIVE = 0U, /*!< Entered error passive. */
+    FLEXCAN_ERROR_EVENT_ACTIVE,      /*!< Back to error active, from error passive or bus off. */
+    FLEXCAN_ERROR_EVENT_BUS_OFF,     /*!< Entered bus off. */
+    FLEXCAN_ERROR_EVENT_BUS_OFF_DONE /*!< 128 occurrences of 11 recessive bits seen in bus off. */
+} flexcan_error_event_t;
+
+/*!
+ * @brief Bus error statistics, kept up to date by the error interrupts.
+ *
+ * The error bits of ESR1 are latched until read, so several errors of the same
+ * class between two reads count once; overrunCount tells how often that happened.
+ * Times are on the FLEXCAN_DRV_GetTime() timebase.
+ */
+typedef struct FlexCANErrorStats {
+    uint32_t bit0ErrCount;           /*!< Recessive bit read while sending a dominant bit. */
+    uint32_t bit1ErrCount;           /*!< Dominant bit read while sending a recessive bit. */
+    uint32_t stuffErrCount;          /*!< Stuffing errors. */
+    uint32_t crcErrCount;            /*!< CRC errors. */
+    uint32_t formErrCount;           /*!< Form errors. */
+    uint32_t ackErrCount;            /*!< Frames sent without acknowledge. */
+    uint32_t fastErrCount;           /*!< Errors of the FD data phase, also counted by class. */
+    uint32_t overrunCount;           /*!< Errors which occurred before the previous ones were read. */
+    uint32_t errorPassiveCount;      /*!< Transitions to error passive. */
+    uint32_t busOffCount;            /*!< Transitions to bus off. */
+    uint32_t busOffDoneCount;        /*!< Completed bus off recovery sequences. */
+    uint32_t lastErrorTime;          /*!< Time of the last error read. */
+    uint32_t errorPassiveTime;       /*!< Time of the last transition to error passive. */
+    uint32_t errorActiveTime;        /*!< Time of the last return to error active. */
+    uint32_t busOffTime;             /*!< Time of the last transition to bus off. */
+    uint32_t busOffDoneTime;         /*!< Time of the last completed recovery sequence. */
+    uint8_t txErrCounter;            /*!< Transmit error counter (TEC) at the last update. */
+    uint8_t rxErrCounter;            /*!< Receive error counter (REC) at the last update. */
+    uint8_t txErrPeak;               /*!< Highest TEC seen. */
+    uint8_t rxErrPeak;               /*!< Highest REC seen. */
+    uint8_t faultConf;               /*!< Fault confinement state, see flexcan_fault_conf_t. */
+} flexcan_error_stats_t;
+
+/*! @brief Use of a message buffer, recorded once it passed the configuration checks. */
+typedef enum {
+    FLEXCAN_MB_DIR_NONE = 0U,        /*!< Not validated yet, handled by the checked HAL path. */
+    FLEXCAN_MB_DIR_TX,               /*!< Validated transmit MB. */
+    FLEXCAN_MB_DIR_RX,               /*!< Validated receive MB. */
+    FLEXCAN_MB_DIR_RESPONSE          /*!< Remote request auto-response MB. */
+} flexcan_mb_dir_t;
+
+/*! @brief Message buffer descriptor, computed at init for the per-frame paths. */
+typedef struct FlexCANMbDesc {
+    volatile uint32_t *mb;           /*!< Start of the MB in the FlexCAN RAM, NULL beyond MAXMB. */
+    uint8_t payloadSize;             /*!< Size of the MB data area in bytes. */
+    uint8_t direction;               /*!< See flexcan_mb_dir_t. */
+    uint32_t responseCs;             /*!< C/S word arming a remote response MB. */
+    uint32_t txCs;                   /*!< Frame format bits (IDE, EDL, BRS) of the frame in a
+                                          Tx MB, see FLEXCAN_DRV_SendPayload(). */
+    uint8_t txPadding;               /*!< FD padding byte of the frame in a Tx MB. */
+} flexcan_mb_desc_t;
+
+/*! @brief Tx confirmation callback, called from the ISR of the given instance. */
+typedef void (*FlexCAN_TRCV_CALLBACK)(uint8_t instance, mailBox_t *pValue);
+
+/*! @brief Rx indication callback, called from the ISR once the frame is stored in
+ *         its slot. The frame stays valid until FLEXCAN_DRV_ReleaseRxFrame(). */
+typedef void (*FlexCAN_RX_CALLBACK)(uint8_t instance, const flexcan_rx_frame_t *frame);
+
+/*! @brief Error callback, called on fault confinement transitions with the statistics
+ *         already updated. Called from the ISR or, with the interrupts disabled, from
+ *         FLEXCAN_DRV_GetErrorStats() and FLEXCAN_DRV_RecoverBusOff(). */
+typedef void (*FlexCAN_ERROR_CALLBACK)(uint8_t instance, flexcan_error_event_t event,
+                                       const flexcan_error_stats_t *stats);
+
 /*!
  * @brief Internal driver state information.
  *
+ * The transmit/receive bookkeeping is kept per message buffer so that every
+ * configured MB can have a frame in flight at the same time.
+ *
  * @note The contents of this structure are internal to the driver and should not be
  *      modified by users. Also, contents of the structure are subject to change in
  *      future releases.
  */
 typedef struct FlexCANState {
-    flexcan_msgbuff_t *fifo_message; /*!< The FlexCAN receive FIFO data*/
-    flexcan_msgbuff_t *mb_message;   /*!< The FlexCAN receive MB data*/
-    volatile uint32_t rx_mb_idx;     /*!< Index of the message buffer for receiving*/
-    volatile uint32_t tx_mb_idx;     /*!< Index of the message buffer for transmitting*/
-    volatile bool isTxBusy;          /*!< True if there is an active transmit. */
-    volatile bool isRxBusy;          /*!< True if there is an active receive. */
+    flexcan_msgbuff_t *fifo_message;                    /*!< The FlexCAN receive FIFO data*/
+    flexcan_msgbuff_t *mb_message[FLEXCAN_MAX_MB_NUM];  /*!< The FlexCAN receive data of each MB*/
+    volatile uint32_t mbTxBusy;      /*!< Bitmap of MBs with an active transmit. */
+    volatile uint32_t mbRxBusy;      /*!< Bitmap of MBs with an active receive. */
+    volatile uint32_t mbTxDir;       /*!< Bitmap of MBs configured for transmitting. */
+    flexcan_mb_desc_t mbDesc[FLEXCAN_MAX_MB_NUM]; /*!< MB descriptors, see flexcan_mb_desc_t. */
+    volatile bool isFifoBusy;        /*!< True if there is an active RX FIFO receive. */
+    volatile bool isFifoContinuous;  /*!< True if the RX FIFO stays armed after each frame. */
+    flexcan_rx_fifo_stats_t fifoStats; /*!< RX FIFO frame, warning and overflow counters. */
+    uint8_t instance;                /*!< FlexCAN instance owning this state. */
+    edma_chn_state_t *rxDmaChn;      /*!< eDMA channel of the RX FIFO DMA mode, NULL if unused. */
+    flexcan_dma_frame_t *rxDmaRing;  /*!< Frame ring written by the RX FIFO DMA. */
+    uint32_t rxDmaRingSize;          /*!< Number of frames in rxDmaRing. */
+    volatile uint32_t rxDmaLaps;     /*!< Number of times the DMA wrapped around rxDmaRing. */
+    flexcan_dma_rx_callback_t rxDmaCallback; /*!< Half-full / full notification. */
     volatile bool isTxBlocking;      /*!< True if transmit is blocking transaction. */
     volatile bool isRxBlocking;      /*!< True if receive is blocking transaction. */
+    flexcan_rx_frame_t rxFrames[FLEXCAN_RX_FRAME_NUM]; /*!< Received frame slots. */
+    volatile uint32_t rxFrameHead;   /*!< Next slot written by the ISR. */
+    volatile uint32_t rxFrameTail;   /*!< Oldest slot not released yet. */
+    flexcan_rx_frame_stats_t rxFrameStats; /*!< Received frame slot statistics. */
+    uint32_t timerHigh;              /*!< Wrap count of the free running timer, in its upper 16 bits. */
+    uint16_t timerLast;              /*!< Free running timer value at the last extension. */
+    FlexCAN_TRCV_CALLBACK txCallback; /*!< Tx confirmation callback, see CAN_Mgr_Init(). */
+    FlexCAN_RX_CALLBACK rxCallback;  /*!< Rx indication callback, see CAN_Mgr_Init(). */
+    FlexCAN_ERROR_CALLBACK errorCallback; /*!< Error callback, see FLEXCAN_DRV_InstallErrorCallback(). */
+    flexcan_error_stats_t errorStats; /*!< Bus error statistics. */
+    flexcan_busoff_recovery_t busOffRecovery; /*!< Bus off recovery mode. */
+#if FLEXCAN_ISR_PROFILING
+    flexcan_isr_stats_t isrStats;    /*!< Message buffer ISR cycle statistics. */
+#endif
 } flexcan_state_t;
 
 /*! @brief FlexCAN data info from user*/
@@ -103,6 +296,30 @@ typedef struct FLEXCANUserConfig {
     flexcan_clk_source_t pe_clock;                  /*!< The clock source of the CAN Protocol Engine (PE). */
 } flexcan_user_config_t;
 
+/*! @brief FlexCAN bit timing request, see FLEXCAN_DRV_ComputeBitTiming() */
+typedef struct FLEXCANBitTimingConfig {
+    uint32_t bitrate;                   /*!< Nominal (arbitration phase) bit rate in bit/s */
+    uint32_t samplePoint;               /*!< Nominal sample point in per mille of the bit time */
+    uint32_t sjw;                       /*!< Nominal resync jump width in time quanta, 0: largest possible */
+    uint32_t bitrateFd;                 /*!< FD data phase bit rate in bit/s, 0: no data phase timing */
+    uint32_t samplePointFd;             /*!< Data phase sample point in per mille of the bit time */
+    uint32_t sjwFd;                     /*!< Data phase resync jump width in time quanta, 0: largest possible */
+} flexcan_bit_timing_config_t;
+
+/*! @brief FlexCAN bit timing computed by FLEXCAN_DRV_ComputeBitTiming() */
+typedef struct FLEXCANBitTiming {
+    flexcan_time_segment_t nominal;     /*!< Nominal time segments (CTRL1 field values) */
+    flexcan_time_segment_cbt_t data;    /*!< Data phase time segments (FDCBT field values) */
+    uint32_t peClock;                   /*!< Protocol engine clock in Hz */
+    uint32_t bitrate;                   /*!< Achieved nominal bit rate in bit/s */
+    int32_t bitrateError;               /*!< Nominal bit rate error in ppm of the requested bit rate */
+    uint32_t samplePoint;               /*!< Achieved nominal sample point in per mille */
+    uint32_t bitrateFd;                 /*!< Achieved data phase bit rate in bit/s, 0 if not requested */
+    int32_t bitrateErrorFd;             /*!< Data phase bit rate error in ppm of the requested bit rate */
+    uint32_t samplePointFd;             /*!< Achieved data phase sample point in per mille */
+    uint32_t tdcOffset;                 /*!< Transceiver delay compensation offset in PE clock cycles */
+} flexcan_bit_timing_t;
+
 /*******************************************************************************
  * API
  ******************************************************************************/
@@ -133,6 +350,9 @@ flexcan_status_t FLEXCAN_DRV_SetBitrate(uint8_t instance, flexcan_time_segment_t
 /*!
  * @brief Sets the FlexCAN bit rate for FD BRS.
  *
+ * Sets the data phase time segments, enables the bit rate switch and the
+ * transceiver delay compensation, its offset placed on the data phase sample point.
+ *
  * @param   instance    A FlexCAN instance number
  * @param   bitrate     A pointer to the FlexCAN bit rate settings.
  *
@@ -149,6 +369,41 @@ flexcan_status_t FLEXCAN_DRV_SetBitrateCbt(uint8_t instance, flexcan_time_segmen
  */
 flexcan_status_t FLEXCAN_DRV_GetBitrate(uint8_t instance, flexcan_time_segment_t *bitrate);
 
+/*!
+ * @brief Gets the FlexCAN protocol engine clock frequency.
+ *
+ * The clock source selected by FLEXCAN_DRV_Init() is read back: SOSCDIV2 or
+ * the peripheral (system) clock of the instance.
+ *
+ * @param   instance    A FlexCAN instance number
+ * @param   frequency   Returned PE clock frequency in Hz
+ *
+ * @return  0 if successful; non-zero failed
+ */
+flexcan_status_t FLEXCAN_DRV_GetPeClockFreq(uint8_t instance, uint32_t *frequency);
+
+/*!
+ * @brief Computes the bit timing closest to a requested bit rate and sample point.
+ *
+ * Every prescaler is tried; the number of time quanta per bit nearest to the
+ * requested bit rate is split into segments placing the sample point as close
+ * as possible to the requested one. The lowest bit rate error wins, then the
+ * lowest sample point error, then the lowest prescaler. The data phase is
+ * solved the same way on the FDCBT field ranges and the transceiver delay
+ * compensation offset is placed on its sample point.
+ *
+ * @param   peClock     Protocol engine clock in Hz
+ * @param   config      Requested bit rates, sample points and resync jump widths
+ * @param   timing      Returned time segments and achieved values
+ *
+ * @return  0 if successful; FLEXCAN_STATUS_OUT_OF_RANGE if a bit rate cannot be
+ *          reached with the PE clock
+ */
+flexcan_status_t FLEXCAN_DRV_ComputeBitTiming(
+    uint32_t peClock,
+    const flexcan_bit_timing_config_t *config,
+    flexcan_bit_timing_t *timing);
+
 /*@}*/
 
 /*!
@@ -245,6 +500,10 @@ uint32_t FLEXCAN_DRV_Deinit(uint8_t instance);
 /*!
  * @brief FlexCAN transmit message buffer field configuration.
  *
+ * The MB keeps the ID and frame format until another frame is sent through it
+ * with FLEXCAN_DRV_Send(), and its interrupt stays enabled: the frames of the
+ * ID can be sent with FLEXCAN_DRV_SendPayload().
+ *
  * @param   instance                   A FlexCAN instance number
  * @param   mb_idx                     Index of the message buffer
  * @param   tx_info                    Data info
@@ -293,6 +552,65 @@ flexcan_status_t FLEXCAN_DRV_Send(
     uint32_t msg_id,
     uint8_t *mb_data);
 
+/*!
+ * @brief Sends a frame with the ID and frame format already held by a Tx MB.
+ *
+ * Only the payload words and the C/S word (code and DLC) are written. The MB
+ * must have been set up by FLEXCAN_DRV_ConfigTxMb() or FLEXCAN_DRV_Send().
+ *
+ * @param   instance   A FlexCAN instance number
+ * @param   mb_idx     Index of the message buffer
+ * @param   mb_data    Bytes of the FlexCAN message
+ * @param   length     Payload size in bytes, up to 8 for a classic frame
+ * @return  0 if successful; FLEXCAN_STATUS_TX_BUSY if the MB still sends a frame,
+ *          FLEXCAN_STATUS_INVALID_ARGUMENT if the MB is no Tx MB or the length does
+ *          not fit the frame format
+ */
+flexcan_status_t FLEXCAN_DRV_SendPayload(
+    uint8_t instance,
+    uint32_t mb_idx,
+    const uint8_t *mb_data,
+    uint32_t length);
+
+
+/*!
+ * @brief Configures a message buffer answering remote requests in hardware.
+ *
+ * A remote request frame with the MB ID is answered by the controller with the
+ * current MB payload, without interrupt and without CPU involvement. The MB
+ * stays armed after each response. Remote frames only exist in the classic
+ * frame format. The acceptance mask of the MB applies to the request ID.
+ *
+ * @param   instance   A FlexCAN instance number
+ * @param   mb_idx     Index of the message buffer
+ * @param   tx_info    Data info of the response (classic frame, up to 8 bytes)
+ * @param   msg_id     ID answered by the message buffer
+ * @param   mb_data    Initial response payload, NULL to keep the MB data area
+ * @return  0 if successful; non-zero failed
+ */
+flexcan_status_t FLEXCAN_DRV_ConfigRemoteResponseMb(
+    uint8_t instance,
+    uint32_t mb_idx,
+    const flexcan_data_info_t *tx_info,
+    uint32_t msg_id,
+    const uint8_t *mb_data);
+
+/*!
+ * @brief Updates the payload of a remote response message buffer.
+ *
+ * The MB is taken out of the matching while its payload is written, so that a
+ * response never carries a partly updated payload. A request arriving in that
+ * window of a few bus clock cycles is not answered.
+ *
+ * @param   instance   A FlexCAN instance number
+ * @param   mb_idx     Index of a message buffer set up by FLEXCAN_DRV_ConfigRemoteResponseMb()
+ * @param   mb_data    New payload, of the length given at configuration
+ * @return  0 if successful; FLEXCAN_STATUS_INVALID_ARGUMENT if the MB is no response MB
+ */
+flexcan_status_t FLEXCAN_DRV_UpdateRemoteResponseMb(
+    uint8_t instance,
+    uint32_t mb_idx,
+    const uint8_t *mb_data);
 
 /*@}*/
 
@@ -330,6 +648,28 @@ flexcan_status_t FLEXCAN_DRV_ConfigRxFifo(
     flexcan_rx_fifo_id_element_format_t id_format,
     flexcan_id_table_t *id_filter_table);
 
+/*!
+ * @brief Sets one format A RX FIFO filter element with its own ID mask.
+ *
+ * FLEXCAN_DRV_ConfigRxFifo() has to select format A first. Masks of the first
+ * RxFifoIndividualMaskElementNum() elements are only used in the individual
+ * masking mode (FLEXCAN_DRV_SetRxMaskType()); the following elements only take
+ * an exact ID.
+ *
+ * @param   instance     A FlexCAN instance number
+ * @param   element_idx  Index of the filter element
+ * @param   id_type      A standard ID or an extended ID
+ * @param   id           ID to accept
+ * @param   mask         ID bits to compare
+ * @return  0 if successful; non-zero failed.
+ */
+flexcan_status_t FLEXCAN_DRV_SetRxFifoFilterElement(
+    uint8_t instance,
+    uint32_t element_idx,
+    flexcan_msgbuff_id_type_t id_type,
+    uint32_t id,
+    uint32_t mask);
+
 /*!
  * @brief FlexCAN is waiting to receive data from the message buffer.
  *
@@ -348,9 +688,15 @@ flexcan_status_t FLEXCAN_DRV_RxMessageBufferBlocking(
 /*!
  * @brief FlexCAN is waiting to receive data from the message buffer.
  *
+ * With a user buffer the next frame is copied into it and the receive completes.
+ * With data == NULL the MB stays armed: every frame is stored in a driver slot
+ * and reported through the Rx callback registered with CAN_Mgr_Init(), the MB is
+ * neither re-configured nor its interrupt toggled per frame. The receive runs
+ * until FLEXCAN_DRV_AbortReceivingData().
+ *
  * @param   instance   A FlexCAN instance number
  * @param   mb_idx     Index of the message buffer
- * @param   data       The FlexCAN receive message buffer data.
+ * @param   data       The FlexCAN receive message buffer data, or NULL.
  * @return  0 if successful; non-zero failed
  */
 flexcan_status_t FLEXCAN_DRV_RxMessageBuffer(
@@ -382,6 +728,77 @@ flexcan_status_t FLEXCAN_DRV_RxFifo(
     uint8_t instance,
     flexcan_msgbuff_t *data);
 
+/*!
+ * @brief Starts the continuous RX FIFO receive.
+ *
+ * The RX FIFO interrupts stay enabled, every interrupt drains all the frames
+ * queued in the FIFO and each frame is reported through the Rx callback
+ * registered with CAN_Mgr_Init(). FIFO warning and overflow events are counted.
+ * The mode is stopped with FLEXCAN_DRV_CompleteRxMessageFifoData().
+ *
+ * @param   instance    A FlexCAN instance number
+ * @return  0 if successful; non-zero failed
+ */
+flexcan_status_t FLEXCAN_DRV_StartRxFifoContinuous(uint8_t instance);
+
+/*!
+ * @brief Starts the RX FIFO DMA receive.
+ *
+ * Every frame arriving in the RX FIFO is moved by the eDMA into the next slot of
+ * the frame ring, without CPU involvement. The ring is used circularly and the
+ * callback is called when the DMA reaches the half and the end of the ring.
+ * The eDMA driver must have been initialized with EDMA_DRV_Init() and the RX FIFO
+ * enabled in the FlexCAN user configuration.
+ *
+ * @param   instance    A FlexCAN instance number
+ * @param   dmaChn      eDMA channel state memory, kept valid until the mode is stopped
+ * @param   dmaChannel  eDMA channel number or EDMA_ANY_CHANNEL
+ * @param   ring        Frame ring
+ * @param   frameCount  Number of frames in the ring, even and at most 0x7FFE
+ * @param   callback    Half-full / full notification, may be NULL
+ * @return  0 if successful; non-zero failed
+ */
+flexcan_status_t FLEXCAN_DRV_StartRxFifoDma(
+    uint8_t instance,
+    edma_chn_state_t *dmaChn,
+    uint8_t dmaChannel,
+    flexcan_dma_frame_t *ring,
+    uint32_t frameCount,
+    flexcan_dma_rx_callback_t callback);
+
+/*!
+ * @brief Stops the RX FIFO DMA receive and releases the eDMA channel.
+ *
+ * @param   instance    A FlexCAN instance number
+ */
+void FLEXCAN_DRV_StopRxFifoDma(uint8_t instance);
+
+/*!
+ * @brief Returns the index of the next ring slot the RX FIFO DMA will write.
+ *
+ * @param   instance    A FlexCAN instance number
+ * @param   laps        If not NULL, receives the number of ring wrap-arounds
+ * @return  Producer index in the frame ring
+ */
+uint32_t FLEXCAN_DRV_GetRxFifoDmaIndex(uint8_t instance, uint32_t *laps);
+
+/*!
+ * @brief Converts a frame captured by the RX FIFO DMA to a message buffer structure.
+ *
+ * @param   frame       Frame from the DMA ring
+ * @param   msgBuff     Decoded frame (cs, msgId, data in byte order)
+ */
+void FLEXCAN_DRV_DecodeDmaFrame(const flexcan_dma_frame_t *frame, flexcan_msgbuff_t *msgBuff);
+
+/*!
+ * @brief Returns the RX FIFO statistics of a FlexCAN instance.
+ *
+ * @param   instance    A FlexCAN instance number
+ * @param   stats       Pointer to the structure receiving a copy of the statistics.
+ * @param   clear       True to reset the statistics after reading them.
+ */
+void FLEXCAN_DRV_GetRxFifoStats(uint8_t instance, flexcan_rx_fifo_stats_t *stats, bool clear);
+
 /*@}*/
 
 /*!
@@ -391,11 +808,98 @@ flexcan_status_t FLEXCAN_DRV_RxFifo(
  */
 void FLEXCAN_DRV_IRQHandler(uint8_t instance);
 
+/*!
+ * @name Bus error management
+ * @{
+ */
+
+/*!
+ * @brief Installs the error callback of a FlexCAN instance.
+ *
+ * @param   instance    A FlexCAN instance number
+ * @param   callback    Error callback, NULL to remove it
+ */
+void FLEXCAN_DRV_InstallErrorCallback(uint8_t instance, FlexCAN_ERROR_CALLBACK callback);
+
+/*!
+ * @brief Returns the bus error statistics of a FlexCAN instance.
+ *
+ * The statistics are maintained by the error interrupts; the call only brings
+ * the error counters and the fault confinement state up to date, which also
+ * catches the silent return from error passive to error active.
+ *
+ * @param   instance    A FlexCAN instance number
+ * @param   stats       Pointer to the structure receiving a copy of the statistics.
+ * @param   clear       True to reset the event counters and peaks after reading them.
+ */
+void FLEXCAN_DRV_GetErrorStats(uint8_t instance, flexcan_error_stats_t *stats, bool clear);
+
+/*!
+ * @brief Selects how the instance leaves bus off.
+ *
+ * In manual mode the node stays in bus off until FLEXCAN_DRV_RecoverBusOff(),
+ * so that the application can apply its own back-off delay.
+ *
+ * @param   instance    A FlexCAN instance number
+ * @param   mode        Automatic or manual recovery
+ */
+void FLEXCAN_DRV_SetBusOffRecovery(uint8_t instance, flexcan_busoff_recovery_t mode);
+
+/*!
+ * @brief Releases a node held in bus off (manual recovery).
+ *
+ * The node leaves bus off once 128 occurrences of 11 recessive bits have been
+ * seen since the bus off, immediately if that already happened
+ * (FLEXCAN_ERROR_EVENT_BUS_OFF_DONE reported). The hold is armed again when the
+ * node is back to error active.
+ *
+ * @param   instance    A FlexCAN instance number
+ * @return  FLEXCAN_STATUS_SUCCESS, or FLEXCAN_STATUS_FAIL if the node is not in bus off
+ */
+flexcan_status_t FLEXCAN_DRV_RecoverBusOff(uint8_t instance);
+
+/*@}*/
 
-void FLEXCAN_DRV_CompleteSendData(uint32_t instance);
-void FLEXCAN_DRV_CompleteRxMessageBufferData(uint32_t instance);
+#if FLEXCAN_ISR_PROFILING
+/*!
+ * @brief Returns the message buffer ISR statistics of a FlexCAN instance.
+ *
+ * The average cost of a frame is isrCycles / isrFrames.
+ *
+ * @param   instance    The FlexCAN instance number.
+ * @param   stats       Pointer to the structure receiving a copy of the statistics.
+ * @param   clear       True to reset the statistics after reading them.
+ */
+void FLEXCAN_DRV_GetIsrStats(uint8_t instance, flexcan_isr_stats_t *stats, bool clear);
+#endif
+
+
+void FLEXCAN_DRV_CompleteSendData(uint32_t instance, uint32_t mb_idx);
+void FLEXCAN_DRV_CompleteRxMessageBufferData(uint32_t instance, uint32_t mb_idx);
 void FLEXCAN_DRV_CompleteRxMessageFifoData(uint32_t instance);
 
+/*!
+ * @brief Ends a non-blocking transmission on a message buffer early.
+ *
+ * The abort is asynchronous: the MB stays busy until its interrupt fires, and
+ * the Tx callback reports whether the frame was withdrawn (mb_aborted) or
+ * had already been sent.
+ *
+ * @param instance A FlexCAN instance number
+ * @param mb_idx   Index of the message buffer
+ * @return FLEXCAN_STATUS_SUCCESS or FLEXCAN_STATUS_NO_TRANSMIT_IN_PROGRESS
+ */
+flexcan_status_t FLEXCAN_DRV_AbortSendingData(uint32_t instance, uint32_t mb_idx);
+
+/*!
+ * @brief Ends a non-blocking receive on a message buffer early.
+ *
+ * @param instance A FlexCAN instance number
+ * @param mb_idx   Index of the message buffer
+ * @return FLEXCAN_STATUS_SUCCESS or FLEXCAN_STATUS_NO_RECEIVE_IN_PROGRESS
+ */
+flexcan_status_t FLEXCAN_DRV_AbortReceivingData(uint32_t instance, uint32_t mb_idx);
+
 /*!
  * @brief Returns whether the previous FLEXCAN transmit has finished.
  *
@@ -403,11 +907,12 @@ void FLEXCAN_DRV_CompleteRxMessageFifoData(uint32_t instance);
  * current transmission: in progress (or busy) or complete (success).
  *
  * @param instance The FLEXCAN module base address.
+ * @param mb_idx   Index of the message buffer
  * @return The transmit status.
  * @retval FLEXCAN_STATUS_SUCCESS The transmit has completed successfully.
  * @retval FLEXCAN_STATUS_TX_BUSY The transmit is still in progress.
  */
-flexcan_status_t FLEXCAN_DRV_GetTransmitStatus(uint32_t instance);
+flexcan_status_t FLEXCAN_DRV_GetTransmitStatus(uint32_t instance, uint32_t mb_idx);
 
 /*!
  * @brief Returns whether the previous FLEXCAN receive is complete.
@@ -416,23 +921,59 @@ flexcan_status_t FLEXCAN_DRV_GetTransmitStatus(uint32_t instance);
  * current receive progress: in progress (or busy) or complete (success).
  *
  * @param instance The FLEXCAN module base address.
- * @param bytesRemaining A pointer to a value that is filled in with the number of bytes which
- *                       still need to be received in the active transfer.
+ * @param mb_idx   Index of the message buffer
  * @return The receive status.
  * @retval FLEXCAN_STATUS_SUCCESS The receive has completed successfully.
  * @retval FLEXCAN_STATUS_RX_BUSY The receive is still in progress.
  */
-flexcan_status_t FLEXCAN_DRV_GetReceiveStatus(uint32_t instance);
+flexcan_status_t FLEXCAN_DRV_GetReceiveStatus(uint32_t instance, uint32_t mb_idx);
+
+/*!
+ * @brief Returns the oldest received frame not released yet.
+ *
+ * Frames are stored by the ISR for the message buffers started without a user
+ * buffer (FLEXCAN_DRV_RxMessageBuffer() with data == NULL) and for the
+ * continuous RX FIFO mode. Single consumer, the slot stays valid until it is
+ * released.
+ *
+ * @param   instance    A FlexCAN instance number
+ * @return  Frame, or NULL if no frame is pending
+ */
+const flexcan_rx_frame_t * FLEXCAN_DRV_PeekRxFrame(uint8_t instance);
+
+/*!
+ * @brief Releases the oldest received frame (the one FLEXCAN_DRV_PeekRxFrame() returns).
+ *
+ * @param   instance    A FlexCAN instance number
+ */
+void FLEXCAN_DRV_ReleaseRxFrame(uint8_t instance);
 
-typedef void (*FlexCAN_TRCV_CALLBACK)(mailBox_t *pValue);
+/*!
+ * @brief Returns the received frame slot statistics.
+ *
+ * @param   instance    A FlexCAN instance number
+ * @param   stats       Copy of the statistics
+ * @param   clear       true to reset the statistics after reading them
+ */
+void FLEXCAN_DRV_GetRxFrameStats(uint8_t instance, flexcan_rx_frame_stats_t *stats, bool clear);
 
-typedef struct can_notifiaction {
-  FlexCAN_TRCV_CALLBACK pEntry;
-  mailBox_t *pValue; 
-}CAN_Notification_t;
+/*!
+ * @brief Returns the free running timer extended to 32 bits.
+ *
+ * The FlexCAN timer counts nominal bit times and wraps at 16 bits; the driver
+ * counts the wraps each time it reads the timer (every MB interrupt and every
+ * call of this function). Rx frame and Tx confirmation time stamps are on the
+ * same timebase. At least one read per 65536 bit times is needed (131 ms at
+ * 500 kbit/s), a periodic call of this function guarantees it.
+ *
+ * @param   instance    A FlexCAN instance number
+ * @return  Current time in bit times
+ */
+uint32_t FLEXCAN_DRV_GetTime(uint8_t instance);
 
-extern void CAN_Mgr_Init(FlexCAN_TRCV_CALLBACK tx_Handler,\
-                                  FlexCAN_TRCV_CALLBACK rx_Handler);
+extern void CAN_Mgr_Init(uint8_t instance,
+                         FlexCAN_TRCV_CALLBACK tx_Handler,
+                         FlexCAN_RX_CALLBACK rx_Handler);
 
 extern flexcan_status_t FLEXCAN_UpdateMailBoxMask(
     uint8_t instance,
@@ -38,19 +38,96 @@
  * Definitions
  ******************************************************************************/
 
+/* Count leading zeros, used to walk the pending message buffer flags */
+#if defined(__ICCARM__)
+    #include <intrinsics.h>
+    #define FLEXCAN_CLZ(x)          ((uint32_t)__CLZ(x))
+#elif defined(__GNUC__)
+    #define FLEXCAN_CLZ(x)          ((uint32_t)__builtin_clz(x))
+#else
+    #error "FLEXCAN_CLZ is not defined for this compiler"
+#endif
+
+/* Orders the received frame slot writes before the index update */
+#if defined(__ICCARM__)
+    #define FLEXCAN_DMB()           __DMB()
+#else
+    #define FLEXCAN_DMB()           __asm volatile ("dmb" ::: "memory")
+#endif
+
+#if ((FLEXCAN_RX_FRAME_NUM == 0U) || ((FLEXCAN_RX_FRAME_NUM & (FLEXCAN_RX_FRAME_NUM - 1U)) != 0U))
+#error "FLEXCAN_RX_FRAME_NUM must be a power of 2"
+#endif
+
+#if ((FLEXCAN_RX_FRAME_PAYLOAD < 8U) || (FLEXCAN_RX_FRAME_PAYLOAD > 64U) || ((FLEXCAN_RX_FRAME_PAYLOAD & 3U) != 0U))
+#error "FLEXCAN_RX_FRAME_PAYLOAD must be a multiple of 4 between 8 and 64"
+#endif
+
+/* Extends a 16-bit time stamp taken within +/-32768 bit times of the extended time now */
+#define FLEXCAN_EXTEND_STAMP(now, stamp) \
+    ((uint32_t)((now) - (uint32_t)(int32_t)(int16_t)(uint16_t)((uint16_t)(now) - (uint16_t)(stamp))))
+
+/* ESR1 interrupt flags (write 1 to clear) */
+#define FLEXCAN_ERR_INT_FLAGS \
+    (CAN_ESR1_WAKINT_MASK | CAN_ESR1_ERRINT_MASK | CAN_ESR1_BOFFINT_MASK | \
+     CAN_ESR1_RWRNINT_MASK | CAN_ESR1_TWRNINT_MASK | CAN_ESR1_BOFFDONEINT_MASK | \
+     CAN_ESR1_ERRINT_FAST_MASK | CAN_ESR1_ERROVR_MASK)
+
+/* ESR1 error bits of the FD data phase (cleared by reading ESR1) */
+#define FLEXCAN_ERR_FAST_BITS \
+    (CAN_ESR1_STFERR_FAST_MASK | CAN_ESR1_FRMERR_FAST_MASK | CAN_ESR1_CRCERR_FAST_MASK | \
+     CAN_ESR1_BIT0ERR_FAST_MASK | CAN_ESR1_BIT1ERR_FAST_MASK)
+
+/* Time quanta limits of one bit timing register set, see FLEXCAN_DRV_SolveBitTiming() */
+typedef struct {
+    uint32_t maxPresdiv;        /* Prescaler */
+    uint32_t minProp;           /* Propagation segment */
+    uint32_t maxProp;
+    uint32_t maxPseg1;          /* Phase segment 1, at least 1 */
+    uint32_t maxPseg2;          /* Phase segment 2, at least 2 */
+    uint32_t maxSjw;            /* Resync jump width */
+    uint32_t minTq;             /* Time quanta per bit */
+} flexcan_bit_limits_t;
+
+/* Solved bit timing, in time quanta */
+typedef struct {
+    uint32_t presdiv;
+    uint32_t prop;
+    uint32_t pseg1;
+    uint32_t pseg2;
+    uint32_t sjw;
+    uint32_t bitrate;
+    int32_t error;              /* ppm */
+    uint32_t samplePoint;       /* per mille */
+} flexcan_bit_solution_t;
+
+#if FLEXCAN_ISR_PROFILING
+/* Cortex-M4 DWT cycle counter */
+#define FLEXCAN_DEMCR               (*(volatile uint32_t *)0xE000EDFCUL)
+#define FLEXCAN_DEMCR_TRCENA_MASK   (0x01000000UL)
+#define FLEXCAN_DWT_CTRL            (*(volatile uint32_t *)0xE0001000UL)
+#define FLEXCAN_DWT_CTRL_CYCCNTENA  (0x00000001UL)
+#define FLEXCAN_DWT_CYCCNT          (*(volatile uint32_t *)0xE0001004UL)
+#endif
+
 /*******************************************************************************
  * Variables
  ******************************************************************************/
    
-/** Arvind added */
-
-FlexCAN_TRCV_CALLBACK CAN_TX_EventHandler,CAN_RX_EventHandler;
-/** End */   
-   
-   
 /* Pointer to runtime state structure.*/
 flexcan_state_t * g_flexcanStatePtr[CAN_INSTANCE_COUNT] = { NULL };
 
+/* PE clock of each instance when it runs from the peripheral clock */
+static const clock_names_t s_flexcanClockName[CAN_INSTANCE_COUNT] = {
+    PCC_FLEXCAN0_CLOCK, PCC_FLEXCAN1_CLOCK, PCC_FLEXCAN2_CLOCK
+};
+
+/* CTRL1 nominal bit timing : PRESDIV, PROPSEG, PSEG1, PSEG2 and RJW field ranges + 1 */
+static const flexcan_bit_limits_t s_flexcanNominalLimits = { 256U, 1U, 8U, 8U, 8U, 4U, 8U };
+
+/* FDCBT data phase bit timing : FPROPSEG has no + 1 */
+static const flexcan_bit_limits_t s_flexcanDataLimits = { 1024U, 0U, 31U, 8U, 8U, 8U, 5U };
+
 /*******************************************************************************
  * Private Functions
  ******************************************************************************/
@@ -74,10 +151,25 @@ static flexcan_status_t FLEXCAN_DRV_StartRxMessageFifoData(
 //void FLEXCAN_DRV_CompleteRxMessageBufferData(uint32_t instance);
 //void FLEXCAN_DRV_CompleteRxMessageFifoData(uint32_t instance);
 
-/** Arvind Added */
-    CAN_Notification_t CallBack_fun ;
-    mailBox_t mailBox_Buffer ;
-/** End */
+static void FLEXCAN_DRV_UpdateErrorState(CAN_Type * base, flexcan_state_t * state, uint32_t now);
+static void FLEXCAN_DRV_ResetErrorStats(flexcan_error_stats_t * stats, bool all);
+static uint32_t FLEXCAN_DRV_DrainRxFifo(CAN_Type * base, flexcan_state_t * state, uint32_t now);
+static void FLEXCAN_DRV_RxFifoDmaCallback(void *parameter, edma_chn_status_t status);
+static const flexcan_rx_frame_t * FLEXCAN_DRV_StoreRxFrame(
+                    flexcan_state_t * state,
+                    volatile const uint32_t *flexcan_mb,
+                    uint32_t mb_idx,
+                    uint32_t now);
+static uint32_t FLEXCAN_DRV_ExtendTimer(flexcan_state_t * state, uint32_t timer);
+static bool FLEXCAN_DRV_SolveBitTiming(
+                    uint32_t peClock,
+                    uint32_t bitrate,
+                    uint32_t samplePoint,
+                    uint32_t sjw,
+                    const flexcan_bit_limits_t *limits,
+                    flexcan_bit_solution_t *solution);
+static uint32_t FLEXCAN_DRV_TdcOffset(const flexcan_time_segment_cbt_t *bitrate);
+static uint32_t FLEXCAN_DRV_TxFormatCs(const flexcan_data_info_t *tx_info);
     
 /*******************************************************************************
  * Code
@@ -109,6 +201,8 @@ flexcan_status_t FLEXCAN_DRV_SetBitrate(uint8_t instance, flexcan_time_segment_t
  * Description   : Set FlexCAN bitrate.
  * This function will set up all the time segment values. Those time segment
  * values are passed in by the user and are based on the required baudrate.
+ * The bit rate switch is enabled and the transceiver delay compensation
+ * offset is placed on the data phase sample point, in PE clock cycles.
  *
  *END**************************************************************************/
 flexcan_status_t FLEXCAN_DRV_SetBitrateCbt(uint8_t instance, flexcan_time_segment_cbt_t *bitrate)
@@ -116,9 +210,19 @@ flexcan_status_t FLEXCAN_DRV_SetBitrateCbt(uint8_t instance, flexcan_time_segmen
 #ifdef DEV_ERROR_DETECT
     DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
 #endif
+    CAN_Type * base = g_flexcanBase[instance];
+    uint32_t tdc_offset;
+
+    if (!FLEXCAN_HAL_IsFDEnabled(base))
+    {
+        return FLEXCAN_STATUS_FAIL;
+    }
 
     /* Set time segments*/
-    FLEXCAN_HAL_SetTimeSegmentsCbt(g_flexcanBase[instance], bitrate);
+    FLEXCAN_HAL_SetTimeSegmentsCbt(base, bitrate);
+
+    tdc_offset = FLEXCAN_DRV_TdcOffset(bitrate);
+    FLEXCAN_HAL_SetFDDataPhase(base, true, true, tdc_offset);
 
     return FLEXCAN_STATUS_SUCCESS;
 }
@@ -142,6 +246,91 @@ flexcan_status_t  FLEXCAN_DRV_GetBitrate(uint8_t instance, flexcan_time_segment_
     return FLEXCAN_STATUS_SUCCESS;
 }
 
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_GetPeClockFreq
+ * Description   : Get the FlexCAN protocol engine clock frequency.
+ * The PE clock is either SOSCDIV2, which the clock manager does not expose by
+ * name, or the peripheral clock of the instance.
+ *
+ *END**************************************************************************/
+flexcan_status_t FLEXCAN_DRV_GetPeClockFreq(uint8_t instance, uint32_t *frequency)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+#endif
+
+    if (FLEXCAN_HAL_GetClock(g_flexcanBase[instance]))
+    {
+        if (CLOCK_SYS_GetFreq(s_flexcanClockName[instance], frequency) != CLOCK_MANAGER_SUCCESS)
+        {
+            *frequency = 0U;
+        }
+    }
+    else
+    {
+        *frequency = SCG_HAL_GetSysOscAsyncFreq(SCG, SCG_ASYNC_CLOCK_DIV2);
+    }
+
+    return (*frequency != 0U) ? FLEXCAN_STATUS_SUCCESS : FLEXCAN_STATUS_FAIL;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_ComputeBitTiming
+ * Description   : Compute the FlexCAN bit timing.
+ * The nominal phase is solved on the CTRL1 field ranges and the data phase,
+ * when requested, on the FDCBT field ranges. The returned segments are field
+ * values, ready for FLEXCAN_DRV_SetBitrate() and FLEXCAN_DRV_SetBitrateCbt().
+ *
+ *END**************************************************************************/
+flexcan_status_t FLEXCAN_DRV_ComputeBitTiming(
+    uint32_t peClock,
+    const flexcan_bit_timing_config_t *config,
+    flexcan_bit_timing_t *timing)
+{
+    flexcan_bit_solution_t solution;
+
+    timing->peClock = peClock;
+    if (!FLEXCAN_DRV_SolveBitTiming(peClock, config->bitrate, config->samplePoint,
+                                    config->sjw, &s_flexcanNominalLimits, &solution))
+    {
+        return FLEXCAN_STATUS_OUT_OF_RANGE;
+    }
+    timing->nominal.preDivider = solution.presdiv - 1U;
+    timing->nominal.propSeg = solution.prop - 1U;
+    timing->nominal.phaseSeg1 = solution.pseg1 - 1U;
+    timing->nominal.phaseSeg2 = solution.pseg2 - 1U;
+    timing->nominal.rJumpwidth = solution.sjw - 1U;
+    timing->bitrate = solution.bitrate;
+    timing->bitrateError = solution.error;
+    timing->samplePoint = solution.samplePoint;
+
+    timing->bitrateFd = 0U;
+    timing->bitrateErrorFd = 0;
+    timing->samplePointFd = 0U;
+    timing->tdcOffset = 0U;
+    if (config->bitrateFd != 0U)
+    {
+        if (!FLEXCAN_DRV_SolveBitTiming(peClock, config->bitrateFd, config->samplePointFd,
+                                        config->sjwFd, &s_flexcanDataLimits, &solution))
+        {
+            return FLEXCAN_STATUS_OUT_OF_RANGE;
+        }
+        timing->data.preDividerFd = solution.presdiv - 1U;
+        timing->data.propSegFd = solution.prop;
+        timing->data.phaseSeg1Fd = solution.pseg1 - 1U;
+        timing->data.phaseSeg2Fd = solution.pseg2 - 1U;
+        timing->data.rJumpwidthFd = solution.sjw - 1U;
+        timing->bitrateFd = solution.bitrate;
+        timing->bitrateErrorFd = solution.error;
+        timing->samplePointFd = solution.samplePoint;
+        timing->tdcOffset = FLEXCAN_DRV_TdcOffset(&timing->data);
+    }
+
+    return FLEXCAN_STATUS_SUCCESS;
+}
+
 /*FUNCTION**********************************************************************
  *
  * Function Name : FLEXCAN_DRV_SetMasktype
@@ -286,6 +475,8 @@ flexcan_status_t FLEXCAN_DRV_Init(
 #endif
 
     flexcan_status_t result;
+    uint32_t i;
+    uint8_t payload_size;
     CAN_Type * base = g_flexcanBase[instance];
 
     FLEXCAN_HAL_Disable(base);
@@ -308,6 +499,19 @@ flexcan_status_t FLEXCAN_DRV_Init(
     }
 
     FLEXCAN_HAL_SetMaxMsgBuffNum(base, data->max_num_mb);
+
+    /* Pending transmissions can be withdrawn (FLEXCAN_DRV_AbortSendingData) */
+    FLEXCAN_HAL_SetAbortCmd(base, true);
+
+    /* Remote requests are answered by the RANSWER MBs (FLEXCAN_DRV_ConfigRemoteResponseMb) */
+    FLEXCAN_HAL_SetRemoteResponseCmd(base, true);
+
+    /* The RX FIFO only holds classic frames, it cannot be used with FD */
+    if (data->is_rx_fifo_needed && data->fd_enable)
+    {
+        return FLEXCAN_STATUS_INVALID_ARGUMENT;
+    }
+
     if (data->is_rx_fifo_needed)
     {
         FLEXCAN_HAL_EnableRxFifo(base, data->num_id_filters);
@@ -345,14 +549,69 @@ flexcan_status_t FLEXCAN_DRV_Init(
     INT_SYS_EnableIRQ(g_flexcanBusOffIrqId[instance]);
     INT_SYS_EnableIRQ(g_flexcanOredMessageBufferIrqId[instance]);
 
-    state->isTxBusy = false;
-    state->isRxBusy = false;
+    state->mbTxBusy = 0U;
+    state->mbRxBusy = 0U;
+    state->mbTxDir = 0U;
+    state->isFifoBusy = false;
+    state->isFifoContinuous = false;
     state->fifo_message = NULL;
-    state->rx_mb_idx = 0;
-    state->tx_mb_idx = 0;
+    state->fifoStats.frameCount = 0U;
+    state->fifoStats.warningCount = 0U;
+    state->fifoStats.overflowCount = 0U;
+    state->instance = (uint8_t)instance;
+    state->rxDmaChn = NULL;
+    state->rxDmaRing = NULL;
+    state->rxDmaRingSize = 0U;
+    state->rxDmaLaps = 0U;
+    state->rxDmaCallback = NULL;
+    state->rxFrameHead = 0U;
+    state->rxFrameTail = 0U;
+    state->rxFrameStats.highWater = 0U;
+    state->rxFrameStats.overflowCount = 0U;
+    state->timerHigh = 0U;
+    state->timerLast = (uint16_t)(base->TIMER);
+    state->txCallback = NULL;
+    state->rxCallback = NULL;
+    state->errorCallback = NULL;
+    FLEXCAN_DRV_ResetErrorStats(&state->errorStats, true);
+    state->busOffRecovery = FLEXCAN_BUSOFF_RECOVERY_AUTO;
+    FLEXCAN_HAL_SetBusOffRecoveryCmd(base, true);
+    /* MB addresses only depend on the payload size, which is fixed from now on.
+     * Every MB is validated again by its first configuration or transmission. */
+    payload_size = FLEXCAN_HAL_GetPayloadSize(base);
+    for (i = 0U; i < FLEXCAN_MAX_MB_NUM; i++)
+    {
+        state->mb_message[i] = NULL;
+        state->mbDesc[i].mb = (i < data->max_num_mb) ? FLEXCAN_HAL_GetMsgBuffRegion(base, i) : NULL;
+        state->mbDesc[i].payloadSize = payload_size;
+        state->mbDesc[i].direction = (uint8_t)FLEXCAN_MB_DIR_NONE;
+        state->mbDesc[i].responseCs = 0U;
+        state->mbDesc[i].txCs = 0U;
+        state->mbDesc[i].txPadding = 0U;
+    }
+#if FLEXCAN_ISR_PROFILING
+    state->isrStats.isrEntries = 0U;
+    state->isrStats.isrFrames = 0U;
+    state->isrStats.isrCycles = 0U;
+    state->isrStats.isrMaxCycles = 0U;
+
+    /* Start the DWT cycle counter */
+    FLEXCAN_DEMCR |= FLEXCAN_DEMCR_TRCENA_MASK;
+    FLEXCAN_DWT_CTRL |= FLEXCAN_DWT_CTRL_CYCCNTENA;
+#endif
     /* Save runtime structure pointers so irq handler can point to the correct state structure */
     g_flexcanStatePtr[instance] = state;
 
+    /* Error interrupts stay enabled, they feed the bus error statistics */
+    FLEXCAN_HAL_ClearErrStatusFlags(base, FLEXCAN_ERR_INT_FLAGS);
+    FLEXCAN_HAL_SetErrIntCmd(base, FLEXCAN_INT_ERR, true);
+    FLEXCAN_HAL_SetErrIntCmd(base, FLEXCAN_INT_BUSOFF, true);
+    FLEXCAN_HAL_SetErrIntCmd(base, FLEXCAN_INT_BUSOFF_DONE, true);
+    if (data->fd_enable)
+    {
+        FLEXCAN_HAL_SetErrIntCmd(base, FLEXCAN_INT_ERR_FAST, true);
+    }
+
     return (FLEXCAN_STATUS_SUCCESS);
 }
 
@@ -364,7 +623,8 @@ flexcan_status_t FLEXCAN_DRV_Init(
  * the function will make sure if the MB requested is not occupied by RX FIFO
  * and ID filter table. Then this function will set up the message buffer fields,
  * configure the message buffer code for Tx buffer as INACTIVE, and enable the
- * Message Buffer interrupt.
+ * Message Buffer interrupt. The interrupt stays enabled across transmissions,
+ * FLEXCAN_DRV_SendPayload() then only writes the payload and C/S words.
  *
  *END**************************************************************************/
 flexcan_status_t FLEXCAN_DRV_ConfigTxMb(
@@ -375,17 +635,37 @@ flexcan_status_t FLEXCAN_DRV_ConfigTxMb(
 {
 #ifdef DEV_ERROR_DETECT
     DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    DEV_ASSERT(mb_idx < FLEXCAN_MAX_MB_NUM);
 #endif
+    flexcan_status_t result;
     flexcan_msgbuff_code_status_t cs;
     CAN_Type * base = g_flexcanBase[instance];
     flexcan_state_t * state = g_flexcanStatePtr[instance];
 
-    state->tx_mb_idx = mb_idx;
+    if (state->mbTxBusy & (1UL << mb_idx))
+    {
+        return FLEXCAN_STATUS_TX_BUSY;
+    }
+    state->mbTxDir |= (1UL << mb_idx);
+    state->mbDesc[mb_idx].direction = (uint8_t)FLEXCAN_MB_DIR_NONE;
     /* Initialize transmit mb*/
     cs.dataLen = tx_info->data_length;
     cs.msgIdType = tx_info->msg_id_type;
+    cs.fd_enable = tx_info->fd_enable;
+    cs.fd_padding = tx_info->fd_padding;
+    cs.enable_brs = tx_info->enable_brs;
     cs.code = FLEXCAN_TX_INACTIVE;
-    return FLEXCAN_HAL_SetTxMsgBuff(base, mb_idx, &cs, msg_id, NULL);
+    result = FLEXCAN_HAL_SetTxMsgBuff(base, mb_idx, &cs, msg_id, NULL);
+    if (result == FLEXCAN_STATUS_SUCCESS)
+    {
+        /* The MB passed the range and RX FIFO checks, sends can skip them */
+        state->mbDesc[mb_idx].direction = (uint8_t)FLEXCAN_MB_DIR_TX;
+        state->mbDesc[mb_idx].txCs = FLEXCAN_DRV_TxFormatCs(tx_info);
+        state->mbDesc[mb_idx].txPadding = tx_info->fd_padding;
+        FLEXCAN_HAL_ClearMsgBuffIntStatusFlag(base, (1UL << mb_idx));
+        FLEXCAN_HAL_SetMsgBuffIntCmd(base, mb_idx, true);
+    }
+    return result;
 }
 
 /*FUNCTION**********************************************************************
@@ -412,6 +692,8 @@ flexcan_status_t FLEXCAN_DRV_SendBlocking(
     flexcan_state_t * state = g_flexcanStatePtr[instance];
     CAN_Type * base  = g_flexcanBase[instance];
 
+    /* The completion is polled here, not taken by the ISR */
+    FLEXCAN_HAL_SetMsgBuffIntCmd(base, mb_idx, false);
 
     state->isTxBlocking = true;
     result = FLEXCAN_DRV_StartSendData(instance, mb_idx, tx_info, msg_id, mb_data);
@@ -425,19 +707,24 @@ flexcan_status_t FLEXCAN_DRV_SendBlocking(
             timeout--;
         } while ((timeout) > 0 && (status == 0U));
 
+        state->mbTxBusy &= ~(1UL << mb_idx);
         if (status == 1U)
         {
-            state->isTxBusy = false;
-            FLEXCAN_HAL_ClearMsgBuffIntStatusFlag(base, (1 << mb_idx));
-            return FLEXCAN_STATUS_SUCCESS;
+            FLEXCAN_HAL_ClearMsgBuffIntStatusFlag(base, (1UL << mb_idx));
+            result = FLEXCAN_STATUS_SUCCESS;
         }
         else
         {
-            state->isTxBusy = false;
-            return FLEXCAN_STATUS_TIME_OUT;
+            result = FLEXCAN_STATUS_TIME_OUT;
         }
     }
 
+    /* Validated Tx MBs keep their interrupt enabled between frames */
+    if (state->mbDesc[mb_idx].direction == (uint8_t)FLEXCAN_MB_DIR_TX)
+    {
+        FLEXCAN_HAL_SetMsgBuffIntCmd(base, mb_idx, true);
+    }
+
     return result;
 }
 
@@ -462,15 +749,18 @@ flexcan_status_t FLEXCAN_DRV_Send(
     flexcan_status_t result;
     flexcan_state_t * state = g_flexcanStatePtr[instance];
     CAN_Type * base = g_flexcanBase[instance];
+    /* A validated Tx MB already has its interrupt enabled */
+    bool int_enabled = (state->mbDesc[mb_idx].direction == (uint8_t)FLEXCAN_MB_DIR_TX);
 
     state->isTxBlocking = false;
     result = FLEXCAN_DRV_StartSendData(instance, mb_idx, tx_info, msg_id, mb_data);
     if(result == FLEXCAN_STATUS_SUCCESS)
     {
-        /* Enable message buffer interrupt*/
-        FLEXCAN_HAL_SetMsgBuffIntCmd(base, mb_idx, true);
-        /* Enable error interrupts */
-        FLEXCAN_HAL_SetErrIntCmd(base,FLEXCAN_INT_ERR,true);
+        if (!int_enabled)
+        {
+            /* Enable message buffer interrupt*/
+            FLEXCAN_HAL_SetMsgBuffIntCmd(base, mb_idx, true);
+        }
     }
     else
     {
@@ -480,6 +770,153 @@ flexcan_status_t FLEXCAN_DRV_Send(
     return (FLEXCAN_STATUS_SUCCESS);
 }
 
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_SendPayload
+ * Description   : Send a frame with the ID and format held by a Tx MB.
+ * The ID word and the frame format bits were written by FLEXCAN_DRV_ConfigTxMb
+ * or the last FLEXCAN_DRV_Send of the MB. Its interrupt stays enabled and the
+ * ISR acknowledges the completion before the Tx callback, so only the payload
+ * words and the C/S word are written here.
+ *
+ *END**************************************************************************/
+flexcan_status_t FLEXCAN_DRV_SendPayload(
+    uint8_t instance,
+    uint32_t mb_idx,
+    const uint8_t *mb_data,
+    uint32_t length)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    DEV_ASSERT(mb_idx < FLEXCAN_MAX_MB_NUM);
+#endif
+    uint32_t mb_cs;
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+    const flexcan_mb_desc_t * desc = &state->mbDesc[mb_idx];
+
+    if ((desc->direction != (uint8_t)FLEXCAN_MB_DIR_TX) || (length > desc->payloadSize) ||
+        (((desc->txCs & CAN_MB_EDL_MASK) == 0U) && (length > 8U)))
+    {
+        return FLEXCAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    /* The ISR updates the bitmap as well */
+    INT_SYS_DisableIRQGlobal();
+    if (state->mbTxBusy & (1UL << mb_idx))
+    {
+        INT_SYS_EnableIRQGlobal();
+        return FLEXCAN_STATUS_TX_BUSY;
+    }
+    state->mbTxBusy |= (1UL << mb_idx);
+    state->isTxBlocking = false;
+    INT_SYS_EnableIRQGlobal();
+
+    mb_cs = ((uint32_t)FLEXCAN_TX_DATA << CAN_CS_CODE_SHIFT) |
+            ((uint32_t)FLEXCAN_HAL_PayloadSizeToDlc(length) << CAN_CS_DLC_SHIFT) | desc->txCs;
+    FLEXCAN_HAL_WriteMsgBuffData(desc->mb + 2, mb_data, length,
+                                 FLEXCAN_HAL_DlcToPayloadSize(mb_cs >> CAN_CS_DLC_SHIFT),
+                                 desc->txPadding);
+    desc->mb[0] = mb_cs;
+
+    return FLEXCAN_STATUS_SUCCESS;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_ConfigRemoteResponseMb
+ * Description   : Configure a message buffer answering remote requests.
+ * The MB is written with the RANSWER code through FLEXCAN_HAL_SetTxMsgBuff,
+ * which also does the range and RX FIFO checks. Its interrupt stays disabled:
+ * the responses need no service. The C/S word is kept for the payload updates.
+ *
+ *END**************************************************************************/
+flexcan_status_t FLEXCAN_DRV_ConfigRemoteResponseMb(
+    uint8_t instance,
+    uint32_t mb_idx,
+    const flexcan_data_info_t *tx_info,
+    uint32_t msg_id,
+    const uint8_t *mb_data)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    DEV_ASSERT(mb_idx < FLEXCAN_MAX_MB_NUM);
+#endif
+    flexcan_status_t result;
+    flexcan_msgbuff_code_status_t cs;
+    CAN_Type * base = g_flexcanBase[instance];
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+    flexcan_mb_desc_t * desc = &state->mbDesc[mb_idx];
+
+    /* Remote frames have no FD format */
+    if ((tx_info->fd_enable != 0U) || (tx_info->data_length > 8U))
+    {
+        return FLEXCAN_STATUS_INVALID_ARGUMENT;
+    }
+    if ((state->mbTxBusy | state->mbRxBusy) & (1UL << mb_idx))
+    {
+        return FLEXCAN_STATUS_FAIL;
+    }
+
+    FLEXCAN_HAL_SetMsgBuffIntCmd(base, mb_idx, false);
+    state->mbTxDir &= ~(1UL << mb_idx);
+    desc->direction = (uint8_t)FLEXCAN_MB_DIR_NONE;
+
+    cs.dataLen = tx_info->data_length;
+    cs.msgIdType = tx_info->msg_id_type;
+    cs.fd_enable = 0U;
+    cs.fd_padding = 0U;
+    cs.enable_brs = 0U;
+    cs.code = FLEXCAN_RX_RANSWER;
+    result = FLEXCAN_HAL_SetTxMsgBuff(base, mb_idx, &cs, msg_id, (uint8_t *)mb_data);
+    if (result == FLEXCAN_STATUS_SUCCESS)
+    {
+        desc->responseCs = ((uint32_t)FLEXCAN_RX_RANSWER << CAN_CS_CODE_SHIFT) |
+                           ((uint32_t)FLEXCAN_HAL_PayloadSizeToDlc(tx_info->data_length) << CAN_CS_DLC_SHIFT) |
+                           ((tx_info->msg_id_type == FLEXCAN_MSG_ID_EXT) ? CAN_CS_IDE_MASK : 0U);
+        desc->direction = (uint8_t)FLEXCAN_MB_DIR_RESPONSE;
+    }
+    return result;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_UpdateRemoteResponseMb
+ * Description   : Write a new payload into a remote response message buffer.
+ * The MB is made inactive first so that it can neither match a request nor
+ * be moved out for a response while the payload words are written, then armed
+ * again with its C/S word. A response already moved out is sent unchanged.
+ *
+ *END**************************************************************************/
+flexcan_status_t FLEXCAN_DRV_UpdateRemoteResponseMb(
+    uint8_t instance,
+    uint32_t mb_idx,
+    const uint8_t *mb_data)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    DEV_ASSERT(mb_idx < FLEXCAN_MAX_MB_NUM);
+    DEV_ASSERT(mb_data);
+#endif
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+    const flexcan_mb_desc_t * desc = &state->mbDesc[mb_idx];
+    uint32_t length;
+
+    if (desc->direction != (uint8_t)FLEXCAN_MB_DIR_RESPONSE)
+    {
+        return FLEXCAN_STATUS_INVALID_ARGUMENT;
+    }
+    length = FLEXCAN_HAL_DlcToPayloadSize((desc->responseCs & CAN_CS_DLC_MASK) >> CAN_CS_DLC_SHIFT);
+
+    /* Keep the unanswered window as short as possible */
+    INT_SYS_DisableIRQGlobal();
+    desc->mb[0] = (uint32_t)FLEXCAN_TX_INACTIVE << CAN_CS_CODE_SHIFT;
+    FLEXCAN_HAL_WriteMsgBuffData(desc->mb + 2, mb_data, length, length, 0U);
+    desc->mb[0] = desc->responseCs;
+    INT_SYS_EnableIRQGlobal();
+
+    return FLEXCAN_STATUS_SUCCESS;
+}
+
 /*FUNCTION**********************************************************************
  *
  * Function Name : FLEXCAN_DRV_ConfigMb
@@ -507,7 +944,15 @@ flexcan_status_t FLEXCAN_DRV_ConfigRxMb(
     CAN_Type * base = g_flexcanBase[instance];
     flexcan_state_t * state = g_flexcanStatePtr[instance];
 
-    state->rx_mb_idx = mb_idx;
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(mb_idx < FLEXCAN_MAX_MB_NUM);
+#endif
+    if (state->mbRxBusy & (1UL << mb_idx))
+    {
+        return FLEXCAN_STATUS_RX_BUSY;
+    }
+    state->mbTxDir &= ~(1UL << mb_idx);
+    state->mbDesc[mb_idx].direction = (uint8_t)FLEXCAN_MB_DIR_NONE;
     cs.dataLen = rx_info->data_length;
     cs.msgIdType = rx_info->msg_id_type;
     cs.fd_enable = rx_info->fd_enable;
@@ -529,7 +974,12 @@ flexcan_status_t FLEXCAN_DRV_ConfigRxMb(
 
     /* Set up FlexCAN message buffer fields for receiving data*/
     cs.code = FLEXCAN_RX_EMPTY;
-    return FLEXCAN_HAL_SetRxMsgBuff(base, mb_idx, &cs, msg_id);
+    result = FLEXCAN_HAL_SetRxMsgBuff(base, mb_idx, &cs, msg_id);
+    if (result == FLEXCAN_STATUS_SUCCESS)
+    {
+        state->mbDesc[mb_idx].direction = (uint8_t)FLEXCAN_MB_DIR_RX;
+    }
+    return result;
 }
 
 /*FUNCTION**********************************************************************
@@ -551,14 +1001,42 @@ flexcan_status_t FLEXCAN_DRV_ConfigRxFifo(
     flexcan_status_t result;
     CAN_Type * base = g_flexcanBase[instance];
 
+    /* The filter table is only writable in freeze mode */
+    FLEXCAN_HAL_EnterFreezeMode(base);
+
     /* Initialize rx fifo*/
     result = FLEXCAN_HAL_SetRxFifoFilter(base, id_format, id_filter_table);
-    if(result)
+
+    FLEXCAN_HAL_ExitFreezeMode(base);
+
+    return result;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_SetRxFifoFilterElement
+ * Description   : Set one format A RX FIFO filter element and its mask.
+ *
+ *END**************************************************************************/
+flexcan_status_t FLEXCAN_DRV_SetRxFifoFilterElement(
+    uint8_t instance,
+    uint32_t element_idx,
+    flexcan_msgbuff_id_type_t id_type,
+    uint32_t id,
+    uint32_t mask)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+#endif
+    CAN_Type * base = g_flexcanBase[instance];
+
+    if ((id_type != FLEXCAN_MSG_ID_STD) && (id_type != FLEXCAN_MSG_ID_EXT))
     {
-         return result;
+        return FLEXCAN_STATUS_INVALID_ARGUMENT;
     }
 
-    return result;
+    return FLEXCAN_HAL_SetRxFifoFilterElement(base, element_idx,
+                                              (id_type == FLEXCAN_MSG_ID_EXT), id, mask);
 }
 
 /*FUNCTION**********************************************************************
@@ -596,15 +1074,14 @@ flexcan_status_t FLEXCAN_DRV_RxMessageBufferBlocking(
             timeout--;
         } while ((timeout) > 0 && (status == 0U));
 
+        state->mbRxBusy &= ~(1UL << mb_idx);
         if (status == 1U)
         {
-            state->isRxBusy = false;
-            FLEXCAN_HAL_ClearMsgBuffIntStatusFlag(base, (1 << mb_idx));
+            FLEXCAN_HAL_ClearMsgBuffIntStatusFlag(base, (1UL << mb_idx));
             result = FLEXCAN_HAL_GetMsgBuff(base, mb_idx, data);
         }
         else
         {
-            state->isRxBusy = false;
             return FLEXCAN_STATUS_TIME_OUT;
         }
     }
@@ -616,6 +1093,9 @@ flexcan_status_t FLEXCAN_DRV_RxMessageBufferBlocking(
  *
  * Function Name : FLEXCAN_DRV_RxMessageBuffer
  * Description   : Start receive data after a Rx MB interrupt occurs.
+ * Without a user buffer the receive is persistent: the ISR stores each frame
+ * in a driver slot and leaves the MB armed, with its interrupt enabled, until
+ * FLEXCAN_DRV_AbortReceivingData is called.
  *
  *END**************************************************************************/
 flexcan_status_t FLEXCAN_DRV_RxMessageBuffer(
@@ -625,7 +1105,6 @@ flexcan_status_t FLEXCAN_DRV_RxMessageBuffer(
 {
 #ifdef DEV_ERROR_DETECT
     DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
-    DEV_ASSERT(data);
 #endif
 
     flexcan_status_t result;
@@ -672,15 +1151,14 @@ flexcan_status_t FLEXCAN_DRV_RxFifoBlocking(
             timeout--;
         } while ((timeout) > 0 && (status == 0U));
 
+        state->isFifoBusy = false;
         if (status == 1U)
         {
-            state->isRxBusy = false;
             result = FLEXCAN_HAL_ReadRxFifo(base, data);
             FLEXCAN_HAL_ClearMsgBuffIntStatusFlag(base, 1 << FSL_FEATURE_CAN_RXFIFO_FRAME_AVAILABLE);
         }
         else
         {
-            state->isRxBusy = false;
             return FLEXCAN_STATUS_TIME_OUT;
         }
     }
@@ -746,8 +1224,6 @@ uint32_t FLEXCAN_DRV_Deinit(uint8_t instance)
  *
  *END**************************************************************************/
 
-#define X_FSL_CANCOM1       ( 0 )
-
 flexcan_status_t FLEXCAN_UpdateMailBoxMask(
     uint8_t instance,
     uint32_t msgBuffIdx,
@@ -759,139 +1235,245 @@ flexcan_status_t FLEXCAN_UpdateMailBoxMask(
 
 void FLEXCAN_DRV_IRQHandler(uint8_t instance)
 {
-    volatile uint32_t flag_reg;
+    uint32_t flag_reg;
+    uint32_t ack_mask;
+    uint32_t mb_idx;
     uint32_t temp;
+    uint32_t fifo_en;
+    flexcan_msgbuff_t *rx_buff;
+    const flexcan_rx_frame_t *rx_frame;
+    flexcan_msgbuff_t tx_buff;
+    mailBox_t tx_info;
+    uint32_t now;
     CAN_Type * base = g_flexcanBase[instance];
     flexcan_state_t * state = g_flexcanStatePtr[instance];
-    
+#if FLEXCAN_ISR_PROFILING
+    uint32_t start_cycles = FLEXCAN_DWT_CYCCNT;
+    uint32_t frames = 0U;
+#endif
+
     /* Get the interrupts that are enabled and ready */
     flag_reg = (((FLEXCAN_HAL_GetAllMsgBuffIntStatusFlag(base)) & \
                                     CAN_IMASK1_BUF31TO0M_MASK) & (base->IMASK1));
+    ack_mask = flag_reg;
+    fifo_en = BITBAND_ACCESS32(&(base->MCR), CAN_MCR_RFEN_SHIFT);
 
-    /* Check Tx/Rx interrupt flag and clear the interrupt */
-    if(flag_reg)
+    /* Time stamps of the flagged MBs are extended against this read, which also
+     * keeps the timer wrap count up to date */
+    now = FLEXCAN_DRV_ExtendTimer(state, base->TIMER);
+
+    /* Walk every pending flag, highest MB first */
+    while (flag_reg != 0U)
     {
-        if ((flag_reg & 0x20) && (BITBAND_ACCESS32(&(base->MCR), CAN_MCR_RFEN_SHIFT)))
+        mb_idx = 31U - FLEXCAN_CLZ(flag_reg);
+        temp = (1UL << mb_idx);
+        flag_reg &= ~temp;
+#if FLEXCAN_ISR_PROFILING
+        frames++;
+#endif
+
+        /* MB5..7 flags are the RX FIFO flags while the FIFO is enabled */
+        if (fifo_en && (mb_idx <= FSL_FEATURE_CAN_RXFIFO_OVERFLOW))
         {
-            if (state->fifo_message != NULL)
+            if (mb_idx == FSL_FEATURE_CAN_RXFIFO_FRAME_AVAILABLE)
+            {
+                if (state->isFifoContinuous)
+                {
+                    /* Every frame is popped by its own IFLAG5 write while draining,
+                     * the batched acknowledge must not pop one more */
+                    ack_mask &= ~temp;
+#if FLEXCAN_ISR_PROFILING
+                    frames += FLEXCAN_DRV_DrainRxFifo(base, state, now) - 1U;
+#else
+                    (void)FLEXCAN_DRV_DrainRxFifo(base, state, now);
+#endif
+                }
+                else if (state->fifo_message != NULL)
+                {
+                    /* Get RX FIFO field values */
+                    FLEXCAN_HAL_ReadRxFifo(base, state->fifo_message);
+                    /* Complete receive data */
+                    FLEXCAN_DRV_CompleteRxMessageFifoData(instance);
+                }
+                else
+                {
+                    /* No Action */
+                }
+            }
+            else if (mb_idx == FSL_FEATURE_CAN_RXFIFO_WARNING)
+            {
+                state->fifoStats.warningCount++;
+            }
+            else if (mb_idx == FSL_FEATURE_CAN_RXFIFO_OVERFLOW)
             {
-                /* Get RX FIFO field values */
-                FLEXCAN_HAL_ReadRxFifo(base, state->fifo_message);
-                /* Complete receive data */
-                FLEXCAN_DRV_CompleteRxMessageFifoData(instance);
-                FLEXCAN_HAL_ClearMsgBuffIntStatusFlag(base, flag_reg);
+                state->fifoStats.overflowCount++;
+            }
+            else
+            {
+                /* No Action */
             }
         }
-        else
+        /* Check mailbox completed reception */
+        else if (state->mbRxBusy & temp)
         {
-          /* Check mailbox completed reception */
-            temp = (1 << state->rx_mb_idx);
-            if ((temp & flag_reg) && state->isRxBusy)
+            rx_buff = state->mb_message[mb_idx];
+
+            if (rx_buff != NULL)
             {
-                /* Unlock RX message buffer and RX FIFO*/
-                FLEXCAN_HAL_LockRxMsgBuff(base, state->rx_mb_idx);
-                /* Get RX MB field values Arvind -> changed to get dlc also*/
-                /* commented by Arvind*/
-                FLEXCAN_HAL_GetMailBox(base, state->rx_mb_idx, \
-                                    state->mb_message, &mailBox_Buffer);
-                //FLEXCAN_HAL_GetMsgBuff(base, state->rx_mb_idx, state->mb_message);
-                /* Unlock RX message buffer and RX FIFO*/
+                /* Receive into the user buffer, completes the receive. Reading
+                 * the C/S word first locks the MB, its flag is cleared before
+                 * the unlock */
+                (void)FLEXCAN_HAL_GetMsgBuffFast(state->mbDesc[mb_idx].mb, rx_buff);
+                FLEXCAN_HAL_ClearMsgBuffIntStatusFlag(base, temp);
+                ack_mask &= ~temp;
                 FLEXCAN_HAL_UnlockRxMsgBuff(base);
 
-                /* Complete receive data */
-                FLEXCAN_DRV_CompleteRxMessageBufferData(instance);
-                FLEXCAN_HAL_ClearMsgBuffIntStatusFlag(base, temp & flag_reg);
-                
-                /* Define receive buffer */
-                flexcan_msgbuff_t recvBuff;
-                recvBuff.cs = 0;
-                recvBuff.msgId = mailBox_Buffer.mb_msgId;
-
-                /* Start receiving data in MB 1. */
-                FLEXCAN_DRV_RxMessageBuffer(X_FSL_CANCOM1, state->rx_mb_idx, &recvBuff);
-                   
-                 /* addded by Arvind*/
-                CallBack_fun.pEntry = CAN_RX_EventHandler;
-                CallBack_fun.pValue = &mailBox_Buffer;
-                
-                /* Commented by Arvind*/
-                /* Call function Rx/Tx Event handler */
-                CallBack_fun.pEntry(CallBack_fun.pValue);  
+                FLEXCAN_DRV_CompleteRxMessageBufferData(instance, mb_idx);
             }
-            
-            /* Check mailbox completed transmission */
-            temp = (1 << state->tx_mb_idx);
-            if ((temp & flag_reg) && state->isTxBusy)
+            else
             {
-                /* Complete transmit data */
-                FLEXCAN_DRV_CompleteSendData(instance);
-                FLEXCAN_HAL_ClearMsgBuffIntStatusFlag(base, temp & flag_reg);
-
-                /* Unlock RX message buffer and RX FIFO*/
-                FLEXCAN_HAL_LockRxMsgBuff(base, state->tx_mb_idx);
-                
-                /* Get RX MB field values Arvind -> changed to get dlc also*/
-                FLEXCAN_HAL_GetMailBox(base, state->tx_mb_idx, \
-                                        state->mb_message, &mailBox_Buffer);
-                
-                /* Unlock RX message buffer and RX FIFO*/
+                /* Persistent MB: reading the C/S word locks the MB, the copy into
+                 * the slot is the only copy of the frame */
+                rx_frame = FLEXCAN_DRV_StoreRxFrame(state, state->mbDesc[mb_idx].mb, mb_idx, now);
+                /* Clear the flag while the MB is still locked : a frame held in
+                 * the SMB moves in on the unlock and sets the flag again, it is
+                 * serviced by the next interrupt */
+                FLEXCAN_HAL_ClearMsgBuffIntStatusFlag(base, temp);
+                ack_mask &= ~temp;
+                /* Unlock RX message buffer through the free running timer. The MB
+                 * stays active and its interrupt enabled */
                 FLEXCAN_HAL_UnlockRxMsgBuff(base);
-                  
-                CallBack_fun.pEntry = CAN_TX_EventHandler;
-                CallBack_fun.pValue = &mailBox_Buffer;
-                
-                /* Commented by Arvind*/
-                /* Call function Rx/Tx Event handler */
-                CallBack_fun.pEntry(CallBack_fun.pValue);  
-                
+
+                if ((rx_frame != NULL) && (state->rxCallback != NULL))
+                {
+                    state->rxCallback(instance, rx_frame);
+                }
+            }
+        }
+        /* Check mailbox completed transmission */
+        else if (state->mbTxBusy & temp)
+        {
+            /* Acknowledge before the callback: a frame started from it through
+             * FLEXCAN_DRV_SendPayload() does not clear the flag itself */
+            FLEXCAN_HAL_ClearMsgBuffIntStatusFlag(base, temp);
+            ack_mask &= ~temp;
+
+            /* Complete transmit data */
+            FLEXCAN_DRV_CompleteSendData(instance, mb_idx);
+
+            /* Read back the transmitted MB (ID, abort status), the C/S word is
+             * read first and locks the MB, its flag is already cleared */
+            FLEXCAN_HAL_GetMailBoxFast(state->mbDesc[mb_idx].mb, mb_idx, &tx_buff, &tx_info);
+            FLEXCAN_HAL_UnlockRxMsgBuff(base);
+            tx_info.mb_timeStamp = FLEXCAN_EXTEND_STAMP(now, tx_info.mb_timeStamp);
+
+            if (state->txCallback != NULL)
+            {
+                state->txCallback(instance, &tx_info);
             }
         }
+        else
+        {
+            /* Flag of an MB nobody waits for, it is just acknowledged */
+        }
+    }
+
+    /* Acknowledge all other serviced flags with a single write. A Tx MB started
+     * from a callback must not lose its next completion. */
+    ack_mask &= ~(state->mbTxBusy);
+    if (ack_mask != 0U)
+    {
+        FLEXCAN_HAL_ClearMsgBuffIntStatusFlag(base, ack_mask);
     }
 
-    /* Clear all other interrupts in ERRSTAT register (Error, Busoff, Wakeup) */
-    FLEXCAN_HAL_ClearErrIntStatusFlag(base);
+    /* Account the errors and state changes flagged in ERRSTAT (Error, Busoff,
+     * Wakeup) and clear them */
+    FLEXCAN_DRV_UpdateErrorState(base, state, now);
+
+#if FLEXCAN_ISR_PROFILING
+    start_cycles = FLEXCAN_DWT_CYCCNT - start_cycles;
+    state->isrStats.isrEntries++;
+    state->isrStats.isrFrames += frames;
+    state->isrStats.isrCycles += start_cycles;
+    if (start_cycles > state->isrStats.isrMaxCycles)
+    {
+        state->isrStats.isrMaxCycles = start_cycles;
+    }
+#endif
      
     return;
 }
 
+#if FLEXCAN_ISR_PROFILING
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_GetIsrStats
+ * Description   : Copy out the message buffer ISR cycle statistics.
+ * The statistics are read with the interrupts disabled so that the snapshot
+ * is consistent, and can optionally be reset.
+ *
+ *END**************************************************************************/
+void FLEXCAN_DRV_GetIsrStats(uint8_t instance, flexcan_isr_stats_t *stats, bool clear)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    DEV_ASSERT(stats);
+#endif
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+
+    INT_SYS_DisableIRQGlobal();
+    *stats = state->isrStats;
+    if (clear)
+    {
+        state->isrStats.isrEntries = 0U;
+        state->isrStats.isrFrames = 0U;
+        state->isrStats.isrCycles = 0U;
+        state->isrStats.isrMaxCycles = 0U;
+    }
+    INT_SYS_EnableIRQGlobal();
+}
+#endif
+
 /*FUNCTION**********************************************************************
  *
  * Function Name : FLEXCAN_DRV_GetTransmitStatus
- * Description   : This function returns whether the previous FLEXCAN receive is
- *                 completed.
- * When performing a non-blocking receive, the user can call this function to
- * ascertain the state of the current receive progress: in progress (or busy)
+ * Description   : This function returns whether the previous FLEXCAN transmit
+ *                 on a message buffer is completed.
+ * When performing a non-blocking transmit, the user can call this function to
+ * ascertain the state of the current transmit progress: in progress (or busy)
  * or complete (success).
  *
  *END**************************************************************************/
-flexcan_status_t FLEXCAN_DRV_GetTransmitStatus(uint32_t instance)
+flexcan_status_t FLEXCAN_DRV_GetTransmitStatus(uint32_t instance, uint32_t mb_idx)
 {
 #ifdef DEV_ERROR_DETECT
     DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    DEV_ASSERT(mb_idx < FLEXCAN_MAX_MB_NUM);
 #endif
     flexcan_state_t * state = g_flexcanStatePtr[instance];
 
-    return (state->isTxBusy ? FLEXCAN_STATUS_TX_BUSY : FLEXCAN_STATUS_SUCCESS);
+    return ((state->mbTxBusy & (1UL << mb_idx)) ? FLEXCAN_STATUS_TX_BUSY : FLEXCAN_STATUS_SUCCESS);
 }
 
 /*FUNCTION**********************************************************************
  *
  * Function Name : FLEXCAN_DRV_GetReceiveStatus
- * Description   : This function returns whether the previous FLEXCAN receive is
- *                 completed.
+ * Description   : This function returns whether the previous FLEXCAN receive
+ *                 on a message buffer is completed.
  * When performing a non-blocking receive, the user can call this function to
  * ascertain the state of the current receive progress: in progress (or busy)
  * or complete (success).
  *
  *END**************************************************************************/
-flexcan_status_t FLEXCAN_DRV_GetReceiveStatus(uint32_t instance)
+flexcan_status_t FLEXCAN_DRV_GetReceiveStatus(uint32_t instance, uint32_t mb_idx)
 {
 #ifdef DEV_ERROR_DETECT
     DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    DEV_ASSERT(mb_idx < FLEXCAN_MAX_MB_NUM);
 #endif
     flexcan_state_t * state = g_flexcanStatePtr[instance];
 
-    return (state->isRxBusy ? FLEXCAN_STATUS_RX_BUSY : FLEXCAN_STATUS_SUCCESS);
+    return ((state->mbRxBusy & (1UL << mb_idx)) ? FLEXCAN_STATUS_RX_BUSY : FLEXCAN_STATUS_SUCCESS);
 }
 
 /*FUNCTION**********************************************************************
@@ -900,51 +1482,54 @@ flexcan_status_t FLEXCAN_DRV_GetReceiveStatus(uint32_t instance)
  * Description   : This function ends a non-blocking FLEXCAN transmission early.
  * During a non-blocking FLEXCAN transmission, the user has the option to terminate
  * the transmission early if the transmission is still in progress.
+ * The ABORT code is written into the MB and the MB stays busy until the module
+ * resolves the request; the MB interrupt then completes the transmission and
+ * the Tx callback reports mb_aborted. A frame already on the bus is not
+ * interrupted, it completes and is confirmed normally.
  *
  *END**************************************************************************/
-flexcan_status_t FLEXCAN_DRV_AbortSendingData(uint32_t instance)
+flexcan_status_t FLEXCAN_DRV_AbortSendingData(uint32_t instance, uint32_t mb_idx)
 {
 #ifdef DEV_ERROR_DETECT
     DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    DEV_ASSERT(mb_idx < FLEXCAN_MAX_MB_NUM);
 #endif
     flexcan_state_t * state = g_flexcanStatePtr[instance];
 
     /* Check if a transfer is running. */
-    if (!state->isTxBusy)
+    if (!(state->mbTxBusy & (1UL << mb_idx)))
     {
         return FLEXCAN_STATUS_NO_TRANSMIT_IN_PROGRESS;
     }
 
-    /* Stop the running transfer. */
-    FLEXCAN_DRV_CompleteSendData(instance);
-
-    return FLEXCAN_STATUS_SUCCESS;
+    /* Request the abort, the completion comes through the MB interrupt */
+    return FLEXCAN_HAL_AbortTxMsgBuff(g_flexcanBase[instance], mb_idx);
 }
 
 /*FUNCTION**********************************************************************
  *
  * Function Name : FLEXCAN_DRV_AbortReceivingData
- * Description   : This function shuts down the FLEXCAN by disabling interrupts and
- *                 the transmitter/receiver.
- * This function disables the FLEXCAN interrupts, disables the transmitter and
- * receiver.
+ * Description   : This function ends a non-blocking FLEXCAN receive early.
+ * This function disables the message buffer interrupt and releases the MB
+ * from the driver state.
  *
  *END**************************************************************************/
-flexcan_status_t FLEXCAN_DRV_AbortReceivingData(uint32_t instance)
+flexcan_status_t FLEXCAN_DRV_AbortReceivingData(uint32_t instance, uint32_t mb_idx)
 {
 #ifdef DEV_ERROR_DETECT
     DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    DEV_ASSERT(mb_idx < FLEXCAN_MAX_MB_NUM);
 #endif
     flexcan_state_t * state = g_flexcanStatePtr[instance];
 
     /* Check if a transfer is running. */
-    if (!state->isRxBusy)
+    if (!(state->mbRxBusy & (1UL << mb_idx)))
     {
         return FLEXCAN_STATUS_NO_RECEIVE_IN_PROGRESS;
     }
 
     /* Stop the running transfer. */
-    FLEXCAN_DRV_CompleteRxMessageBufferData(instance);
+    FLEXCAN_DRV_CompleteRxMessageBufferData(instance, mb_idx);
 
     return FLEXCAN_STATUS_SUCCESS;
 }
@@ -955,6 +1540,8 @@ flexcan_status_t FLEXCAN_DRV_AbortReceivingData(uint32_t instance)
  * Function Name : FLEXCAN_DRV_StartSendData
  * Description   : Initiate (start) a transmit by beginning the process of
  * sending data.
+ * MBs already validated by FLEXCAN_DRV_ConfigTxMb or an earlier send are
+ * written through their descriptor, others through FLEXCAN_HAL_SetTxMsgBuff.
  * This is not a public API as it is called from other driver functions.
  *
  *END**************************************************************************/
@@ -966,18 +1553,58 @@ static flexcan_status_t FLEXCAN_DRV_StartSendData(
                     uint8_t *mb_data
                     )
 {
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(mb_idx < FLEXCAN_MAX_MB_NUM);
+#endif
     flexcan_status_t result;
     flexcan_msgbuff_code_status_t cs;
+    uint32_t mb_cs;
+    uint32_t mb_id;
     flexcan_state_t * state = g_flexcanStatePtr[instance];
     CAN_Type * base = g_flexcanBase[instance];
+    flexcan_mb_desc_t * desc = &state->mbDesc[mb_idx];
 
-    if (state->isTxBusy)
+    /* The ISR updates the bitmap as well */
+    INT_SYS_DisableIRQGlobal();
+    if (state->mbTxBusy & (1UL << mb_idx))
     {
+        INT_SYS_EnableIRQGlobal();
         return FLEXCAN_STATUS_TX_BUSY;
     }
-    state->isTxBusy = true;
+    state->mbTxBusy |= (1UL << mb_idx);
+    state->mbTxDir |= (1UL << mb_idx);
+    INT_SYS_EnableIRQGlobal();
+
+    /* Drop a stale completion flag so the ISR only sees this transmission */
+    FLEXCAN_HAL_ClearMsgBuffIntStatusFlag(base, (1UL << mb_idx));
+
+    /* Validated Tx MB and a frame that fits it: the C/S and ID words are built
+     * here, without reading any FlexCAN register */
+    if ((desc->direction == (uint8_t)FLEXCAN_MB_DIR_TX) &&
+        (tx_info->data_length <= desc->payloadSize) &&
+        ((tx_info->fd_enable == 1U) || (tx_info->data_length <= 8U)))
+    {
+        /* The format is kept for the payload only sends of the next frames */
+        desc->txCs = FLEXCAN_DRV_TxFormatCs(tx_info);
+        desc->txPadding = tx_info->fd_padding;
+        mb_cs = ((uint32_t)FLEXCAN_TX_DATA << CAN_CS_CODE_SHIFT) |
+                ((uint32_t)FLEXCAN_HAL_PayloadSizeToDlc(tx_info->data_length) << CAN_CS_DLC_SHIFT) |
+                desc->txCs;
+
+        if (tx_info->msg_id_type == FLEXCAN_MSG_ID_EXT)
+        {
+            mb_id = msg_id & (CAN_ID_STD_MASK | CAN_ID_EXT_MASK);
+        }
+        else
+        {
+            mb_id = (msg_id << CAN_ID_STD_SHIFT) & CAN_ID_STD_MASK;
+        }
+
+        FLEXCAN_HAL_SetTxMsgBuffFast(desc->mb, mb_cs, mb_id, mb_data,
+                                     tx_info->data_length, tx_info->fd_padding);
+        return FLEXCAN_STATUS_SUCCESS;
+    }
 
-    state->tx_mb_idx = mb_idx;
     cs.dataLen = tx_info->data_length;
     cs.msgIdType = tx_info->msg_id_type;
     
@@ -986,6 +1613,17 @@ static flexcan_status_t FLEXCAN_DRV_StartSendData(
     cs.enable_brs = tx_info->enable_brs;
     cs.code = FLEXCAN_TX_DATA;
     result = FLEXCAN_HAL_SetTxMsgBuff(base, mb_idx, &cs, msg_id, mb_data);
+    if (result)
+    {
+        state->mbTxBusy &= ~(1UL << mb_idx);
+    }
+    else
+    {
+        /* Later frames of this MB take the fast path */
+        desc->direction = (uint8_t)FLEXCAN_MB_DIR_TX;
+        desc->txCs = FLEXCAN_DRV_TxFormatCs(tx_info);
+        desc->txPadding = tx_info->fd_padding;
+    }
     return result;
 }
 
@@ -1003,24 +1641,29 @@ static flexcan_status_t FLEXCAN_DRV_StartRxMessageBufferData(
                     flexcan_msgbuff_t *data
                     )
 {
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(mb_idx < FLEXCAN_MAX_MB_NUM);
+#endif
     flexcan_status_t result = FLEXCAN_STATUS_SUCCESS;
     CAN_Type * base = g_flexcanBase[instance];
     flexcan_state_t * state = g_flexcanStatePtr[instance];
 
     /* Start receiving mailbox */
-    if(state->isRxBusy)
+    INT_SYS_DisableIRQGlobal();
+    if (state->mbRxBusy & (1UL << mb_idx))
     {
+        INT_SYS_EnableIRQGlobal();
         return FLEXCAN_STATUS_RX_BUSY;
     }
-    state->isRxBusy = true;
-    state->mb_message = data;
+    state->mbRxBusy |= (1UL << mb_idx);
+    state->mbTxDir &= ~(1UL << mb_idx);
+    INT_SYS_EnableIRQGlobal();
+    state->mb_message[mb_idx] = data;
 
     if (!state->isRxBlocking)
     {
         /* Enable MB interrupt*/
         result = FLEXCAN_HAL_SetMsgBuffIntCmd(base, mb_idx, true);
-        /* Enable error interrupts */
-        FLEXCAN_HAL_SetErrIntCmd(base,FLEXCAN_INT_ERR,true);
     }
 
     return result;
@@ -1044,11 +1687,11 @@ flexcan_status_t FLEXCAN_DRV_StartRxMessageFifoData(
     flexcan_state_t * state = g_flexcanStatePtr[instance];
 
     /* Start receiving fifo */
-    if(state->isRxBusy)
+    if(state->isFifoBusy)
     {
         return FLEXCAN_STATUS_RX_BUSY;
     }
-    state->isRxBusy = true;
+    state->isFifoBusy = true;
 
     /* This will get filled by the interrupt handler */
     state->fifo_message = data;
@@ -1059,14 +1702,951 @@ flexcan_status_t FLEXCAN_DRV_StartRxMessageFifoData(
         FLEXCAN_HAL_SetMsgBuffIntCmd(base, FSL_FEATURE_CAN_RXFIFO_FRAME_AVAILABLE, true);
         FLEXCAN_HAL_SetMsgBuffIntCmd(base, FSL_FEATURE_CAN_RXFIFO_WARNING, true);
         FLEXCAN_HAL_SetMsgBuffIntCmd(base, FSL_FEATURE_CAN_RXFIFO_OVERFLOW, true);
-        
-        /* Enable error interrupts */
-        FLEXCAN_HAL_SetErrIntCmd(base,FLEXCAN_INT_ERR,true);
     }
 
     return FLEXCAN_STATUS_SUCCESS;
 }
 
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_StartRxFifoContinuous
+ * Description   : Start the continuous RX FIFO receive.
+ * This function enables the RX FIFO interrupts, which stay enabled until
+ * FLEXCAN_DRV_CompleteRxMessageFifoData is called. Received frames are
+ * reported through the Rx callback.
+ *
+ *END**************************************************************************/
+flexcan_status_t FLEXCAN_DRV_StartRxFifoContinuous(uint8_t instance)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+#endif
+    CAN_Type * base = g_flexcanBase[instance];
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+
+    if (!BITBAND_ACCESS32(&(base->MCR), CAN_MCR_RFEN_SHIFT))
+    {
+        return FLEXCAN_STATUS_FAIL;
+    }
+    if (state->isFifoBusy)
+    {
+        return FLEXCAN_STATUS_RX_BUSY;
+    }
+    state->isFifoBusy = true;
+    state->isFifoContinuous = true;
+    state->fifo_message = NULL;
+
+    /* Enable RX FIFO interrupts*/
+    FLEXCAN_HAL_SetMsgBuffIntCmd(base, FSL_FEATURE_CAN_RXFIFO_FRAME_AVAILABLE, true);
+    FLEXCAN_HAL_SetMsgBuffIntCmd(base, FSL_FEATURE_CAN_RXFIFO_WARNING, true);
+    FLEXCAN_HAL_SetMsgBuffIntCmd(base, FSL_FEATURE_CAN_RXFIFO_OVERFLOW, true);
+
+    return FLEXCAN_STATUS_SUCCESS;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_StartRxFifoDma
+ * Description   : Start the RX FIFO DMA receive.
+ * This function sets up an eDMA loop transfer triggered by the FlexCAN RX FIFO
+ * DMA request. Each request moves the 16 bytes of the FIFO output (C/S, ID,
+ * DATA) into the next slot of the frame ring; the source address wraps on the
+ * FIFO output through the 16 byte source modulo and the destination address
+ * goes back to the start of the ring at the end of the major loop. The eDMA
+ * interrupts on half and full major loop.
+ *
+ *END**************************************************************************/
+flexcan_status_t FLEXCAN_DRV_StartRxFifoDma(
+    uint8_t instance,
+    edma_chn_state_t *dmaChn,
+    uint8_t dmaChannel,
+    flexcan_dma_frame_t *ring,
+    uint32_t frameCount,
+    flexcan_dma_rx_callback_t callback)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    DEV_ASSERT(dmaChn);
+    DEV_ASSERT(ring);
+#endif
+    edma_transfer_config_t config = {0};
+    edma_loop_transfer_config_t loopConfig = {0};
+    CAN_Type * base = g_flexcanBase[instance];
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+
+    if (!BITBAND_ACCESS32(&(base->MCR), CAN_MCR_RFEN_SHIFT))
+    {
+        return FLEXCAN_STATUS_FAIL;
+    }
+    /* Half-full interrupt needs an even count, CITER is 15 bits wide */
+    if ((frameCount < 2U) || ((frameCount & 1U) != 0U) || (frameCount > 0x7FFEU))
+    {
+        return FLEXCAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (state->isFifoBusy)
+    {
+        return FLEXCAN_STATUS_RX_BUSY;
+    }
+
+    if (EDMA_DRV_RequestChannel(dmaChannel,
+            (dma_request_source_t)((uint32_t)EDMA_REQ_FLEXCAN0 + instance), dmaChn) == EDMA_INVALID_CHANNEL)
+    {
+        return FLEXCAN_STATUS_FAIL;
+    }
+
+    state->isFifoBusy = true;
+    state->fifo_message = NULL;
+    state->rxDmaChn = dmaChn;
+    state->rxDmaRing = ring;
+    state->rxDmaRingSize = frameCount;
+    state->rxDmaLaps = 0U;
+    state->rxDmaCallback = callback;
+
+    config.srcAddr = (uint32_t)&(base->RAMn[0]);
+    config.destAddr = (uint32_t)ring;
+    config.srcTransferSize = EDMA_TRANSFER_SIZE_4B;
+    config.destTransferSize = EDMA_TRANSFER_SIZE_4B;
+    config.srcOffset = 4;
+    config.destOffset = 4;
+    config.srcLastAddrAdjust = 0;
+    config.destLastAddrAdjust = -(int32_t)(frameCount * sizeof(flexcan_dma_frame_t));
+    config.srcModulo = EDMA_MODULO_16B;
+    config.destModulo = EDMA_MODULO_OFF;
+    config.minorByteTransferCount = sizeof(flexcan_dma_frame_t);
+    config.scatterGatherEnable = false;
+    config.interruptEnable = true;
+    config.loopTransferConfig = &loopConfig;
+    loopConfig.majorLoopIterationCount = frameCount;
+
+    EDMA_DRV_InstallCallback(dmaChn, FLEXCAN_DRV_RxFifoDmaCallback, state);
+    if (EDMA_DRV_ConfigLoopTransfer(dmaChn, &config) != EDMA_STATUS_SUCCESS)
+    {
+        FLEXCAN_DRV_StopRxFifoDma(instance);
+        return FLEXCAN_STATUS_FAIL;
+    }
+    EDMA_HAL_TCDSetHalfCompleteIntCmd(g_edmaBase[0U], dmaChn->channel, true);
+
+    /* The frame available flag now requests the DMA instead of the interrupt */
+    FLEXCAN_HAL_SetMsgBuffIntCmd(base, FSL_FEATURE_CAN_RXFIFO_FRAME_AVAILABLE, false);
+    FLEXCAN_HAL_SetRxFifoDMA(base, true);
+
+    EDMA_DRV_StartChannel(dmaChn);
+
+    return FLEXCAN_STATUS_SUCCESS;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_StopRxFifoDma
+ * Description   : Stop the RX FIFO DMA receive.
+ * This function stops and releases the eDMA channel and gives the RX FIFO
+ * frame available flag back to the interrupt.
+ *
+ *END**************************************************************************/
+void FLEXCAN_DRV_StopRxFifoDma(uint8_t instance)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+#endif
+    CAN_Type * base = g_flexcanBase[instance];
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+
+    if (state->rxDmaChn == NULL)
+    {
+        return;
+    }
+
+    FLEXCAN_HAL_SetRxFifoDMA(base, false);
+    EDMA_DRV_StopChannel(state->rxDmaChn);
+    EDMA_DRV_ReleaseChannel(state->rxDmaChn);
+
+    state->rxDmaChn = NULL;
+    state->rxDmaCallback = NULL;
+    state->isFifoBusy = false;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_GetRxFifoDmaIndex
+ * Description   : Return the producer index of the RX FIFO DMA frame ring.
+ * The index is derived from the current major loop count of the channel:
+ * the DMA has written (BITER - CITER) frames in the current lap.
+ *
+ *END**************************************************************************/
+uint32_t FLEXCAN_DRV_GetRxFifoDmaIndex(uint8_t instance, uint32_t *laps)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+#endif
+    uint32_t citer;
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+
+    if (state->rxDmaChn == NULL)
+    {
+        return 0U;
+    }
+
+    citer = EDMA_HAL_TCDGetCurrentMajorCount(g_edmaBase[0U], state->rxDmaChn->channel);
+    if (laps != NULL)
+    {
+        *laps = state->rxDmaLaps;
+    }
+
+    return ((state->rxDmaRingSize - citer) % state->rxDmaRingSize);
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_DecodeDmaFrame
+ * Description   : Convert a frame of the RX FIFO DMA ring.
+ * This function extracts the identifier and puts the payload bytes in order.
+ *
+ *END**************************************************************************/
+void FLEXCAN_DRV_DecodeDmaFrame(const flexcan_dma_frame_t *frame, flexcan_msgbuff_t *msgBuff)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(frame);
+    DEV_ASSERT(msgBuff);
+#endif
+    uint32_t i;
+    uint32_t word;
+
+    msgBuff->cs = frame->cs;
+    if ((frame->cs) & CAN_CS_IDE_MASK)
+    {
+        msgBuff->msgId = frame->id;
+    }
+    else
+    {
+        msgBuff->msgId = (frame->id) >> CAN_ID_STD_SHIFT;
+    }
+
+    for (i = 0U; i < 2U; i++)
+    {
+        word = frame->data[i];
+        msgBuff->data[(i * 4U)]      = (uint8_t)(word >> 24U);
+        msgBuff->data[(i * 4U) + 1U] = (uint8_t)(word >> 16U);
+        msgBuff->data[(i * 4U) + 2U] = (uint8_t)(word >> 8U);
+        msgBuff->data[(i * 4U) + 3U] = (uint8_t)(word);
+    }
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_RxFifoDmaCallback
+ * Description   : eDMA callback of the RX FIFO DMA mode.
+ * Called on half and full major loop: counts the ring wrap-arounds and
+ * notifies the user with the producer index.
+ * This is not a public API as it is called from the eDMA driver.
+ *
+ *END**************************************************************************/
+static void FLEXCAN_DRV_RxFifoDmaCallback(void *parameter, edma_chn_status_t status)
+{
+    flexcan_state_t * state = (flexcan_state_t *)parameter;
+    uint32_t producerIdx;
+
+    (void)status;
+
+    producerIdx = FLEXCAN_DRV_GetRxFifoDmaIndex(state->instance, NULL);
+    /* At the end of the major loop CITER is reloaded, the index is back at 0 */
+    if (producerIdx < (state->rxDmaRingSize / 2U))
+    {
+        state->rxDmaLaps++;
+    }
+
+    if (state->rxDmaCallback != NULL)
+    {
+        state->rxDmaCallback(state->instance, producerIdx);
+    }
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_StoreRxFrame
+ * Description   : Copy a received frame into the next free frame slot.
+ * The message buffer is read word by word: C/S, ID, then only the payload
+ * words covered by the DLC, swapped into byte order. The slot is published
+ * to the consumer after it is completely written. Returns NULL and counts an
+ * overflow if every slot is still held by the consumer (the C/S word is read
+ * anyway so that the MB gets locked and unlocked as usual). The 16-bit time
+ * stamp is extended against now, the extended timer read at ISR entry.
+ * This is not a public API as it is called from the ISR.
+ *
+ *END**************************************************************************/
+static const flexcan_rx_frame_t * FLEXCAN_DRV_StoreRxFrame(
+                    flexcan_state_t * state,
+                    volatile const uint32_t *flexcan_mb,
+                    uint32_t mb_idx,
+                    uint32_t now)
+{
+    uint32_t head = state->rxFrameHead;
+    uint32_t fill = head - state->rxFrameTail;
+    uint32_t cs = flexcan_mb[0];
+    uint32_t id = flexcan_mb[1];
+    uint32_t words;
+    uint32_t i;
+    flexcan_rx_frame_t *frame;
+
+    if (fill >= FLEXCAN_RX_FRAME_NUM)
+    {
+        state->rxFrameStats.overflowCount++;
+        return NULL;
+    }
+
+    frame = &state->rxFrames[head & (FLEXCAN_RX_FRAME_NUM - 1U)];
+    frame->cs = cs;
+    frame->msgId = (cs & CAN_CS_IDE_MASK) ? id : (id >> CAN_ID_STD_SHIFT);
+    frame->mbIdx = (uint8_t)mb_idx;
+    frame->length = FLEXCAN_HAL_DlcToPayloadSize(cs >> CAN_CS_DLC_SHIFT);
+    frame->timeStamp = FLEXCAN_EXTEND_STAMP(now, cs & CAN_CS_TIME_STAMP_MASK);
+    if (frame->length > FLEXCAN_RX_FRAME_PAYLOAD)
+    {
+        frame->length = FLEXCAN_RX_FRAME_PAYLOAD;
+    }
+
+    words = ((uint32_t)frame->length + 3U) >> 2U;
+    for (i = 0U; i < words; i++)
+    {
+        frame->data[i] = FLEXCAN_REV(flexcan_mb[2U + i]);
+    }
+
+    /* Publish the slot only after it is completely written */
+    FLEXCAN_DMB();
+    state->rxFrameHead = head + 1U;
+
+    if ((fill + 1U) > state->rxFrameStats.highWater)
+    {
+        state->rxFrameStats.highWater = fill + 1U;
+    }
+
+    return frame;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_PeekRxFrame
+ * Description   : Return the oldest received frame not released yet.
+ *
+ *END**************************************************************************/
+const flexcan_rx_frame_t * FLEXCAN_DRV_PeekRxFrame(uint8_t instance)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+#endif
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+    uint32_t tail = state->rxFrameTail;
+
+    if (tail == state->rxFrameHead)
+    {
+        return NULL;
+    }
+
+    /* Read the slot only after the index that published it */
+    FLEXCAN_DMB();
+
+    return &state->rxFrames[tail & (FLEXCAN_RX_FRAME_NUM - 1U)];
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_ReleaseRxFrame
+ * Description   : Hand the oldest received frame slot back to the ISR.
+ *
+ *END**************************************************************************/
+void FLEXCAN_DRV_ReleaseRxFrame(uint8_t instance)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+#endif
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+    uint32_t tail = state->rxFrameTail;
+
+    if (tail != state->rxFrameHead)
+    {
+        /* The consumer is done with the slot before the ISR may reuse it */
+        FLEXCAN_DMB();
+        state->rxFrameTail = tail + 1U;
+    }
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_GetRxFrameStats
+ * Description   : Copy out the received frame slot statistics.
+ *
+ *END**************************************************************************/
+void FLEXCAN_DRV_GetRxFrameStats(uint8_t instance, flexcan_rx_frame_stats_t *stats, bool clear)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    DEV_ASSERT(stats);
+#endif
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+
+    INT_SYS_DisableIRQGlobal();
+    *stats = state->rxFrameStats;
+    if (clear)
+    {
+        state->rxFrameStats.highWater = 0U;
+        state->rxFrameStats.overflowCount = 0U;
+    }
+    INT_SYS_EnableIRQGlobal();
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_GetRxFifoStats
+ * Description   : Copy out the RX FIFO frame, warning and overflow counters.
+ *
+ *END**************************************************************************/
+void FLEXCAN_DRV_GetRxFifoStats(uint8_t instance, flexcan_rx_fifo_stats_t *stats, bool clear)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    DEV_ASSERT(stats);
+#endif
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+
+    INT_SYS_DisableIRQGlobal();
+    *stats = state->fifoStats;
+    if (clear)
+    {
+        state->fifoStats.frameCount = 0U;
+        state->fifoStats.warningCount = 0U;
+        state->fifoStats.overflowCount = 0U;
+    }
+    INT_SYS_EnableIRQGlobal();
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_GetTime
+ * Description   : Return the free running timer extended to 32 bits.
+ * The wrap count is only updated on reads, so this must be called at least
+ * once per timer period (65536 bit times) while the bus is quiet.
+ *
+ *END**************************************************************************/
+uint32_t FLEXCAN_DRV_GetTime(uint8_t instance)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+#endif
+
+    uint32_t now;
+    CAN_Type * base = g_flexcanBase[instance];
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+
+    INT_SYS_DisableIRQGlobal();
+    now = FLEXCAN_DRV_ExtendTimer(state, base->TIMER);
+    INT_SYS_EnableIRQGlobal();
+
+    return now;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_InstallErrorCallback
+ * Description   : Install the callback reporting the fault confinement changes.
+ *
+ *END**************************************************************************/
+void FLEXCAN_DRV_InstallErrorCallback(uint8_t instance, FlexCAN_ERROR_CALLBACK callback)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+#endif
+
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(state != NULL);
+#endif
+    state->errorCallback = callback;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_GetErrorStats
+ * Description   : Copy out the bus error statistics.
+ * The error counters and fault confinement state are refreshed first, the
+ * return from error passive to error active raising no interrupt.
+ *
+ *END**************************************************************************/
+void FLEXCAN_DRV_GetErrorStats(uint8_t instance, flexcan_error_stats_t *stats, bool clear)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    DEV_ASSERT(stats);
+#endif
+    CAN_Type * base = g_flexcanBase[instance];
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+
+    INT_SYS_DisableIRQGlobal();
+    FLEXCAN_DRV_UpdateErrorState(base, state, FLEXCAN_DRV_ExtendTimer(state, base->TIMER));
+    *stats = state->errorStats;
+    if (clear)
+    {
+        FLEXCAN_DRV_ResetErrorStats(&state->errorStats, false);
+    }
+    INT_SYS_EnableIRQGlobal();
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_SetBusOffRecovery
+ * Description   : Select the automatic or the manual recovery from bus off.
+ * Switching to automatic releases a node held in bus off.
+ *
+ *END**************************************************************************/
+void FLEXCAN_DRV_SetBusOffRecovery(uint8_t instance, flexcan_busoff_recovery_t mode)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+#endif
+
+    CAN_Type * base = g_flexcanBase[instance];
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+
+    INT_SYS_DisableIRQGlobal();
+    state->busOffRecovery = mode;
+    FLEXCAN_HAL_SetBusOffRecoveryCmd(base, (mode == FLEXCAN_BUSOFF_RECOVERY_AUTO));
+    INT_SYS_EnableIRQGlobal();
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_RecoverBusOff
+ * Description   : Release a node held in bus off.
+ * The state is refreshed right after the release, so that a node leaving bus
+ * off at once (recovery sequence already done) is reported back to error
+ * active and held again for its next bus off.
+ *
+ *END**************************************************************************/
+flexcan_status_t FLEXCAN_DRV_RecoverBusOff(uint8_t instance)
+{
+#ifdef DEV_ERROR_DETECT
+    DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+#endif
+
+    flexcan_status_t result = FLEXCAN_STATUS_FAIL;
+    CAN_Type * base = g_flexcanBase[instance];
+    flexcan_state_t * state = g_flexcanStatePtr[instance];
+
+    INT_SYS_DisableIRQGlobal();
+    FLEXCAN_DRV_UpdateErrorState(base, state, FLEXCAN_DRV_ExtendTimer(state, base->TIMER));
+    if (state->errorStats.faultConf == (uint8_t)FLEXCAN_FAULT_BUS_OFF)
+    {
+        FLEXCAN_HAL_SetBusOffRecoveryCmd(base, true);
+        FLEXCAN_DRV_UpdateErrorState(base, state, FLEXCAN_DRV_ExtendTimer(state, base->TIMER));
+        result = FLEXCAN_STATUS_SUCCESS;
+    }
+    INT_SYS_EnableIRQGlobal();
+
+    return result;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_ExtendTimer
+ * Description   : Extend a TIMER register read to 32 bits.
+ * A read lower than the previous one means the 16-bit timer wrapped in
+ * between. Reading TIMER also releases a locked MB, so callers must not hold
+ * one. This is not a public API as it is called from the ISR.
+ *
+ *END**************************************************************************/
+static uint32_t FLEXCAN_DRV_ExtendTimer(flexcan_state_t * state, uint32_t timer)
+{
+    uint16_t timer16 = (uint16_t)timer;
+
+    if (timer16 < state->timerLast)
+    {
+        state->timerHigh += 0x10000U;
+    }
+    state->timerLast = timer16;
+
+    return state->timerHigh | timer16;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_UpdateErrorState
+ * Description   : Account the ESR1 error bits and fault confinement changes.
+ * ESR1 is read once: the read clears the latched error bits, only the
+ * interrupt flags seen in that read are written back, so nothing raised in
+ * between is lost. In manual recovery mode the bus off hold is armed again
+ * when the node enters bus off and when it is back to error active.
+ * This is not a public API as it is called from the ISR and, with the
+ * interrupts disabled, from the error management functions.
+ *
+ *END**************************************************************************/
+static void FLEXCAN_DRV_UpdateErrorState(CAN_Type * base, flexcan_state_t * state, uint32_t now)
+{
+    flexcan_error_stats_t * stats = &state->errorStats;
+    flexcan_buserr_counter_t counter;
+    flexcan_fault_conf_t faultConf;
+    uint32_t esr1 = FLEXCAN_HAL_GetErrStatus(base);
+
+    FLEXCAN_HAL_ClearErrStatusFlags(base, esr1 & FLEXCAN_ERR_INT_FLAGS);
+
+    if ((esr1 & (CAN_ESR1_ERRINT_MASK | CAN_ESR1_ERRINT_FAST_MASK)) != 0U)
+    {
+        stats->lastErrorTime = now;
+        if ((esr1 & (CAN_ESR1_BIT0ERR_MASK | CAN_ESR1_BIT0ERR_FAST_MASK)) != 0U)
+        {
+            stats->bit0ErrCount++;
+        }
+        if ((esr1 & (CAN_ESR1_BIT1ERR_MASK | CAN_ESR1_BIT1ERR_FAST_MASK)) != 0U)
+        {
+            stats->bit1ErrCount++;
+        }
+        if ((esr1 & (CAN_ESR1_STFERR_MASK | CAN_ESR1_STFERR_FAST_MASK)) != 0U)
+        {
+            stats->stuffErrCount++;
+        }
+        if ((esr1 & (CAN_ESR1_CRCERR_MASK | CAN_ESR1_CRCERR_FAST_MASK)) != 0U)
+        {
+            stats->crcErrCount++;
+        }
+        if ((esr1 & (CAN_ESR1_FRMERR_MASK | CAN_ESR1_FRMERR_FAST_MASK)) != 0U)
+        {
+            stats->formErrCount++;
+        }
+        if ((esr1 & CAN_ESR1_ACKERR_MASK) != 0U)
+        {
+            stats->ackErrCount++;
+        }
+        if ((esr1 & FLEXCAN_ERR_FAST_BITS) != 0U)
+        {
+            stats->fastErrCount++;
+        }
+        if ((esr1 & CAN_ESR1_ERROVR_MASK) != 0U)
+        {
+            stats->overrunCount++;
+        }
+    }
+
+    FLEXCAN_HAL_GetErrCounter(base, &counter);
+    stats->txErrCounter = (uint8_t)counter.txerr;
+    stats->rxErrCounter = (uint8_t)counter.rxerr;
+    if (stats->txErrCounter > stats->txErrPeak)
+    {
+        stats->txErrPeak = stats->txErrCounter;
+    }
+    if (stats->rxErrCounter > stats->rxErrPeak)
+    {
+        stats->rxErrPeak = stats->rxErrCounter;
+    }
+
+    /* FLTCONF: 00 error active, 01 error passive, 1x bus off */
+    switch ((esr1 & CAN_ESR1_FLTCONF_MASK) >> CAN_ESR1_FLTCONF_SHIFT)
+    {
+        case 0U:
+            faultConf = FLEXCAN_FAULT_ERROR_ACTIVE;
+            break;
+        case 1U:
+            faultConf = FLEXCAN_FAULT_ERROR_PASSIVE;
+            break;
+        default:
+            faultConf = FLEXCAN_FAULT_BUS_OFF;
+            break;
+    }
+
+    /* BOFFINT also catches a bus off the node already left before this read */
+    if (((esr1 & CAN_ESR1_BOFFINT_MASK) != 0U) ||
+        ((faultConf == FLEXCAN_FAULT_BUS_OFF) && (stats->faultConf != (uint8_t)FLEXCAN_FAULT_BUS_OFF)))
+    {
+        stats->busOffCount++;
+        stats->busOffTime = now;
+        stats->faultConf = (uint8_t)FLEXCAN_FAULT_BUS_OFF;
+        if (state->busOffRecovery == FLEXCAN_BUSOFF_RECOVERY_MANUAL)
+        {
+            /* Hold the node in bus off until FLEXCAN_DRV_RecoverBusOff() */
+            FLEXCAN_HAL_SetBusOffRecoveryCmd(base, false);
+        }
+        if (state->errorCallback != NULL)
+        {
+            state->errorCallback(state->instance, FLEXCAN_ERROR_EVENT_BUS_OFF, stats);
+        }
+    }
+
+    if ((esr1 & CAN_ESR1_BOFFDONEINT_MASK) != 0U)
+    {
+        stats->busOffDoneCount++;
+        stats->busOffDoneTime = now;
+        if (state->errorCallback != NULL)
+        {
+            state->errorCallback(state->instance, FLEXCAN_ERROR_EVENT_BUS_OFF_DONE, stats);
+        }
+    }
+
+    if (faultConf != (flexcan_fault_conf_t)stats->faultConf)
+    {
+        stats->faultConf = (uint8_t)faultConf;
+        if (faultConf == FLEXCAN_FAULT_ERROR_PASSIVE)
+        {
+            stats->errorPassiveCount++;
+            stats->errorPassiveTime = now;
+        }
+        else
+        {
+            /* Only left for error active, bus off was handled above */
+            stats->errorActiveTime = now;
+            if (state->busOffRecovery == FLEXCAN_BUSOFF_RECOVERY_MANUAL)
+            {
+                FLEXCAN_HAL_SetBusOffRecoveryCmd(base, false);
+            }
+        }
+        if (state->errorCallback != NULL)
+        {
+            state->errorCallback(state->instance,
+                                 (faultConf == FLEXCAN_FAULT_ERROR_PASSIVE) ?
+                                 FLEXCAN_ERROR_EVENT_PASSIVE : FLEXCAN_ERROR_EVENT_ACTIVE,
+                                 stats);
+        }
+    }
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_ResetErrorStats
+ * Description   : Reset the event counters and the error counter peaks.
+ * With all set, the times and the fault confinement state are reset too.
+ * This is not a public API as it is called from other driver functions.
+ *
+ *END**************************************************************************/
+static void FLEXCAN_DRV_ResetErrorStats(flexcan_error_stats_t * stats, bool all)
+{
+    stats->bit0ErrCount = 0U;
+    stats->bit1ErrCount = 0U;
+    stats->stuffErrCount = 0U;
+    stats->crcErrCount = 0U;
+    stats->formErrCount = 0U;
+    stats->ackErrCount = 0U;
+    stats->fastErrCount = 0U;
+    stats->overrunCount = 0U;
+    stats->errorPassiveCount = 0U;
+    stats->busOffCount = 0U;
+    stats->busOffDoneCount = 0U;
+    stats->txErrPeak = stats->txErrCounter;
+    stats->rxErrPeak = stats->rxErrCounter;
+    if (all)
+    {
+        stats->lastErrorTime = 0U;
+        stats->errorPassiveTime = 0U;
+        stats->errorActiveTime = 0U;
+        stats->busOffTime = 0U;
+        stats->busOffDoneTime = 0U;
+        stats->txErrCounter = 0U;
+        stats->rxErrCounter = 0U;
+        stats->txErrPeak = 0U;
+        stats->rxErrPeak = 0U;
+        stats->faultConf = (uint8_t)FLEXCAN_FAULT_ERROR_ACTIVE;
+    }
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_DrainRxFifo
+ * Description   : Read every frame queued in the RX FIFO.
+ * Each frame is copied out of the FIFO output, popped by writing IFLAG5 and
+ * then reported through the Rx callback. At most FLEXCAN_RXFIFO_DEPTH frames
+ * are read per call so that the ISR time stays bounded under full bus load.
+ * This is not a public API as it is called from the ISR.
+ *
+ *END**************************************************************************/
+static uint32_t FLEXCAN_DRV_DrainRxFifo(CAN_Type * base, flexcan_state_t * state, uint32_t now)
+{
+    uint32_t count = 0U;
+    const flexcan_rx_frame_t *rx_frame;
+
+    do
+    {
+        /* Copy the RX FIFO output (MB0 area) into a frame slot */
+        rx_frame = FLEXCAN_DRV_StoreRxFrame(state, &(base->RAMn[0]),
+                                            FSL_FEATURE_CAN_RXFIFO_FRAME_AVAILABLE, now);
+        /* Release the FIFO output so the next frame moves up */
+        FLEXCAN_HAL_ClearMsgBuffIntStatusFlag(base, (1UL << FSL_FEATURE_CAN_RXFIFO_FRAME_AVAILABLE));
+
+        if ((rx_frame != NULL) && (state->rxCallback != NULL))
+        {
+            state->rxCallback(state->instance, rx_frame);
+        }
+
+        count++;
+    } while ((count < FLEXCAN_RXFIFO_DEPTH) && \
+             (FLEXCAN_HAL_GetMsgBuffIntStatusFlag(base, FSL_FEATURE_CAN_RXFIFO_FRAME_AVAILABLE)));
+
+    state->fifoStats.frameCount += count;
+
+    return count;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_SolveBitTiming
+ * Description   : Solve one bit timing register set.
+ * For each prescaler the number of time quanta per bit is rounded to the
+ * requested bit rate, then split so that the sample point lands as close as
+ * possible to the requested one, phase segment 1 following phase segment 2 to
+ * leave room for the resync jump width. Returns false if no prescaler gives a
+ * valid split.
+ *
+ *END**************************************************************************/
+static bool FLEXCAN_DRV_SolveBitTiming(
+                    uint32_t peClock,
+                    uint32_t bitrate,
+                    uint32_t samplePoint,
+                    uint32_t sjw,
+                    const flexcan_bit_limits_t *limits,
+                    flexcan_bit_solution_t *solution)
+{
+    uint32_t maxTq = 1U + limits->maxProp + limits->maxPseg1 + limits->maxPseg2;
+    uint32_t bestError = 0xFFFFFFFFU;
+    uint32_t bestSpError = 0xFFFFFFFFU;
+    uint32_t presdiv, tq, tseg1, pseg1, pseg2, sp;
+    uint32_t spError, absError;
+    int32_t error;
+
+    if ((bitrate == 0U) || (samplePoint >= 1000U))
+    {
+        return false;
+    }
+
+    for (presdiv = 1U; (presdiv <= limits->maxPresdiv) && (presdiv <= (peClock / bitrate)); presdiv++)
+    {
+        tq = (peClock + ((presdiv * bitrate) / 2U)) / (presdiv * bitrate);
+        if (tq < limits->minTq)
+        {
+            break;
+        }
+        if (tq > maxTq)
+        {
+            continue;
+        }
+
+        /* Phase segment 2 from the sample point, within the field ranges */
+        pseg2 = tq - ((tq * samplePoint + 500U) / 1000U);
+        if (pseg2 < 2U)
+        {
+            pseg2 = 2U;
+        }
+        if ((pseg2 + limits->minProp + 2U) > tq)
+        {
+            continue;
+        }
+        if ((tq - 1U - pseg2) > (limits->maxProp + limits->maxPseg1))
+        {
+            pseg2 = tq - 1U - (limits->maxProp + limits->maxPseg1);
+        }
+        if (pseg2 > limits->maxPseg2)
+        {
+            continue;
+        }
+        tseg1 = tq - 1U - pseg2;
+        pseg1 = pseg2;
+        if (pseg1 > (tseg1 - limits->minProp))
+        {
+            pseg1 = tseg1 - limits->minProp;
+        }
+        if (pseg1 > limits->maxPseg1)
+        {
+            pseg1 = limits->maxPseg1;
+        }
+        if ((tseg1 - pseg1) > limits->maxProp)
+        {
+            pseg1 = tseg1 - limits->maxProp;
+        }
+
+        error = (int32_t)(((int64_t)peClock * 1000000) / ((int64_t)presdiv * tq * bitrate) - 1000000);
+        absError = (error < 0) ? (uint32_t)(-error) : (uint32_t)error;
+        sp = ((tq - pseg2) * 1000U) / tq;
+        spError = (sp > samplePoint) ? (sp - samplePoint) : (samplePoint - sp);
+        if ((absError < bestError) || ((absError == bestError) && (spError < bestSpError)))
+        {
+            bestError = absError;
+            bestSpError = spError;
+            solution->presdiv = presdiv;
+            solution->prop = tseg1 - pseg1;
+            solution->pseg1 = pseg1;
+            solution->pseg2 = pseg2;
+            solution->bitrate = peClock / (presdiv * tq);
+            solution->error = error;
+            solution->samplePoint = sp;
+        }
+    }
+
+    if (bestError == 0xFFFFFFFFU)
+    {
+        return false;
+    }
+
+    /* Resync jump width : at most both phase segments */
+    if ((sjw == 0U) || (sjw > limits->maxSjw))
+    {
+        sjw = limits->maxSjw;
+    }
+    if (sjw > solution->pseg1)
+    {
+        sjw = solution->pseg1;
+    }
+    if (sjw > solution->pseg2)
+    {
+        sjw = solution->pseg2;
+    }
+    solution->sjw = sjw;
+
+    return true;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_TdcOffset
+ * Description   : Transceiver delay compensation offset of a data phase bit
+ * timing: Sync + FPROPSEG + (FPSEG1 + 1) time quanta up to the sample point,
+ * in PE clock cycles.
+ *
+ *END**************************************************************************/
+static uint32_t FLEXCAN_DRV_TdcOffset(const flexcan_time_segment_cbt_t *bitrate)
+{
+    uint32_t tdc_offset;
+
+    tdc_offset = (bitrate->propSegFd + bitrate->phaseSeg1Fd + 2U) * (bitrate->preDividerFd + 1U);
+    if (tdc_offset > (CAN_FDCTRL_TDCOFF_MASK >> CAN_FDCTRL_TDCOFF_SHIFT))
+    {
+        tdc_offset = (CAN_FDCTRL_TDCOFF_MASK >> CAN_FDCTRL_TDCOFF_SHIFT);
+    }
+
+    return tdc_offset;
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_DRV_TxFormatCs
+ * Description   : Frame format bits of the C/S word of a Tx frame: IDE for an
+ * extended ID, EDL for an FD frame and BRS for an FD frame with bit rate
+ * switch. The code and DLC fields are left to the caller.
+ * This is not a public API as it is called from other driver functions.
+ *
+ *END**************************************************************************/
+static uint32_t FLEXCAN_DRV_TxFormatCs(const flexcan_data_info_t *tx_info)
+{
+    uint32_t cs = 0U;
+
+    if (tx_info->fd_enable == 1U)
+    {
+        cs |= CAN_MB_EDL_MASK;
+        if (tx_info->enable_brs == 1U)
+        {
+            cs |= CAN_MB_BRS_MASK;
+        }
+    }
+    if (tx_info->msg_id_type == FLEXCAN_MSG_ID_EXT)
+    {
+        cs |= CAN_CS_IDE_MASK;
+    }
+
+    return cs;
+}
+
 /*FUNCTION**********************************************************************
  *
  * Function Name : FLEXCAN_DRV_CompleteSendData
@@ -1075,22 +2655,24 @@ flexcan_status_t FLEXCAN_DRV_StartRxMessageFifoData(
  * This is not a public API as it is called from other driver functions.
  *
  *END**************************************************************************/
-void FLEXCAN_DRV_CompleteSendData(uint32_t instance)
+void FLEXCAN_DRV_CompleteSendData(uint32_t instance, uint32_t mb_idx)
 {
 #ifdef DEV_ERROR_DETECT
     DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    DEV_ASSERT(mb_idx < FLEXCAN_MAX_MB_NUM);
 #endif
     CAN_Type * base = g_flexcanBase[instance];
     flexcan_state_t * state = g_flexcanStatePtr[instance];
 
-    /* Disable the transmitter data register empty interrupt */
-    FLEXCAN_HAL_SetMsgBuffIntCmd(base, state->tx_mb_idx, false);
-    /* Disable error interrupts */
-    FLEXCAN_HAL_SetErrIntCmd(base,FLEXCAN_INT_ERR,false);
-
+    /* Disable the transmitter data register empty interrupt, validated Tx MBs
+     * keep it for their next frame */
+    if (state->mbDesc[mb_idx].direction != (uint8_t)FLEXCAN_MB_DIR_TX)
+    {
+        FLEXCAN_HAL_SetMsgBuffIntCmd(base, mb_idx, false);
+    }
 
     /* Update the information of the module driver state */
-    state->isTxBusy = false;
+    state->mbTxBusy &= ~(1UL << mb_idx);
 }
 
 /*FUNCTION**********************************************************************
@@ -1101,20 +2683,19 @@ void FLEXCAN_DRV_CompleteSendData(uint32_t instance)
  * This is not a public API as it is called from other driver functions.
  *
  *END**************************************************************************/
-void FLEXCAN_DRV_CompleteRxMessageBufferData(uint32_t instance)
+void FLEXCAN_DRV_CompleteRxMessageBufferData(uint32_t instance, uint32_t mb_idx)
 {
 #ifdef DEV_ERROR_DETECT
     DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+    DEV_ASSERT(mb_idx < FLEXCAN_MAX_MB_NUM);
 #endif
     CAN_Type * base = g_flexcanBase[instance];
     flexcan_state_t * state = g_flexcanStatePtr[instance];
 
-    FLEXCAN_HAL_SetMsgBuffIntCmd(base, state->rx_mb_idx, false);
-    /* Disable error interrupts */
-    FLEXCAN_HAL_SetErrIntCmd(base,FLEXCAN_INT_ERR,false);
+    FLEXCAN_HAL_SetMsgBuffIntCmd(base, mb_idx, false);
 
     /* Update the information of the module driver state */
-    state->isRxBusy = false;
+    state->mbRxBusy &= ~(1UL << mb_idx);
 }
 
 /*FUNCTION**********************************************************************
@@ -1139,29 +2720,39 @@ void FLEXCAN_DRV_CompleteRxMessageFifoData(uint32_t instance)
     {
         FLEXCAN_HAL_SetMsgBuffIntCmd(base, i, false);
     }
-    /* Disable error interrupts */
-    FLEXCAN_HAL_SetErrIntCmd(base,FLEXCAN_INT_ERR,false);
 
     /* Clear fifo message*/
     state->fifo_message = NULL;
 
     /* Update status for receive by using fifo*/
-    state->isRxBusy = false;
+    state->isFifoBusy = false;
+    state->isFifoContinuous = false;
 }
 
 /** Arvind Added */
 
-/** @fn void CAN_Mgr_Init(FlexCAN_TRCV_CALLBACK tx_Handler,FlexCAN_TRCV_CALLBACK rx_Handler)
-*   @brief initialize call-Back function
-*   @param[in]  tx_Handler - Transmit Handler function 
+/** @fn void CAN_Mgr_Init(uint8_t instance, FlexCAN_TRCV_CALLBACK tx_Handler,FlexCAN_RX_CALLBACK rx_Handler)
+*   @brief initialize call-Back functions of one FlexCAN instance
+*   @param[in]  instance   - FlexCAN instance, already initialized by FLEXCAN_DRV_Init
+*               tx_Handler - Transmit Handler function 
 *               rx_Handler - Receiver Handler function
 *
 *   Return - Nothing
 */
-void CAN_Mgr_Init(FlexCAN_TRCV_CALLBACK tx_Handler,FlexCAN_TRCV_CALLBACK rx_Handler)
+void CAN_Mgr_Init(uint8_t instance, FlexCAN_TRCV_CALLBACK tx_Handler,FlexCAN_RX_CALLBACK rx_Handler)
 {
-  CAN_TX_EventHandler = tx_Handler;
-  CAN_RX_EventHandler = rx_Handler;
+  flexcan_state_t * state;
+
+#ifdef DEV_ERROR_DETECT
+  DEV_ASSERT(instance < CAN_INSTANCE_COUNT);
+#endif
+  state = g_flexcanStatePtr[instance];
+#ifdef DEV_ERROR_DETECT
+  DEV_ASSERT(state != NULL);
+#endif
+
+  state->txCallback = tx_Handler;
+  state->rxCallback = rx_Handler;
 }
 /** End */
 /*******************************************************************************
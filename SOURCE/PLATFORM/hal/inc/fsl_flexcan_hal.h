@@ -47,6 +47,17 @@
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
+/*! @brief Byte swap of a message buffer word, the FlexCAN stores byte 0 of the
+ * payload in the most significant byte of the first data word */
+#if defined(__ICCARM__)
+    #include <intrinsics.h>
+    #define FLEXCAN_REV(x)          ((uint32_t)__REV(x))
+#elif defined(__GNUC__)
+    #define FLEXCAN_REV(x)          ((uint32_t)__builtin_bswap32(x))
+#else
+    #error "FLEXCAN_REV is not defined for this compiler"
+#endif
+
 enum _flexcan_brs_enable
 {
     FLEXCAN_BRS_DISABLE = 0,    /*!< FlexCAN message buffer payload size in bytes*/
@@ -207,7 +218,9 @@ typedef enum _flexcan_int_type {
     FLEXCAN_INT_TX_WARNING = CAN_CTRL1_TWRNMSK_MASK,     /*!< TX warning interrupt*/
     FLEXCAN_INT_ERR = CAN_CTRL1_ERRMSK_MASK,             /*!< Error interrupt*/
     FLEXCAN_INT_BUSOFF = CAN_CTRL1_BOFFMSK_MASK,         /*!< Bus off interrupt*/
-    FLEXCAN_INT_WAKEUP = CAN_MCR_WAKMSK_MASK             /*!< Wake up interrupt*/
+    FLEXCAN_INT_WAKEUP = CAN_MCR_WAKMSK_MASK,            /*!< Wake up interrupt*/
+    FLEXCAN_INT_BUSOFF_DONE = CAN_CTRL2_BOFFDONEMSK_MASK, /*!< Bus off done interrupt*/
+    FLEXCAN_INT_ERR_FAST = CAN_CTRL2_ERRMSK_FAST_MASK    /*!< Error interrupt of the FD data phase*/
 } flexcan_int_type_t;
 
 /*! @brief FlexCAN bus error counters*/
@@ -252,6 +265,10 @@ typedef struct MAILBOX
     uint32_t mb_msgId;
     uint8_t * mb_payload;  
     uint8_t mb_dlc;
+    uint8_t mb_index;      /* Message buffer the frame was sent from / received in */
+    uint32_t mb_timeStamp; /* Free running timer value captured at the end of the frame,
+                              extended to 32 bits by the driver (bit times) */
+    bool mb_aborted;       /* Tx MB was aborted before the frame went on the bus */
 }mailBox_t;
 
 /** End */ 
@@ -268,6 +285,9 @@ typedef struct FLEXCANTimeSegmentFd {
 #define RxFifoOcuppiedFirstMsgBuff      6U
 #define RxFifoOcuppiedLastMsgBuff(x)    (5 + (x + 1) * 8 / 4)
 #define RxFifoFilterElementNum(x)       ((x + 1) * 8)
+/* Filter elements masked by RXIMR0..n, the following ones share RXFGMASK */
+#define RxFifoIndividualMaskElementNum(x) \
+    (((RxFifoOcuppiedLastMsgBuff(x) + 1U) < 32U) ? (RxFifoOcuppiedLastMsgBuff(x) + 1U) : 32U)
 #define RxFifoFilterTableOffset         0xE0U
 
 #define FlexCanRxFifoAcceptRemoteFrame   1U
@@ -570,6 +590,60 @@ void FLEXCAN_HAL_EnableRxFifo(CAN_Type * base, uint32_t numOfFilters);
  */
 void FLEXCAN_HAL_DisableRxFifo(CAN_Type * base);
 
+/*!
+ * @brief Enables/Disables the DMA request of the Rx FIFO.
+ *
+ * When enabled, the Rx FIFO "frame available" flag requests a DMA transfer
+ * instead of an interrupt.
+ *
+ * @param   base     The FlexCAN base address
+ * @param   enable   true to enable the Rx FIFO DMA request, false to disable it
+ */
+void FLEXCAN_HAL_SetRxFifoDMA(CAN_Type * base, bool enable);
+
+/*!
+ * @brief Configures the CAN FD data phase: bit rate switch and transceiver delay compensation.
+ *
+ * @param   base        The FlexCAN base address
+ * @param   enableBrs   true to switch to the FDCBT bit rate in the data phase (FDCTRL[FDRATE])
+ * @param   enableTdc   true to enable the transceiver delay compensation
+ * @param   tdcOffset   Secondary sample point offset in CAN PE clock cycles (0..31)
+ */
+void FLEXCAN_HAL_SetFDDataPhase(CAN_Type * base, bool enableBrs, bool enableTdc, uint32_t tdcOffset);
+
+/*!
+ * @brief Enables/Disables the transmit abort feature (MCR[AEN]).
+ *
+ * @param   base     The FlexCAN base address
+ * @param   enable   true to enable the Tx abort, false to disable it
+ */
+void FLEXCAN_HAL_SetAbortCmd(CAN_Type * base, bool enable);
+
+/*!
+ * @brief Enables/Disables the automatic answer of remote requests (CTRL2[RRS] negated).
+ *
+ * When enabled, a remote request frame matching a message buffer with the
+ * FLEXCAN_RX_RANSWER code is answered with that MB; otherwise remote requests
+ * are stored like data frames.
+ *
+ * @param   base     The FlexCAN base address
+ * @param   enable   true to answer remote requests, false to store them
+ */
+void FLEXCAN_HAL_SetRemoteResponseCmd(CAN_Type * base, bool enable);
+
+/*!
+ * @brief Requests the abort of a pending Tx message buffer.
+ *
+ * The abort is safe only with MCR[AEN] set. The MB interrupt flag is raised
+ * once the request is resolved: the code reads ABORT if the frame was
+ * withdrawn, or INACTIVE if it was already being transmitted and completed.
+ *
+ * @param   base        The FlexCAN base address
+ * @param   msgBuffIdx  Index of the message buffer
+ * @return  0 if successful; non-zero failed
+ */
+flexcan_status_t FLEXCAN_HAL_AbortTxMsgBuff(CAN_Type * base, uint32_t msgBuffIdx);
+
 /*!
  * @brief Sets the number of the Rx FIFO filters.
  *
@@ -602,6 +676,28 @@ flexcan_status_t FLEXCAN_HAL_SetRxFifoFilter(
     flexcan_rx_fifo_id_element_format_t idFormat,
     flexcan_id_table_t *idFilterTable);
 
+/*!
+ * @brief Sets one format A Rx FIFO filter element and its mask.
+ *
+ * The element only accepts data frames of the given ID type. Elements below
+ * RxFifoIndividualMaskElementNum() have their own mask (RXIMR, requires the
+ * individual masking mode); the following ones share RXFGMASK, which is set to
+ * compare every bit, so they only take an exact ID (idMask with all ID bits set).
+ *
+ * @param   base        The FlexCAN base address
+ * @param   elementIdx  Index of the filter element
+ * @param   isExtended  true for a 29-bit ID, false for an 11-bit ID
+ * @param   id          ID to accept
+ * @param   idMask      ID bits to compare, right aligned like the ID
+ * @return  0 if successful; non-zero failed.
+ */
+flexcan_status_t FLEXCAN_HAL_SetRxFifoFilterElement(
+    CAN_Type * base,
+    uint32_t elementIdx,
+    bool isExtended,
+    uint32_t id,
+    uint32_t idMask);
+
 /*!
  * @brief Gets the FlexCAN Rx FIFO data.
  *
@@ -664,6 +760,8 @@ volatile uint32_t* FLEXCAN_HAL_GetMsgBuffRegion(
         uint32_t msgBuffIdx);
 uint8_t FLEXCAN_HAL_ComputePayloadSize(
         uint8_t dlcValue);
+uint8_t FLEXCAN_HAL_ComputeDLCValue(
+        uint8_t payloadSize);
 /*!
  * @brief Gets the individual FlexCAN MB interrupt flag.
  *
@@ -722,6 +820,45 @@ static inline uint32_t FLEXCAN_HAL_GetErrStatus(CAN_Type * base)
     return (base->ESR1);
 }
 
+/*!
+ * @brief Clears the given interrupt flags of the ERRSTAT register.
+ *
+ * Unlike FLEXCAN_HAL_ClearErrIntStatusFlag(), ESR1 is not read again, so the
+ * error bits set after the caller's FLEXCAN_HAL_GetErrStatus() are not lost.
+ *
+ * @param   base     The FlexCAN base address
+ * @param   flags    ESR1 interrupt flags to clear (write 1 to clear bits)
+ */
+static inline void FLEXCAN_HAL_ClearErrStatusFlags(CAN_Type * base, uint32_t flags)
+{
+    (base->ESR1) = flags;
+}
+
+/*!
+ * @brief Enables or disables the automatic recovery from bus off.
+ *
+ * With the automatic recovery disabled, the module stays in bus off until it is
+ * enabled again, even after 128 occurrences of 11 recessive bits.
+ *
+ * @param   base     The FlexCAN base address
+ * @param   enable   true to recover automatically, false to hold the bus off state
+ */
+static inline void FLEXCAN_HAL_SetBusOffRecoveryCmd(CAN_Type * base, bool enable)
+{
+    BITBAND_ACCESS32(&(base->CTRL1), CAN_CTRL1_BOFFREC_SHIFT) = (enable ? 0x0 : 0x1);
+}
+
+/*!
+ * @brief Returns whether the automatic recovery from bus off is enabled.
+ *
+ * @param   base     The FlexCAN base address
+ * @return  true if the module leaves bus off by itself
+ */
+static inline bool FLEXCAN_HAL_GetBusOffRecoveryCmd(CAN_Type * base)
+{
+    return (BITBAND_ACCESS32(&(base->CTRL1), CAN_CTRL1_BOFFREC_SHIFT) == 0U);
+}
+
 /*!
  * @brief Clears all other interrupts in ERRSTAT register (Error, Busoff, Wakeup).
  *
@@ -868,6 +1005,146 @@ extern flexcan_status_t FLEXCAN_HAL_GetMailBox( CAN_Type * base, uint32_t msgBuf
 /** end */
 /*@}*/
 
+/*!
+ * @name Unchecked message buffer access
+ * The accessors below take the MB address instead of an index and perform no
+ * validation at all. They are meant for the per-frame paths of the driver,
+ * with MBs that already went through the checked configuration functions.
+ * @{
+ */
+
+/*! @brief Payload size in bytes of each DLC value */
+extern const uint8_t g_flexcanDlcToPayload[16];
+
+/*! @brief Smallest DLC value able to carry a payload of 0 to 64 bytes */
+extern const uint8_t g_flexcanPayloadToDlc[65];
+
+/*!
+ * @brief Converts a DLC value into its payload size (no range check).
+ *
+ * @param   dlcValue    DLC field value, only the lower 4 bits are used
+ * @return  payload size in bytes
+ */
+static inline uint8_t FLEXCAN_HAL_DlcToPayloadSize(uint32_t dlcValue)
+{
+    return g_flexcanDlcToPayload[dlcValue & 0xFU];
+}
+
+/*!
+ * @brief Converts a payload size into the smallest DLC value able to carry it.
+ *
+ * @param   payloadSize Payload size in bytes, must not exceed 64
+ * @return  DLC field value
+ */
+static inline uint8_t FLEXCAN_HAL_PayloadSizeToDlc(uint32_t payloadSize)
+{
+    return g_flexcanPayloadToDlc[payloadSize];
+}
+
+/*!
+ * @brief Copies payload bytes out of a MB data area, word by word.
+ *
+ * @param   mbData      First data word of the MB
+ * @param   data        Destination buffer, byte n of the frame is written at data[n]
+ * @param   len         Number of bytes to copy
+ */
+void FLEXCAN_HAL_ReadMsgBuffData(
+    volatile const uint32_t *mbData,
+    uint8_t *data,
+    uint32_t len);
+
+/*!
+ * @brief Copies payload bytes into a MB data area, word by word.
+ *
+ * @param   mbData      First data word of the MB
+ * @param   data        Source buffer
+ * @param   len         Number of bytes to copy
+ * @param   payloadSize Payload size of the frame DLC, the bytes between len and
+ *                      payloadSize are filled with padding
+ * @param   padding     Padding byte value
+ */
+void FLEXCAN_HAL_WriteMsgBuffData(
+    volatile uint32_t *mbData,
+    const uint8_t *data,
+    uint32_t len,
+    uint32_t payloadSize,
+    uint8_t padding);
+
+/*!
+ * @brief Starts a transmission from an inactive Tx MB.
+ *
+ * The payload and the ID word are written first, the C/S word holding the
+ * code, DLC and frame format flags last.
+ *
+ * @param   mb          MB address
+ * @param   cs          C/S word to write, with the code set to FLEXCAN_TX_DATA
+ * @param   id          ID word to write
+ * @param   msgData     Payload, NULL to send the MB data area as it is
+ * @param   dataLen     Number of payload bytes, at most the payload size of the DLC
+ * @param   padding     Padding byte up to the payload size of the DLC
+ */
+static inline void FLEXCAN_HAL_SetTxMsgBuffFast(
+    volatile uint32_t *mb,
+    uint32_t cs,
+    uint32_t id,
+    const uint8_t *msgData,
+    uint32_t dataLen,
+    uint8_t padding)
+{
+    if (msgData != NULL)
+    {
+        FLEXCAN_HAL_WriteMsgBuffData(mb + 2, msgData, dataLen,
+                                     FLEXCAN_HAL_DlcToPayloadSize(cs >> CAN_CS_DLC_SHIFT), padding);
+    }
+    mb[1] = id;
+    mb[0] = cs;
+}
+
+/*!
+ * @brief Reads a MB, the C/S word first so that the MB gets locked.
+ *
+ * @param   mb          MB address
+ * @param   msgBuff     The fields of the message buffer
+ * @return  payload size in bytes
+ */
+static inline uint8_t FLEXCAN_HAL_GetMsgBuffFast(
+    volatile const uint32_t *mb,
+    flexcan_msgbuff_t *msgBuff)
+{
+    uint32_t cs = mb[0];
+    uint8_t payload_size = FLEXCAN_HAL_DlcToPayloadSize(cs >> CAN_CS_DLC_SHIFT);
+
+    msgBuff->cs = cs;
+    msgBuff->msgId = (cs & CAN_CS_IDE_MASK) ? mb[1] : (mb[1] >> CAN_ID_STD_SHIFT);
+    FLEXCAN_HAL_ReadMsgBuffData(mb + 2, msgBuff->data, payload_size);
+
+    return payload_size;
+}
+
+/*!
+ * @brief Reads a transmitted MB back into a mailbox description.
+ *
+ * @param   mb          MB address
+ * @param   msgBuffIdx  Index of the message buffer
+ * @param   msgBuff     The fields of the message buffer
+ * @param   mailBox     Mailbox description, refers to msgBuff for the payload
+ */
+static inline void FLEXCAN_HAL_GetMailBoxFast(
+    volatile const uint32_t *mb,
+    uint32_t msgBuffIdx,
+    flexcan_msgbuff_t *msgBuff,
+    mailBox_t *mailBox)
+{
+    mailBox->mb_dlc = FLEXCAN_HAL_GetMsgBuffFast(mb, msgBuff);
+    mailBox->mb_index = (uint8_t)msgBuffIdx;
+    mailBox->mb_msgId = msgBuff->msgId;
+    mailBox->mb_timeStamp = msgBuff->cs & CAN_CS_TIME_STAMP_MASK;
+    mailBox->mb_aborted = (((msgBuff->cs & CAN_CS_CODE_MASK) >> CAN_CS_CODE_SHIFT) == FLEXCAN_TX_ABORT);
+    mailBox->mb_payload = msgBuff->data;
+}
+
+/*@}*/
+
 #if defined(__cplusplus)
 }
 #endif
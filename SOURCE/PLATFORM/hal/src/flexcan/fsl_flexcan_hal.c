@@ -27,6 +27,7 @@
  * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
+#include <string.h>
 #include "fsl_flexcan_hal.h"
 
 
@@ -35,6 +36,32 @@
  ******************************************************************************/
    extern uint8_t can_real_payload;
    extern uint8_t can_payload[4u];
+
+/* Payload size in bytes of each DLC value */
+const uint8_t g_flexcanDlcToPayload[16] =
+{
+    0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U
+};
+
+/* Smallest DLC value carrying a payload of the index size (0 to 64 bytes) */
+const uint8_t g_flexcanPayloadToDlc[65] =
+{
+    0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U,
+    CAN_DLC_VALUE_12_BYTES, CAN_DLC_VALUE_12_BYTES, CAN_DLC_VALUE_12_BYTES, CAN_DLC_VALUE_12_BYTES,
+    CAN_DLC_VALUE_16_BYTES, CAN_DLC_VALUE_16_BYTES, CAN_DLC_VALUE_16_BYTES, CAN_DLC_VALUE_16_BYTES,
+    CAN_DLC_VALUE_20_BYTES, CAN_DLC_VALUE_20_BYTES, CAN_DLC_VALUE_20_BYTES, CAN_DLC_VALUE_20_BYTES,
+    CAN_DLC_VALUE_24_BYTES, CAN_DLC_VALUE_24_BYTES, CAN_DLC_VALUE_24_BYTES, CAN_DLC_VALUE_24_BYTES,
+    CAN_DLC_VALUE_32_BYTES, CAN_DLC_VALUE_32_BYTES, CAN_DLC_VALUE_32_BYTES, CAN_DLC_VALUE_32_BYTES,
+    CAN_DLC_VALUE_32_BYTES, CAN_DLC_VALUE_32_BYTES, CAN_DLC_VALUE_32_BYTES, CAN_DLC_VALUE_32_BYTES,
+    CAN_DLC_VALUE_48_BYTES, CAN_DLC_VALUE_48_BYTES, CAN_DLC_VALUE_48_BYTES, CAN_DLC_VALUE_48_BYTES,
+    CAN_DLC_VALUE_48_BYTES, CAN_DLC_VALUE_48_BYTES, CAN_DLC_VALUE_48_BYTES, CAN_DLC_VALUE_48_BYTES,
+    CAN_DLC_VALUE_48_BYTES, CAN_DLC_VALUE_48_BYTES, CAN_DLC_VALUE_48_BYTES, CAN_DLC_VALUE_48_BYTES,
+    CAN_DLC_VALUE_48_BYTES, CAN_DLC_VALUE_48_BYTES, CAN_DLC_VALUE_48_BYTES, CAN_DLC_VALUE_48_BYTES,
+    CAN_DLC_VALUE_64_BYTES, CAN_DLC_VALUE_64_BYTES, CAN_DLC_VALUE_64_BYTES, CAN_DLC_VALUE_64_BYTES,
+    CAN_DLC_VALUE_64_BYTES, CAN_DLC_VALUE_64_BYTES, CAN_DLC_VALUE_64_BYTES, CAN_DLC_VALUE_64_BYTES,
+    CAN_DLC_VALUE_64_BYTES, CAN_DLC_VALUE_64_BYTES, CAN_DLC_VALUE_64_BYTES, CAN_DLC_VALUE_64_BYTES,
+    CAN_DLC_VALUE_64_BYTES, CAN_DLC_VALUE_64_BYTES, CAN_DLC_VALUE_64_BYTES, CAN_DLC_VALUE_64_BYTES
+};
     
 /*******************************************************************************
  * Definitions
@@ -81,9 +108,8 @@
                                                                      /*! interrupts*/
 #define FLEXCAN_BYTE_DATA_FIELD_MASK                  (0xFFU)        /*!< Masks for byte data field.*/
 
-/* Converts the index in an array of bytes to an index in an array of bytes with 
- * reversed endianness. */
-#define FLEXCAN_SWAP_BYTES_IN_WORD_INDEX(index)       (((index) & ~3U) + (3U - ((index) & 3U)))
+/* Replicates the padding byte into every byte lane of a payload word */
+#define FLEXCAN_PADDING_WORD(padding)                 ((uint32_t)(padding) * 0x01010101U)
 
 /*FD constant with all available payload values*/
 
@@ -91,6 +117,89 @@
  * Private Functions
  ******************************************************************************/
 
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_HAL_ReadMsgBuffData
+ * Description   : Copy len payload bytes out of a MB data area.
+ * The MB RAM is only read as whole words, each word is byte reversed once
+ * and stored with a single (possibly unaligned) word store.
+ *
+ *END**************************************************************************/
+void FLEXCAN_HAL_ReadMsgBuffData(
+    volatile const uint32_t *mbData,
+    uint8_t *data,
+    uint32_t len)
+{
+    uint32_t words = len >> 2U;
+    uint32_t word;
+    uint32_t i;
+
+    for (i = 0; i < words; i++)
+    {
+        word = FLEXCAN_REV(mbData[i]);
+        memcpy(&data[i << 2U], &word, sizeof(word));
+    }
+
+    /* Last partial word, byte 0 sits in the most significant byte */
+    len &= 3U;
+    if (len != 0U)
+    {
+        word = mbData[words];
+        data += words << 2U;
+        for (i = 0; i < len; i++)
+        {
+            data[i] = (uint8_t)(word >> (24U - (i << 3U)));
+        }
+    }
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_HAL_WriteMsgBuffData
+ * Description   : Copy len payload bytes into a MB data area.
+ * The MB RAM is only written as whole words. The bytes following the payload
+ * up to payloadSize are filled with the padding byte, a word at a time.
+ *
+ *END**************************************************************************/
+void FLEXCAN_HAL_WriteMsgBuffData(
+    volatile uint32_t *mbData,
+    const uint8_t *data,
+    uint32_t len,
+    uint32_t payloadSize,
+    uint8_t padding)
+{
+    uint32_t words = len >> 2U;
+    uint32_t pad_word = FLEXCAN_PADDING_WORD(padding);
+    uint32_t word;
+    uint32_t i;
+
+    for (i = 0; i < words; i++)
+    {
+        memcpy(&word, &data[i << 2U], sizeof(word));
+        mbData[i] = FLEXCAN_REV(word);
+    }
+
+    /* Last partial word, completed with padding */
+    len &= 3U;
+    if (len != 0U)
+    {
+        word = pad_word;
+        data += words << 2U;
+        for (i = 0; i < len; i++)
+        {
+            word &= ~(0xFF000000U >> (i << 3U));
+            word |= (uint32_t)data[i] << (24U - (i << 3U));
+        }
+        mbData[words] = word;
+        words++;
+    }
+
+    for (i = words; i < ((payloadSize + 3U) >> 2U); i++)
+    {
+        mbData[i] = pad_word;
+    }
+}
+
 /*FUNCTION**********************************************************************
  *
  * Function Name : FLEXCAN_HAL_GetMsgBuffRegion
@@ -120,25 +229,13 @@ volatile uint32_t* FLEXCAN_HAL_GetMsgBuffRegion(
 uint8_t FLEXCAN_HAL_ComputeDLCValue(
         uint8_t payloadSize)
 {
-    if (payloadSize <= 8)
-        return payloadSize;
-    else if ((payloadSize > 8) && (payloadSize <= 12))
-        return CAN_DLC_VALUE_12_BYTES;
-    else if ((payloadSize > 12) && (payloadSize <= 16))
-        return CAN_DLC_VALUE_16_BYTES;
-    else if ((payloadSize > 16) && (payloadSize <= 20))
-        return CAN_DLC_VALUE_20_BYTES;
-    else if ((payloadSize > 20) && (payloadSize <= 24))
-        return CAN_DLC_VALUE_24_BYTES;
-    else if ((payloadSize > 24) && (payloadSize <= 32))
-        return CAN_DLC_VALUE_32_BYTES;
-    else if ((payloadSize > 32) && (payloadSize <= 48))
-        return CAN_DLC_VALUE_48_BYTES;
-    else if ((payloadSize > 48) && (payloadSize <= 64))
-        return CAN_DLC_VALUE_64_BYTES;
-
-    /* The argument is not a valid payload size */
-    return 0xFF;
+    if (payloadSize > 64U)
+    {
+        /* The argument is not a valid payload size */
+        return 0xFF;
+    }
+
+    return g_flexcanPayloadToDlc[payloadSize];
 }
 
 /*FUNCTION**********************************************************************
@@ -151,33 +248,14 @@ uint8_t FLEXCAN_HAL_ComputeDLCValue(
 uint8_t FLEXCAN_HAL_ComputePayloadSize(
         uint8_t dlcValue)
 {
-    if (dlcValue <= 8)
-        return dlcValue;
-
-    switch (dlcValue) {
-    case CAN_DLC_VALUE_12_BYTES:
-        return 12;
-    case CAN_DLC_VALUE_16_BYTES:
-        return 16;
-    case CAN_DLC_VALUE_20_BYTES:
-        return 20;
-    case CAN_DLC_VALUE_24_BYTES:
-        return 24;
-    case CAN_DLC_VALUE_32_BYTES:
-        return 32;
-    case CAN_DLC_VALUE_48_BYTES:
-        return 48;
-    case CAN_DLC_VALUE_64_BYTES:
-        return 64;
-    default:
+    if (dlcValue > CAN_DLC_VALUE_64_BYTES)
+    {
         /* The argument is not a valid DLC value */
         return 0xFF;
     }
-}
 
-/*******************************************************************************
- * Code
- ******************************************************************************/
+    return g_flexcanDlcToPayload[dlcValue];
+}
 
 /*FUNCTION**********************************************************************
  *
@@ -384,13 +462,12 @@ flexcan_status_t FLEXCAN_HAL_SetTxMsgBuff(
 {
     uint32_t val1, val2 = 1;   
     uint32_t flexcan_mb_config = 0;    
-    uint8_t databyte;
     uint8_t dlc_value;
     
     volatile uint32_t *flexcan_mb = FLEXCAN_HAL_GetMsgBuffRegion(base, msgBuffIdx);
 
     volatile uint32_t *flexcan_mb_id   = flexcan_mb + 1;
-    volatile uint8_t  *flexcan_mb_data = (uint8_t *)(flexcan_mb + 2);
+    volatile uint32_t *flexcan_mb_data = flexcan_mb + 2;
         
     if (msgBuffIdx >= (((base->MCR) & CAN_MCR_MAXMB_MASK) >> CAN_MCR_MAXMB_SHIFT) )
     {
@@ -415,7 +492,7 @@ flexcan_status_t FLEXCAN_HAL_SetTxMsgBuff(
     }
 
     /* Make sure the BRS bit will not be ignored */
-    if (FLEXCAN_HAL_IsFDEnabled(base) && cs->enable_brs)
+    if (FLEXCAN_HAL_IsFDEnabled(base) && cs->fd_enable && cs->enable_brs)
     {
        BITBAND_ACCESS32(&(base->FDCTRL), CAN_FDCTRL_FDRATE_SHIFT) = 1;
     }
@@ -423,19 +500,19 @@ flexcan_status_t FLEXCAN_HAL_SetTxMsgBuff(
     /* Compute the value of the DLC field */
     dlc_value = FLEXCAN_HAL_ComputeDLCValue(cs->dataLen);
 
+    /* The frame has to fit the frame format and the MB payload area */
+    if ((dlc_value == 0xFFU) || ((cs->fd_enable != 1) && (cs->dataLen > 8U)) || \
+        (FLEXCAN_HAL_ComputePayloadSize(dlc_value) > FLEXCAN_HAL_GetPayloadSize(base)))
+    {
+        return FLEXCAN_STATUS_INVALID_ARGUMENT;
+    }
+
     /* Copy user's buffer into the message buffer data area */
     if (msgData != NULL)
     {
-        uint8_t payload_size = FLEXCAN_HAL_ComputePayloadSize(dlc_value);
-        for (databyte = 0; databyte < cs->dataLen; databyte++)
-        {
-            flexcan_mb_data[FLEXCAN_SWAP_BYTES_IN_WORD_INDEX(databyte)] =  msgData[databyte];
-        }
-        /* Add padding, if needed */
-        for (databyte = cs->dataLen; databyte < payload_size; databyte++)
-        {
-            flexcan_mb_data[FLEXCAN_SWAP_BYTES_IN_WORD_INDEX(databyte)] = cs->fd_padding;
-        }
+        /* Padding is added up to the payload size of the DLC, if needed */
+        FLEXCAN_HAL_WriteMsgBuffData(flexcan_mb_data, msgData, cs->dataLen,
+                                     FLEXCAN_HAL_ComputePayloadSize(dlc_value), cs->fd_padding);
     }
 
     /* Clean up the arbitration field area */
@@ -496,7 +573,8 @@ flexcan_status_t FLEXCAN_HAL_SetTxMsgBuff(
             flexcan_mb_config |= (cs->code << CAN_CS_CODE_SHIFT) & CAN_CS_CODE_MASK;
         }  
 
-        if (cs->enable_brs == 1)
+        /* BRS only exists in the FD frame format */
+        if ((cs->fd_enable == 1) && (cs->enable_brs == 1))
         {
             flexcan_mb_config |= CAN_MB_BRS_MASK;
         }
@@ -606,12 +684,11 @@ flexcan_status_t FLEXCAN_HAL_GetMsgBuff(
     uint32_t msgBuffIdx,
     flexcan_msgbuff_t *msgBuff)
 {
-    uint32_t i;
     uint32_t val1, val2 = 1;
 
     volatile uint32_t *flexcan_mb = FLEXCAN_HAL_GetMsgBuffRegion(base, msgBuffIdx);
     volatile uint32_t *flexcan_mb_id   = flexcan_mb + 1;
-    volatile uint8_t  *flexcan_mb_data = (uint8_t *)(flexcan_mb + 2);
+    volatile uint32_t *flexcan_mb_data = flexcan_mb + 2;
 
     uint32_t flexcan_mb_dlc_value = ((*flexcan_mb) & CAN_CS_DLC_MASK) >> 16;
     uint8_t payload_size = FLEXCAN_HAL_ComputePayloadSize(flexcan_mb_dlc_value);
@@ -650,10 +727,7 @@ flexcan_status_t FLEXCAN_HAL_GetMsgBuff(
     }
 
     /* Copy MB data field into user's buffer */
-    for (i = 0 ; i < payload_size ; i++)
-    {
-        msgBuff->data[i] = flexcan_mb_data[FLEXCAN_SWAP_BYTES_IN_WORD_INDEX(i)];
-    }
+    FLEXCAN_HAL_ReadMsgBuffData(flexcan_mb_data, msgBuff->data, payload_size);
 
     return FLEXCAN_STATUS_SUCCESS;
 }
@@ -675,12 +749,11 @@ flexcan_status_t FLEXCAN_HAL_GetMailBox(
     flexcan_msgbuff_t *msgBuff,
     mailBox_t *mailBox)
 {
-    uint32_t i;
     uint32_t val1, val2 = 1;
 
     volatile uint32_t *flexcan_mb = FLEXCAN_HAL_GetMsgBuffRegion(base, msgBuffIdx);
     volatile uint32_t *flexcan_mb_id   = flexcan_mb + 1;
-    volatile uint8_t  *flexcan_mb_data = (uint8_t *)(flexcan_mb + 2);
+    volatile uint32_t *flexcan_mb_data = flexcan_mb + 2;
 
     uint32_t flexcan_mb_dlc_value = ((*flexcan_mb) & CAN_CS_DLC_MASK) >> 16;
     uint8_t payload_size = FLEXCAN_HAL_ComputePayloadSize(flexcan_mb_dlc_value);
@@ -709,6 +782,9 @@ flexcan_status_t FLEXCAN_HAL_GetMailBox(
 
     /* Get paylod from MB */
     mailBox->mb_dlc = payload_size;
+    mailBox->mb_index = (uint8_t)msgBuffIdx;
+    mailBox->mb_timeStamp = ((*flexcan_mb) & CAN_CS_TIME_STAMP_MASK);
+    mailBox->mb_aborted = ((((*flexcan_mb) & CAN_CS_CODE_MASK) >> CAN_CS_CODE_SHIFT) == FLEXCAN_TX_ABORT);
     
     /* Get a MB field values */
     msgBuff->cs = *flexcan_mb;
@@ -725,10 +801,7 @@ flexcan_status_t FLEXCAN_HAL_GetMailBox(
     }
 
     /* Copy MB data field into user's buffer */
-    for (i = 0 ; i < payload_size ; i++)
-    {
-       msgBuff->data[i] = flexcan_mb_data[FLEXCAN_SWAP_BYTES_IN_WORD_INDEX(i)];
-    }
+    FLEXCAN_HAL_ReadMsgBuffData(flexcan_mb_data, msgBuff->data, payload_size);
 
     mailBox->mb_payload = msgBuff->data;
     
@@ -796,6 +869,113 @@ void FLEXCAN_HAL_EnableRxFifo(CAN_Type * base, uint32_t numOfFilters)
     FLEXCAN_HAL_ExitFreezeMode(base);
 }
 
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_HAL_SetRxFifoDMA
+ * Description   : Enable/Disable the Rx FIFO DMA request.
+ * This function will select whether the Rx FIFO frame available flag
+ * generates a DMA request or an interrupt.
+ *
+ *END**************************************************************************/
+void FLEXCAN_HAL_SetRxFifoDMA(CAN_Type * base, bool enable)
+{
+    /* Set Freeze mode*/
+    FLEXCAN_HAL_EnterFreezeMode(base);
+
+    BITBAND_ACCESS32(&(base->MCR), CAN_MCR_DMA_SHIFT) = (enable ? 0x1 : 0x0);
+
+    /* De-assert Freeze Mode*/
+    FLEXCAN_HAL_ExitFreezeMode(base);
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_HAL_SetFDDataPhase
+ * Description   : Configure the CAN FD data phase.
+ * This function selects whether frames with BRS set use the FDCBT bit rate in
+ * their data phase, and sets up the transceiver delay compensation, which is
+ * needed once the data bit time gets close to the transceiver loop delay.
+ *
+ *END**************************************************************************/
+void FLEXCAN_HAL_SetFDDataPhase(CAN_Type * base, bool enableBrs, bool enableTdc, uint32_t tdcOffset)
+{
+    uint32_t tmp;
+
+    /* Set Freeze mode*/
+    FLEXCAN_HAL_EnterFreezeMode(base);
+
+    tmp = base->FDCTRL;
+    tmp &= ~(CAN_FDCTRL_FDRATE_MASK | CAN_FDCTRL_TDCEN_MASK | CAN_FDCTRL_TDCOFF_MASK);
+    tmp |= CAN_FDCTRL_FDRATE(enableBrs ? 1UL : 0UL);
+    if (enableTdc)
+    {
+        tmp |= CAN_FDCTRL_TDCEN_MASK | CAN_FDCTRL_TDCOFF(tdcOffset);
+    }
+    base->FDCTRL = tmp;
+
+    /* De-assert Freeze Mode*/
+    FLEXCAN_HAL_ExitFreezeMode(base);
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_HAL_SetAbortCmd
+ * Description   : Enable/Disable the transmit abort feature.
+ * With MCR[AEN] set, a pending Tx MB can be withdrawn by writing the ABORT code.
+ *
+ *END**************************************************************************/
+void FLEXCAN_HAL_SetAbortCmd(CAN_Type * base, bool enable)
+{
+    /* Set Freeze mode*/
+    FLEXCAN_HAL_EnterFreezeMode(base);
+
+    BITBAND_ACCESS32(&(base->MCR), CAN_MCR_AEN_SHIFT) = (enable ? 0x1 : 0x0);
+
+    /* De-assert Freeze Mode*/
+    FLEXCAN_HAL_ExitFreezeMode(base);
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_HAL_SetRemoteResponseCmd
+ * Description   : Enable/Disable the automatic answer of remote requests.
+ * With CTRL2[RRS] negated, a remote request matching a RANSWER MB makes the
+ * controller transmit that MB.
+ *
+ *END**************************************************************************/
+void FLEXCAN_HAL_SetRemoteResponseCmd(CAN_Type * base, bool enable)
+{
+    /* Set Freeze mode*/
+    FLEXCAN_HAL_EnterFreezeMode(base);
+
+    BITBAND_ACCESS32(&(base->CTRL2), CAN_CTRL2_RRS_SHIFT) = (enable ? 0x0 : 0x1);
+
+    /* De-assert Freeze Mode*/
+    FLEXCAN_HAL_ExitFreezeMode(base);
+}
+
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_HAL_AbortTxMsgBuff
+ * Description   : Request the abort of a Tx message buffer.
+ * This function writes the ABORT code into the MB, keeping the other C/S fields.
+ *
+ *END**************************************************************************/
+flexcan_status_t FLEXCAN_HAL_AbortTxMsgBuff(CAN_Type * base, uint32_t msgBuffIdx)
+{
+    volatile uint32_t *flexcan_mb = FLEXCAN_HAL_GetMsgBuffRegion(base, msgBuffIdx);
+
+    if (msgBuffIdx >= (((base->MCR) & CAN_MCR_MAXMB_MASK) >> CAN_MCR_MAXMB_SHIFT))
+    {
+        return FLEXCAN_STATUS_OUT_OF_RANGE;
+    }
+
+    *flexcan_mb = ((*flexcan_mb) & ~CAN_CS_CODE_MASK) |
+                  (((uint32_t)FLEXCAN_TX_ABORT << CAN_CS_CODE_SHIFT) & CAN_CS_CODE_MASK);
+
+    return FLEXCAN_STATUS_SUCCESS;
+}
+
 /*FUNCTION**********************************************************************
  *
  * Function Name : FLEXCAN_HAL_DisableRxFifo
@@ -847,7 +1027,7 @@ void FLEXCAN_HAL_SetMaxMsgBuffNum(
     uint32_t maxMsgBuffNum)
 {
     uint8_t msgBuffIdx;
-    uint32_t databyte;
+    uint32_t dataword;
 
     /* Set Freeze mode*/
     FLEXCAN_HAL_EnterFreezeMode(base);
@@ -861,13 +1041,13 @@ void FLEXCAN_HAL_SetMaxMsgBuffNum(
     {
         volatile uint32_t *flexcan_mb = FLEXCAN_HAL_GetMsgBuffRegion(base, msgBuffIdx);
         volatile uint32_t *flexcan_mb_id   = flexcan_mb + 1;
-        volatile uint8_t  *flexcan_mb_data = (uint8_t *)(flexcan_mb + 2);
+        volatile uint32_t *flexcan_mb_data = flexcan_mb + 2;
         
         *flexcan_mb = 0x0;
         *flexcan_mb_id = 0x0;
-        for (databyte = 0; databyte < can_real_payload; databyte++)
+        for (dataword = 0; dataword < (can_real_payload >> 2U); dataword++)
         {
-           flexcan_mb_data[databyte] = 0x0;
+           flexcan_mb_data[dataword] = 0x0;
         }
     }
 
@@ -990,6 +1170,73 @@ flexcan_status_t FLEXCAN_HAL_SetRxFifoFilter(
     return FLEXCAN_STATUS_SUCCESS;
 }
 
+/*FUNCTION**********************************************************************
+ *
+ * Function Name : FLEXCAN_HAL_SetRxFifoFilterElement
+ * Description   : Set one format A Rx FIFO ID filter element and its mask.
+ * The mask covers the RTR and IDE bits as well, so that the element takes
+ * data frames of its ID type only. Elements without an individual mask rely
+ * on RXFGMASK comparing every bit and only accept an exact ID.
+ *
+ *END**************************************************************************/
+flexcan_status_t FLEXCAN_HAL_SetRxFifoFilterElement(
+    CAN_Type * base,
+    uint32_t elementIdx,
+    bool isExtended,
+    uint32_t id,
+    uint32_t idMask)
+{
+    volatile uint32_t *filterTable = (uint32_t *)((uint32_t)base + RxFifoFilterTableOffset);
+    uint32_t numOfFilters = (((base->CTRL2) & CAN_CTRL2_RFFN_MASK) >> CAN_CTRL2_RFFN_SHIFT);
+    uint32_t element, mask, fullMask;
+
+    if (elementIdx >= RxFifoFilterElementNum(numOfFilters))
+    {
+        return FLEXCAN_STATUS_OUT_OF_RANGE;
+    }
+
+    fullMask = (1UL << FLEXCAN_RX_FIFO_ID_FILTER_FORMATAB_RTR_SHIFT) |
+               (1UL << FLEXCAN_RX_FIFO_ID_FILTER_FORMATAB_IDE_SHIFT);
+    if (isExtended)
+    {
+        element = (FlexCanRxFifoAcceptExtFrame << FLEXCAN_RX_FIFO_ID_FILTER_FORMATAB_IDE_SHIFT) |
+                  ((id << FLEXCAN_RX_FIFO_ID_FILTER_FORMATA_EXT_SHIFT) & FLEXCAN_RX_FIFO_ID_FILTER_FORMATA_EXT_MASK);
+        mask = (idMask << FLEXCAN_RX_FIFO_ID_FILTER_FORMATA_EXT_SHIFT) & FLEXCAN_RX_FIFO_ID_FILTER_FORMATA_EXT_MASK;
+        fullMask |= FLEXCAN_RX_FIFO_ID_FILTER_FORMATA_EXT_MASK;
+    }
+    else
+    {
+        element = (id << FLEXCAN_RX_FIFO_ID_FILTER_FORMATA_STD_SHIFT) & FLEXCAN_RX_FIFO_ID_FILTER_FORMATA_STD_MASK;
+        mask = (idMask << FLEXCAN_RX_FIFO_ID_FILTER_FORMATA_STD_SHIFT) & FLEXCAN_RX_FIFO_ID_FILTER_FORMATA_STD_MASK;
+        fullMask |= FLEXCAN_RX_FIFO_ID_FILTER_FORMATA_STD_MASK;
+    }
+    mask |= (1UL << FLEXCAN_RX_FIFO_ID_FILTER_FORMATAB_RTR_SHIFT) |
+            (1UL << FLEXCAN_RX_FIFO_ID_FILTER_FORMATAB_IDE_SHIFT);
+
+    /* The shared global mask cannot take a partial mask */
+    if ((elementIdx >= RxFifoIndividualMaskElementNum(numOfFilters)) && (mask != fullMask))
+    {
+        return FLEXCAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    /* The filter table and the masks are only writable in freeze mode */
+    FLEXCAN_HAL_EnterFreezeMode(base);
+
+    filterTable[elementIdx] = element;
+    if (elementIdx < RxFifoIndividualMaskElementNum(numOfFilters))
+    {
+        base->RXIMR[elementIdx] = mask;
+    }
+    else
+    {
+        base->RXFGMASK = 0xFFFFFFFFU;
+    }
+
+    FLEXCAN_HAL_ExitFreezeMode(base);
+
+    return FLEXCAN_STATUS_SUCCESS;
+}
+
 /*FUNCTION**********************************************************************
  *
  * Function Name : FLEXCAN_HAL_SetMsgBuffIntCmd
@@ -1024,8 +1271,9 @@ flexcan_status_t FLEXCAN_HAL_SetMsgBuffIntCmd(
 /*FUNCTION**********************************************************************
  *
  * Function Name : FLEXCAN_HAL_SetErrIntCmd
- * Description   : Enable the error interrupts.
- * This function will enable Error interrupt.
+ * Description   : Enable or disable one of the error interrupts.
+ * The bus off done and FD data phase error masks live in CTRL2, the wake up
+ * mask in MCR, the others in CTRL1.
  *
  *END**************************************************************************/
 void FLEXCAN_HAL_SetErrIntCmd(CAN_Type * base, flexcan_int_type_t errType, bool enable)
@@ -1041,7 +1289,14 @@ void FLEXCAN_HAL_SetErrIntCmd(CAN_Type * base, flexcan_int_type_t errType, bool
         {
             BITBAND_ACCESS32(&(base->MCR), CAN_MCR_WAKMSK_SHIFT) = (0x1);
         }
-        (base->CTRL1) = ((base->CTRL1) |  (temp));
+        else if((errType == FLEXCAN_INT_BUSOFF_DONE)||(errType == FLEXCAN_INT_ERR_FAST))
+        {
+            (base->CTRL2) = ((base->CTRL2) | (temp));
+        }
+        else
+        {
+            (base->CTRL1) = ((base->CTRL1) | (temp));
+        }
     }
     else
     {
@@ -1049,7 +1304,14 @@ void FLEXCAN_HAL_SetErrIntCmd(CAN_Type * base, flexcan_int_type_t errType, bool
         {
             (BITBAND_ACCESS32(&(base->MCR), CAN_MCR_WAKMSK_SHIFT) = (0x0));
         }
-        (base->CTRL1) = ((base->CTRL1) & ~(~temp));
+        else if((errType == FLEXCAN_INT_BUSOFF_DONE)||(errType == FLEXCAN_INT_ERR_FAST))
+        {
+            (base->CTRL2) = ((base->CTRL2) & ~(temp));
+        }
+        else
+        {
+            (base->CTRL1) = ((base->CTRL1) & ~(temp));
+        }
     }
 }
 
@@ -1141,18 +1403,17 @@ void FLEXCAN_HAL_ClearErrIntStatusFlag(CAN_Type * base)
  *
  * Function Name : FLEXCAN_HAL_ReadRxFifo
  * Description   : Read Rx FIFO data.
- * This function will copy MB[0] data field into user's buffer.
+ * This function will copy MB[0] data field into user's buffer, in the same
+ * byte order as FLEXCAN_HAL_GetMsgBuff.
  *
  *END**************************************************************************/
 flexcan_status_t FLEXCAN_HAL_ReadRxFifo(
     CAN_Type * base,
     flexcan_msgbuff_t *rxFifo)
 {
-    uint32_t databyte = 0;
-    
     volatile uint32_t *flexcan_mb = base->RAMn;
     volatile uint32_t *flexcan_mb_id = &base->RAMn[1];
-    volatile uint8_t *flexcan_mb_data = (volatile uint8_t *)(&base->RAMn[2]);
+    volatile uint32_t *flexcan_mb_data = &base->RAMn[2];
     uint8_t can_real_payload = FLEXCAN_HAL_GetPayloadSize(base);
     
     rxFifo->cs = *flexcan_mb;
@@ -1167,10 +1428,7 @@ flexcan_status_t FLEXCAN_HAL_ReadRxFifo(
     }
 
     /* Copy MB[0] data field into user's buffer */
-    for (databyte = 0; databyte < can_real_payload; databyte++ )
-    {
-        rxFifo->data[databyte] = *(flexcan_mb_data + databyte);
-    }
+    FLEXCAN_HAL_ReadMsgBuffData(flexcan_mb_data, rxFifo->data, can_real_payload);
 
     return FLEXCAN_STATUS_SUCCESS;
 }
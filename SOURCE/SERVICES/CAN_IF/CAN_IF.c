@@ -7,17 +7,57 @@
 #include "Includes.h"
 
 #include "CAN_IF.h"
+#include "CAN_IF_Config.h"
 #include "CAN_IF_Priv.h"
 
 #include "Cpu.h"
 #include "clockMan1.h"
 #include "canCom1.h"
 #include "pin_mux.h"
+#include "fsl_lpit_driver.h"
 
 /**************************************************************************************************/
 /* Global Definitions Section                                                                     */
 /**************************************************************************************************/
 
+/* ID bits of the acceptance filters */
+#define CAN_IF_STD_ID_MASK                  (0x000007FFUL)
+#define CAN_IF_EXT_ID_MASK                  (0x1FFFFFFFUL)
+
+/* Extended ID flag in the configured Rx ID keys */
+#define CAN_IF_EXT_ID_KEY                   (0x80000000UL)
+
+/* Tx mailbox key of a mailbox with no known ID programmed, matches no frame */
+#define CAN_IF_TX_NO_KEY                    (0xFFFFFFFFUL)
+
+/* Rx routing hash : empty slot, multipliers tried at init (odd multiples of the golden ratio) */
+#define CAN_IF_RX_ROUTE_EMPTY               (0xFFU)
+#define CAN_IF_RX_ROUTE_SEEDS               (32U)
+#define CAN_IF_RX_ROUTE_MULT                (0x9E3779B1UL)
+
+#if (((1UL << CAN_IF_RX_ROUTE_BITS) < (2UL * CAN_IF_RX_FILTER_MAX)) || \
+     (CAN_IF_RX_FILTER_MAX >= CAN_IF_RX_ROUTE_EMPTY))
+#error "CAN_IF_RX_ROUTE_BITS too small for CAN_IF_RX_FILTER_MAX"
+#endif
+
+#if (CAN_IF_GATEWAY == 1U)
+#if (CAN_IF_TX_PRIO_QUEUE != 1U)
+#error "CAN_IF_GATEWAY needs CAN_IF_TX_PRIO_QUEUE"
+#endif
+#if (CAN_IF_GW_ROUTE_MAX > 32U)
+#error "CAN_IF_GW_ROUTE_MAX above the 32 candidate route bits of an Rx route"
+#endif
+#endif
+
+/* Magnitude of a signed bit rate error */
+#define CAN_IF_ABS(x)                       ((INT32U)(((x) < 0) ? -(x) : (x)))
+
+/* LPIT instance of the cyclic Tx scheduler tick */
+#define CAN_IF_LPIT_INSTANCE                (0U)
+
+/* Length of a frame in bits (standard ID, stuff bits left out), its weight in the offset choice */
+#define CAN_IF_CYCLIC_FRAME_BITS(len)       (47UL + (8UL * (INT32U)(len)))
+
 /**************************************************************************************************/
 /* Global Variables Section                                                                       */
 /**************************************************************************************************/
@@ -32,105 +72,3269 @@ void (* fp_gIsoTpRxHandler)(void * p_fRxData);
 void (* fp_gComTxConformation)(INT16U u16_fMsgID);
 void (* fp_gComRxIndication)(INT16U u16_fMsgID, void * p_fRxData);
 
+/* Payload source of the cyclic Tx entries */
+INT8U (* fp_gComTriggerTransmit)(INT16U u16_fPduHandle, INT8U * p_fData);
+
 
 /* Set information about the data to be sent */
 flexcan_data_info_t g_dataInfo_rx;
-flexcan_msgbuff_t recvBuff;
 
+/* Channel the ISO TP request and response IDs belong to */
+static INT8U u8_gIsoTpChannel = CAN_IF_CHANNEL_0;
+
+/* CAN IF ticks since CAN_IF_Init, written by the LPIT0 ISR */
+static volatile INT32U u32_gTickCount = 0U;
+
+/* Runtime context of the configured channels only. The context of a FlexCAN instance is */
+/* assigned by CAN_IF_Init : u8_gaChannelCtx holds its index plus one, 0 for no context   */
+static ST_CAN_IF_CHANNEL_t st_gaChannel[CAN_IF_CHANNEL_CTX_NUM];
+static INT8U u8_gaChannelCtx[CAN_IF_CHANNEL_NUM];
+
+#if (CAN_IF_GATEWAY == 1U)
+/* Runtime state of each gateway route, index of st_gaGwRouteConfig */
+static ST_CAN_IF_GW_ROUTE_t st_gaGwRoute[CAN_IF_GW_ROUTE_NUM];
+
+/* Forwarding allowed, set by CAN_IF_Init once every channel of the routes is initialized */
+static BOOLEAN b_gGwEnabled = 0U;
+#endif
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_RxIdKeyFind                                                           */
+/*                                                                                                */
+/* Description     : Binary search of a key in the sorted configured Rx IDs                       */
+/*                                                                                                */
+/* In Params       : const ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                           */
+/*                   INT32U u32_fKey : CAN ID, bit 31 set for an extended ID                      */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : BOOLEAN : 1 if the ID is configured                                          */
+/**************************************************************************************************/
+
+static BOOLEAN CAN_IF_RxIdKeyFind(const ST_CAN_IF_CHANNEL_t * p_stfChannel, INT32U u32_fKey)
+{
+    BOOLEAN b_lFound = 0U;
+    INT32U u32_lLow = 0U;
+    INT32U u32_lHigh = p_stfChannel->u32_mRxIdKeyCount;
+    INT32U u32_lMid;
+    
+    while((u32_lLow < u32_lHigh) && (0U == b_lFound))
+    {
+        u32_lMid = (u32_lLow + u32_lHigh) >> 1U;
+        if(p_stfChannel->u32_maRxIdKey[u32_lMid] == u32_fKey)
+        {
+            b_lFound = 1U;
+        }
+        else if(p_stfChannel->u32_maRxIdKey[u32_lMid] < u32_fKey)
+        {
+            u32_lLow = u32_lMid + 1U;
+        }
+        else
+        {
+            u32_lHigh = u32_lMid;
+        }
+    }
+    
+    return b_lFound;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_RxRouteSlot                                                           */
+/*                                                                                                */
+/* Description     : Home slot of a key in the Rx routing hash table (multiplicative hash)        */
+/*                                                                                                */
+/* In Params       : INT32U u32_fKey : CAN ID, bit 31 set for an extended ID                      */
+/*                   INT32U u32_fMult : Odd multiplier chosen for the channel                     */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT32U : Slot index                                                          */
+/**************************************************************************************************/
+
+static INT32U CAN_IF_RxRouteSlot(INT32U u32_fKey, INT32U u32_fMult)
+{
+    return ((u32_fKey ^ (u32_fKey >> 15U)) * u32_fMult) >> (32U - CAN_IF_RX_ROUTE_BITS);
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_RxRouteFind                                                           */
+/*                                                                                                */
+/* Description     : Routing of a received ID : hash table of the configured IDs, at most the     */
+/*                   probes counted at init, then the masked entries. An unknown ID costs the     */
+/*                   same bounded time                                                            */
+/*                                                                                                */
+/* In Params       : const ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                           */
+/*                   INT32U u32_fKey : CAN ID, bit 31 set for an extended ID                      */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : const ST_CAN_IF_RX_ROUTE_t * : Routing, PNULL if the ID is not configured    */
+/**************************************************************************************************/
+
+static const ST_CAN_IF_RX_ROUTE_t * CAN_IF_RxRouteFind(const ST_CAN_IF_CHANNEL_t * p_stfChannel, \
+                                                                                INT32U u32_fKey)
+{
+    const ST_CAN_IF_RX_ROUTE_t * p_stlRoute = PNULL;
+    const ST_CAN_IF_FILTER_t * p_stlRange;
+    INT32U u32_lSlot = CAN_IF_RxRouteSlot(u32_fKey, p_stfChannel->u32_mRxRouteMult);
+    INT32U u32_lIndex;
+    INT8U u8_lRoute;
+    
+    for(u32_lIndex = 0U; u32_lIndex < p_stfChannel->u32_mRxRouteProbes; u32_lIndex++)
+    {
+        u8_lRoute = p_stfChannel->u8_maRxRouteSlot[u32_lSlot];
+        if(CAN_IF_RX_ROUTE_EMPTY == u8_lRoute)
+        {
+            break;
+        }
+        if(p_stfChannel->st_maRxRoute[u8_lRoute].u32_mKey == u32_fKey)
+        {
+            p_stlRoute = &p_stfChannel->st_maRxRoute[u8_lRoute];
+            break;
+        }
+        u32_lSlot = (u32_lSlot + 1U) & ((1UL << CAN_IF_RX_ROUTE_BITS) - 1U);
+    }
+    
+    for(u32_lIndex = 0U; (u32_lIndex < p_stfChannel->u32_mRxRangeCount) && \
+                         (PNULL == p_stlRoute); u32_lIndex++)
+    {
+        p_stlRange = &p_stfChannel->st_maRxRange[u32_lIndex];
+        if((((u32_fKey & CAN_IF_EXT_ID_KEY) != 0U) == (0U != p_stlRange->b_mExtended)) && \
+           ((u32_fKey & p_stlRange->u32_mMask) == p_stlRange->u32_mValue))
+        {
+            p_stlRoute = &p_stfChannel->st_maRxRangeRoute[u32_lIndex];
+        }
+    }
+    
+    return p_stlRoute;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_DispatchRxPdu                                                         */
+/*                                                                                                */
+/* Description     : Routes a received frame to ISO TP or OSEK COM with its PDU handle, the       */
+/*                   payload is not copied                                                        */
+/*                                                                                                */
+/* In Params       : const ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                           */
+/*                   const flexcan_rx_frame_t * p_stfFrame : Frame in its driver slot             */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void CAN_IF_DispatchRxPdu(const ST_CAN_IF_CHANNEL_t * p_stfChannel, \
+                                                            const flexcan_rx_frame_t * p_stfFrame)
+{
+    ST_RX_PDU_t st_lRxMsg;
+    const ST_CAN_IF_RX_ROUTE_t * p_stlRoute;
+    INT32U u32_lKey = p_stfFrame->msgId | \
+                        (((p_stfFrame->cs & CAN_CS_IDE_MASK) != 0U) ? CAN_IF_EXT_ID_KEY : 0U);
+    
+    st_lRxMsg.u8_mChannel = p_stfChannel->u8_mInstance;
+    st_lRxMsg.u32_mArbitrationID = p_stfFrame->msgId;
+    st_lRxMsg.p_mDataBuff = (const INT8U *)&p_stfFrame->data[0];
+    st_lRxMsg.u8_mDataSize = p_stfFrame->length;
+    st_lRxMsg.u32_mTimeStamp = p_stfFrame->timeStamp;
+    st_lRxMsg.b_mFdFrame = ((p_stfFrame->cs & CAN_MB_EDL_MASK) != 0U) ? 1U : 0U;
+    st_lRxMsg.b_mBrs = ((p_stfFrame->cs & CAN_MB_BRS_MASK) != 0U) ? 1U : 0U;
+    
+    p_stlRoute = CAN_IF_RxRouteFind(p_stfChannel, u32_lKey);
+    if(PNULL == p_stlRoute)
+    {
+        /* Accepted by an inexact hardware filter but not configured : dropped */
+    }
+    else if(CAN_IF_RX_HANDLER_NONE == p_stlRoute->u8_mHandler)
+    {
+        /* Gateway only ID, already forwarded */
+    }
+    else if(CAN_IF_RX_HANDLER_ISOTP == p_stlRoute->u8_mHandler)
+    {   
+        /* Call Back to ISO TP callback */
+        st_lRxMsg.u16_mPduHandle = p_stlRoute->u16_mPduHandle;
+        if(PNULL != fp_gIsoTpRxHandler)
+        {
+            fp_gIsoTpRxHandler(&st_lRxMsg);
+        }
+        else
+        {
+            /* No Action */
+        }
+    }
+    else
+    {
+        /* Send the Data to OSEK COM */
+        st_lRxMsg.u16_mPduHandle = p_stlRoute->u16_mPduHandle;
+        if(PNULL != fp_gComRxIndication)
+        {
+            fp_gComRxIndication((INT16U)st_lRxMsg.u32_mArbitrationID, &st_lRxMsg);
+        }
+        else
+        {
+            /* No Action */
+        }
+    }  
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_GetTxDataInfo                                                         */
+/*                                                                                                */
+/* Description     : Frame format of a Tx PDU : ID type, FD, BRS and padding come from the Tx     */
+/*                   entry of the configuration table, an unconfigured ID goes out as a standard  */
+/*                   ID, as FD only if it needs to                                                */
+/*                                                                                                */
+/* In Params       : const ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                           */
+/*                   INT32U u32_fCANID : Transmit Message ID                                      */
+/*                   INT8U u8_fLength : Payload size in bytes                                     */
+/*                                                                                                */
+/* Out Params      : flexcan_data_info_t * p_stfDataInfo : Frame format                           */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if the payload does not fit the    */
+/*                   frame format or the controller                                               */
+/**************************************************************************************************/
+
+static EN_CAN_IF_RESULT_t CAN_IF_GetTxDataInfo(const ST_CAN_IF_CHANNEL_t * p_stfChannel, \
+                        INT32U u32_fCANID, INT8U u8_fLength, flexcan_data_info_t * p_stfDataInfo)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    const ST_MAILBOX_CONFIG_t * p_stlConfig = &st_gMailBoxConfig[0];
+    
+    p_stfDataInfo->data_length = u8_fLength;
+    p_stfDataInfo->msg_id_type = FLEXCAN_MSG_ID_STD;
+    p_stfDataInfo->fd_enable = (u8_fLength > 8U) ? 1U : 0U;
+    p_stfDataInfo->enable_brs = 0U;
+    p_stfDataInfo->fd_padding = 0U;
+    
+    while(1)
+    {
+        if((EN_MAILBOX_TRANSMIT == p_stlConfig->en_mMailBoxDirection) && \
+           (CAN_DATA_FRAME == p_stlConfig->en_mFrameType) && \
+           (p_stfChannel->u8_mInstance == p_stlConfig->u8_mCanNode) && \
+           (u32_fCANID == p_stlConfig->u32_mMsgID))
+        {
+            p_stfDataInfo->msg_id_type = (EN_FLEXCAN_MSG_ID_EXT == \
+                                          p_stlConfig->st_mFlexCanDataInfo.en_mMsgIdType) ? \
+                                                        FLEXCAN_MSG_ID_EXT : FLEXCAN_MSG_ID_STD;
+            p_stfDataInfo->fd_enable = (p_stlConfig->st_mFlexCanDataInfo.u8_mFdEnable != 0U) ? 1U : 0U;
+            p_stfDataInfo->enable_brs = (p_stlConfig->st_mFlexCanDataInfo.u8_mEnableBrs != 0U) ? 1U : 0U;
+            p_stfDataInfo->fd_padding = p_stlConfig->st_mFlexCanDataInfo.u8_mFdPadding;
+            break;
+        }
+        
+        if(p_stlConfig->u8_EOL)
+        {
+            break;
+        }
+        p_stlConfig++;
+    }
+    
+    /* BRS only exists in the FD frame format, FD frames need an FD controller */
+    if(0U == p_stfDataInfo->fd_enable)
+    {
+        p_stfDataInfo->enable_brs = 0U;
+    }
+    
+    if((u8_fLength > CAN_IF_MAX_PAYLOAD) || \
+       ((0U == p_stfDataInfo->fd_enable) && (u8_fLength > 8U)) || \
+       ((0U != p_stfDataInfo->fd_enable) && \
+        (!p_stfChannel->p_mConfig->p_mUserConfig->fd_enable)))
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    else
+    {
+        /* No Action */
+    }
+    
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_ConfirmTxPdu                                                          */
+/*                                                                                                */
+/* Description     : Reports a transmitted frame to ISO TP or OSEK COM                            */
+/*                                                                                                */
+/* In Params       : const ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                           */
+/*                   INT32U u32_fCANID : Transmitted Message ID                                   */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void CAN_IF_ConfirmTxPdu(const ST_CAN_IF_CHANNEL_t * p_stfChannel, INT32U u32_fCANID)
+{
+    /* Check if the Mag trasmitted Belong to ISOTP or COM */
+    if((u32_fCANID == u16_gUdsRespID) && (p_stfChannel->u8_mInstance == u8_gIsoTpChannel))
+    {
+        /* Call back to ISO TP Layers */
+        if(PNULL != fp_gIsoTpTxHandler)
+        {
+            fp_gIsoTpTxHandler((INT16U)u32_fCANID);
+        }
+        else
+        {
+            /* No Action */
+        }
+    }
+    else
+    {
+        /* Update to OSEK COM */
+        if(PNULL != fp_gComTxConformation)
+        {
+            fp_gComTxConformation((INT16U)u32_fCANID);
+        }
+        else
+        {
+            /* No Action */
+        }
+    }
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_TxSendMailBox                                                         */
+/*                                                                                                */
+/* Description     : Sends a frame from a Tx mailbox. A mailbox already holding the ID and frame  */
+/*                   format of the frame only gets its payload and C/S word written, else the     */
+/*                   whole mailbox is written and its new ID and format are kept.                 */
+/*                   Called from the FlexCAN ISR or with the interrupts disabled.                 */
+/*                                                                                                */
+/* In Params       : const ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                           */
+/*                   ST_CAN_IF_TX_MB_t * p_stfMailBox : Tx mailbox                                */
+/*                   INT32U u32_fCANID : Transmit Message ID                                      */
+/*                   flexcan_data_info_t * p_stfDataInfo : Frame format and payload size          */
+/*                   INT8U * p_fData : Payload                                                    */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_OK On success, CAN_IF_BUSY if the        */
+/*                   mailbox still holds a frame                                                  */
+/**************************************************************************************************/
+
+static EN_CAN_IF_RESULT_t CAN_IF_TxSendMailBox(const ST_CAN_IF_CHANNEL_t * p_stfChannel, \
+                    ST_CAN_IF_TX_MB_t * p_stfMailBox, INT32U u32_fCANID, \
+                    flexcan_data_info_t * p_stfDataInfo, INT8U * p_fData)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    flexcan_status_t en_lStatus;
+    INT32U u32_lKey = u32_fCANID | \
+                ((FLEXCAN_MSG_ID_EXT == p_stfDataInfo->msg_id_type) ? CAN_IF_EXT_ID_KEY : 0U);
+    
+    if((u32_lKey == p_stfMailBox->u32_mMbKey) && \
+       (p_stfDataInfo->fd_enable == p_stfMailBox->u8_mMbFdEnable) && \
+       (p_stfDataInfo->enable_brs == p_stfMailBox->u8_mMbEnableBrs) && \
+       (p_stfDataInfo->fd_padding == p_stfMailBox->u8_mMbFdPadding))
+    {
+        en_lStatus = FLEXCAN_DRV_SendPayload(p_stfChannel->u8_mInstance, \
+                    p_stfMailBox->u8_mMailBoxIndex, p_fData, p_stfDataInfo->data_length);
+    }
+    else
+    {
+        en_lStatus = FLEXCAN_DRV_Send(p_stfChannel->u8_mInstance, \
+                    p_stfMailBox->u8_mMailBoxIndex, p_stfDataInfo, u32_fCANID, p_fData);
+        if(FLEXCAN_STATUS_SUCCESS == en_lStatus)
+        {
+            p_stfMailBox->u32_mMbKey = u32_lKey;
+            p_stfMailBox->u8_mMbFdEnable = p_stfDataInfo->fd_enable;
+            p_stfMailBox->u8_mMbEnableBrs = p_stfDataInfo->enable_brs;
+            p_stfMailBox->u8_mMbFdPadding = p_stfDataInfo->fd_padding;
+        }
+        else if(FLEXCAN_STATUS_TX_BUSY != en_lStatus)
+        {
+            /* The mailbox may have been partly written */
+            p_stfMailBox->u32_mMbKey = CAN_IF_TX_NO_KEY;
+        }
+        else
+        {
+            /* No Action */
+        }
+    }
+    
+    if(FLEXCAN_STATUS_SUCCESS == en_lStatus)
+    {
+        /* No Action */
+    }
+    else if(FLEXCAN_STATUS_TX_BUSY == en_lStatus)
+    {
+        en_lResult = CAN_IF_BUSY;
+    }
+    else
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    
+    return en_lResult;
+}
+
+#if (CAN_IF_TX_PRIO_QUEUE == 1U)
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_TxArbitrationKey                                                      */
+/*                                                                                                */
+/* Description     : Arbitration field of a frame as a number, lower value wins the bus : base ID */
+/*                   first, a standard frame before an extended frame of the same base ID, then   */
+/*                   the ID extension                                                             */
+/*                                                                                                */
+/* In Params       : const ST_CAN_IF_TX_PDU_t * p_stfPdu : Frame                                  */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT32U : Arbitration key                                                     */
+/**************************************************************************************************/
+
+static INT32U CAN_IF_TxArbitrationKey(const ST_CAN_IF_TX_PDU_t * p_stfPdu)
+{
+    INT32U u32_lKey;
+    
+    if(0U != p_stfPdu->b_mExtended)
+    {
+        u32_lKey = (((p_stfPdu->u32_mCANID >> 18U) & CAN_IF_STD_ID_MASK) << 19U) | (1UL << 18U) | \
+                                                            (p_stfPdu->u32_mCANID & 0x3FFFFUL);
+    }
+    else
+    {
+        u32_lKey = (p_stfPdu->u32_mCANID & CAN_IF_STD_ID_MASK) << 19U;
+    }
+    
+    return u32_lKey;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_TxPduHasPriority                                                      */
+/*                                                                                                */
+/* Description     : Compares two frames in bus arbitration order, equal IDs in queueing order    */
+/*                                                                                                */
+/* In Params       : const ST_CAN_IF_TX_PDU_t * p_stfPduA : First frame                           */
+/*                   const ST_CAN_IF_TX_PDU_t * p_stfPduB : Second frame                          */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : BOOLEAN : 1 if p_stfPduA has to be sent before p_stfPduB                     */
+/**************************************************************************************************/
+
+static BOOLEAN CAN_IF_TxPduHasPriority(const ST_CAN_IF_TX_PDU_t * p_stfPduA, \
+                                                        const ST_CAN_IF_TX_PDU_t * p_stfPduB)
+{
+    BOOLEAN b_lResult;
+    INT32U u32_lKeyA = CAN_IF_TxArbitrationKey(p_stfPduA);
+    INT32U u32_lKeyB = CAN_IF_TxArbitrationKey(p_stfPduB);
+    
+    if(u32_lKeyA != u32_lKeyB)
+    {
+        b_lResult = (u32_lKeyA < u32_lKeyB) ? 1U : 0U;
+    }
+    else
+    {
+        /* Wrap safe sequence comparison */
+        b_lResult = ((INT32S)(p_stfPduA->u32_mSeqNo - p_stfPduB->u32_mSeqNo) < 0) ? 1U : 0U;
+    }
+    
+    return b_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_TxHeapPush                                                            */
+/*                                                                                                */
+/* Description     : Inserts a frame into the Tx priority queue (sift up)                        */
+/*                                                                                                */
+/* In Params       : ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                                 */
+/*                   const ST_CAN_IF_TX_PDU_t * p_stfPdu : Frame to queue                         */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if the queue is full               */
+/**************************************************************************************************/
+
+static EN_CAN_IF_RESULT_t CAN_IF_TxHeapPush(ST_CAN_IF_CHANNEL_t * p_stfChannel, \
+                                                                const ST_CAN_IF_TX_PDU_t * p_stfPdu)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    ST_CAN_IF_TX_PDU_t * p_stlHeap = &p_stfChannel->st_maTxHeap[0];
+    INT32U u32_lChild = p_stfChannel->u32_mTxHeapCount;
+    INT32U u32_lParent;
+    
+    if(p_stfChannel->u32_mTxHeapCount >= \
+                        (sizeof(p_stfChannel->st_maTxHeap) / sizeof(p_stfChannel->st_maTxHeap[0])))
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    else
+    {
+        /* Move the parents down until the frame slot is found */
+        while(u32_lChild > 0U)
+        {
+            u32_lParent = (u32_lChild - 1U) >> 1U;
+            if(CAN_IF_TxPduHasPriority(p_stfPdu, &p_stlHeap[u32_lParent]))
+            {
+                p_stlHeap[u32_lChild] = p_stlHeap[u32_lParent];
+                u32_lChild = u32_lParent;
+            }
+            else
+            {
+                break;
+            }
+        }
+        p_stlHeap[u32_lChild] = *p_stfPdu;
+        p_stfChannel->u32_mTxHeapCount++;
+    }
+    
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_TxHeapPop                                                             */
+/*                                                                                                */
+/* Description     : Removes the highest priority frame of the Tx queue (sift down)               */
+/*                   The queue must not be empty.                                                 */
+/*                                                                                                */
+/* In Params       : ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                                 */
+/*                                                                                                */
+/* Out Params      : ST_CAN_IF_TX_PDU_t * p_stfPdu : Removed frame                                */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void CAN_IF_TxHeapPop(ST_CAN_IF_CHANNEL_t * p_stfChannel, ST_CAN_IF_TX_PDU_t * p_stfPdu)
+{
+    ST_CAN_IF_TX_PDU_t * p_stlHeap = &p_stfChannel->st_maTxHeap[0];
+    INT32U u32_lParent = 0;
+    INT32U u32_lChild;
+    ST_CAN_IF_TX_PDU_t * p_stlLast;
+    
+    *p_stfPdu = p_stlHeap[0];
+    p_stfChannel->u32_mTxHeapCount--;
+    p_stlLast = &p_stlHeap[p_stfChannel->u32_mTxHeapCount];
+    
+    /* Move the last frame down from the root */
+    u32_lChild = 1U;
+    while(u32_lChild < p_stfChannel->u32_mTxHeapCount)
+    {
+        if(((u32_lChild + 1U) < p_stfChannel->u32_mTxHeapCount) && \
+            CAN_IF_TxPduHasPriority(&p_stlHeap[u32_lChild + 1U], &p_stlHeap[u32_lChild]))
+        {
+            u32_lChild++;
+        }
+        
+        if(CAN_IF_TxPduHasPriority(&p_stlHeap[u32_lChild], p_stlLast))
+        {
+            p_stlHeap[u32_lParent] = p_stlHeap[u32_lChild];
+            u32_lParent = u32_lChild;
+            u32_lChild = (u32_lParent << 1U) + 1U;
+        }
+        else
+        {
+            break;
+        }
+    }
+    p_stlHeap[u32_lParent] = *p_stlLast;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_TxStartMailBox                                                        */
+/*                                                                                                */
+/* Description     : Hands the frame of a Tx mailbox to the FlexCAN driver                        */
+/*                                                                                                */
+/* In Params       : const ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                           */
+/*                   ST_CAN_IF_TX_MB_t * p_stfMailBox : Free mailbox holding the frame            */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_OK On success, else see                  */
+/*                   CAN_IF_TxSendMailBox()                                                       */
+/**************************************************************************************************/
+
+static EN_CAN_IF_RESULT_t CAN_IF_TxStartMailBox(const ST_CAN_IF_CHANNEL_t * p_stfChannel, \
+                                                                ST_CAN_IF_TX_MB_t * p_stfMailBox)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    flexcan_data_info_t st_lDataInfo;
+    
+    st_lDataInfo.data_length = p_stfMailBox->st_mPdu.u8_mDLC;
+    st_lDataInfo.msg_id_type = (0U != p_stfMailBox->st_mPdu.b_mExtended) ? \
+                                                        FLEXCAN_MSG_ID_EXT : FLEXCAN_MSG_ID_STD;
+    st_lDataInfo.enable_brs = p_stfMailBox->st_mPdu.u8_mEnableBrs;
+    st_lDataInfo.fd_enable = p_stfMailBox->st_mPdu.u8_mFdEnable;
+    st_lDataInfo.fd_padding = p_stfMailBox->st_mPdu.u8_mFdPadding;
+    
+    p_stfMailBox->b_mBusy = 1U;
+    p_stfMailBox->b_mAbortPending = 0U;
+    
+    en_lResult = CAN_IF_TxSendMailBox(p_stfChannel, p_stfMailBox, \
+                                        p_stfMailBox->st_mPdu.u32_mCANID, &st_lDataInfo, \
+                                        &p_stfMailBox->st_mPdu.u8_maData[0]);
+    if(CAN_IF_OK != en_lResult)
+    {
+        p_stfMailBox->b_mBusy = 0U;
+    }
+    else
+    {
+        /* No Action */
+    }
+    
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_TxSchedule                                                            */
+/*                                                                                                */
+/* Description     : Moves the queued frames into the free Tx mailboxes, lowest ID first. A free  */
+/*                   mailbox already holding the ID of the frame is preferred, the frame then     */
+/*                   only writes its payload. When every mailbox holds a lower priority frame     */
+/*                   than the head of the queue, the lowest priority one is aborted and requeued  */
+/*                   from its confirmation.                                                       */
+/*                   Called from the FlexCAN ISR or with the interrupts disabled.                 */
+/*                                                                                                */
+/* In Params       : ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                                 */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void CAN_IF_TxSchedule(ST_CAN_IF_CHANNEL_t * p_stfChannel)
+{
+    ST_CAN_IF_TX_MB_t * p_stlMailBox;
+    ST_CAN_IF_TX_MB_t * p_stlFree;
+    ST_CAN_IF_TX_MB_t * p_stlHome;
+    ST_CAN_IF_TX_MB_t * p_stlVictim;
+    BOOLEAN b_lAnyFree;
+    BOOLEAN b_lAbortPending;
+    INT32U u32_lHeadKey;
+    INT8U u8_lIndex;
+    
+    while(p_stfChannel->u32_mTxHeapCount != 0U)
+    {
+        u32_lHeadKey = p_stfChannel->st_maTxHeap[0].u32_mCANID | \
+                    ((0U != p_stfChannel->st_maTxHeap[0].b_mExtended) ? CAN_IF_EXT_ID_KEY : 0U);
+        p_stlFree = PNULL;
+        p_stlHome = PNULL;
+        p_stlVictim = PNULL;
+        b_lAnyFree = 0U;
+        b_lAbortPending = 0U;
+        
+        for(u8_lIndex = 0; u8_lIndex < p_stfChannel->u8_mTxMailBoxCount; u8_lIndex++)
+        {
+            p_stlMailBox = &p_stfChannel->st_maTxMailBox[u8_lIndex];
+            
+            if(p_stlMailBox->b_mBusy)
+            {
+                /* FlexCAN sends the lowest MB first between equal IDs : a frame may only  */
+                /* use a mailbox above the ones still holding a frame with the same ID    */
+                if(p_stlMailBox->st_mPdu.u32_mCANID == p_stfChannel->st_maTxHeap[0].u32_mCANID)
+                {
+                    p_stlFree = PNULL;
+                    p_stlHome = PNULL;
+                }
+                else
+                {
+                    /* No Action */
+                }
+                
+                if(p_stlMailBox->b_mAbortPending)
+                {
+                    b_lAbortPending = 1U;
+                }
+                else if((PNULL == p_stlVictim) || \
+                    CAN_IF_TxPduHasPriority(&p_stlVictim->st_mPdu, &p_stlMailBox->st_mPdu))
+                {
+                    p_stlVictim = p_stlMailBox;
+                }
+                else
+                {
+                    /* No Action */
+                }
+            }
+            else
+            {
+                b_lAnyFree = 1U;
+                if(PNULL == p_stlFree)
+                {
+                    p_stlFree = p_stlMailBox;
+                }
+                else
+                {
+                    /* No Action */
+                }
+                
+                if((PNULL == p_stlHome) && (u32_lHeadKey == p_stlMailBox->u32_mMbKey))
+                {
+                    p_stlHome = p_stlMailBox;
+                }
+                else
+                {
+                    /* No Action */
+                }
+            }
+        }
+        
+        if(PNULL != p_stlHome)
+        {
+            p_stlFree = p_stlHome;
+        }
+        else
+        {
+            /* No Action */
+        }
+        
+        if(PNULL != p_stlFree)
+        {
+            CAN_IF_TxHeapPop(p_stfChannel, &p_stlFree->st_mPdu);
+            if(CAN_IF_OK != CAN_IF_TxStartMailBox(p_stfChannel, p_stlFree))
+            {
+                /* Keep the frame, it is retried on the next scheduling */
+                (void)CAN_IF_TxHeapPush(p_stfChannel, &p_stlFree->st_mPdu);
+                break;
+            }
+            else
+            {
+                /* No Action */
+            }
+        }
+        else
+        {
+            /* All mailboxes busy : make room for the head of the queue if it beats a frame */
+            /* in a mailbox. One abort at a time, the frame is requeued on confirmation.    */
+            if((0U == b_lAnyFree) && (0U == b_lAbortPending) && (PNULL != p_stlVictim) && \
+                CAN_IF_TxPduHasPriority(&p_stfChannel->st_maTxHeap[0], &p_stlVictim->st_mPdu))
+            {
+                if(FLEXCAN_STATUS_SUCCESS == \
+                    FLEXCAN_DRV_AbortSendingData(p_stfChannel->u8_mInstance, \
+                                                 p_stlVictim->u8_mMailBoxIndex))
+                {
+                    p_stlVictim->b_mAbortPending = 1U;
+                }
+                else
+                {
+                    /* No Action */
+                }
+            }
+            else
+            {
+                /* No Action */
+            }
+            break;
+        }
+    }
+}
+#endif
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_TxInitMailBoxes                                                       */
+/*                                                                                                */
+/* Description     : Collects the Tx mailboxes of the configuration table, sorted by MB index,    */
+/*                   and programs them once with the ID and frame format of their entry           */
+/*                                                                                                */
+/* In Params       : ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                                 */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if a mailbox could not be          */
+/*                   programmed, or if no Tx mailbox is configured for the Tx scheduler           */
+/**************************************************************************************************/
+
+static EN_CAN_IF_RESULT_t CAN_IF_TxInitMailBoxes(ST_CAN_IF_CHANNEL_t * p_stfChannel)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    const ST_MAILBOX_CONFIG_t * p_stlConfig = &st_gMailBoxConfig[0];
+    ST_CAN_IF_TX_MB_t * p_stlMailBox = &p_stfChannel->st_maTxMailBox[0];
+    flexcan_data_info_t st_lDataInfo;
+    INT8U u8_lIndex;
+    
+    p_stfChannel->u8_mTxMailBoxCount = 0;
+#if (CAN_IF_TX_PRIO_QUEUE == 1U)
+    p_stfChannel->u32_mTxHeapCount = 0;
+#endif
+    
+    while(1)
+    {
+        if((EN_MAILBOX_TRANSMIT == p_stlConfig->en_mMailBoxDirection) && \
+           (CAN_DATA_FRAME == p_stlConfig->en_mFrameType) && \
+           (p_stfChannel->u8_mInstance == p_stlConfig->u8_mCanNode) && \
+           (p_stfChannel->u8_mTxMailBoxCount < CAN_IF_TX_MB_MAX))
+        {
+            /* Insertion sort on the MB index */
+            u8_lIndex = p_stfChannel->u8_mTxMailBoxCount;
+            while((u8_lIndex > 0U) && \
+                  (p_stlMailBox[u8_lIndex - 1U].u8_mMailBoxIndex > p_stlConfig->u8_mMailBoxIndex))
+            {
+                p_stlMailBox[u8_lIndex] = p_stlMailBox[u8_lIndex - 1U];
+                u8_lIndex--;
+            }
+            p_stlMailBox[u8_lIndex].u8_mMailBoxIndex = p_stlConfig->u8_mMailBoxIndex;
+            p_stlMailBox[u8_lIndex].b_mBusy = 0U;
+            p_stlMailBox[u8_lIndex].b_mAbortPending = 0U;
+            p_stlMailBox[u8_lIndex].u32_mMbKey = CAN_IF_TX_NO_KEY;
+            p_stfChannel->u8_mTxMailBoxCount++;
+            
+            /* Inactive Tx MB holding the ID and format of its entry : the frames of the entry  */
+            /* only write their payload, the Rx filters keep off it                             */
+            if(CAN_IF_OK != CAN_IF_GetTxDataInfo(p_stfChannel, p_stlConfig->u32_mMsgID, \
+                        p_stlConfig->st_mFlexCanDataInfo.u8_mDataLength, &st_lDataInfo))
+            {
+                en_lResult = CAN_IF_ERROR;
+            }
+            else if(FLEXCAN_STATUS_SUCCESS != FLEXCAN_DRV_ConfigTxMb(p_stfChannel->u8_mInstance, \
+                        p_stlConfig->u8_mMailBoxIndex, &st_lDataInfo, p_stlConfig->u32_mMsgID))
+            {
+                en_lResult = CAN_IF_ERROR;
+            }
+            else
+            {
+                p_stlMailBox[u8_lIndex].u32_mMbKey = p_stlConfig->u32_mMsgID | \
+                    ((FLEXCAN_MSG_ID_EXT == st_lDataInfo.msg_id_type) ? CAN_IF_EXT_ID_KEY : 0U);
+                p_stlMailBox[u8_lIndex].u8_mMbFdEnable = st_lDataInfo.fd_enable;
+                p_stlMailBox[u8_lIndex].u8_mMbEnableBrs = st_lDataInfo.enable_brs;
+                p_stlMailBox[u8_lIndex].u8_mMbFdPadding = st_lDataInfo.fd_padding;
+            }
+        }
+        else
+        {
+            /* No Action */
+        }
+        
+        if(p_stlConfig->u8_EOL)
+        {
+            break;
+        }
+        p_stlConfig++;
+    }
+    
+#if (CAN_IF_TX_PRIO_QUEUE == 1U)
+    if(0U == p_stfChannel->u8_mTxMailBoxCount)
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    else
+    {
+        /* No Action */
+    }
+#endif
+    
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_GetChannel                                                            */
+/*                                                                                                */
+/* Description     : Runtime context of an initialized channel                                    */
+/*                                                                                                */
+/* In Params       : INT8U u8_fChannel : Channel (FlexCAN instance)                               */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : ST_CAN_IF_CHANNEL_t * : Channel context, PNULL if the channel is not used    */
+/**************************************************************************************************/
+
+static ST_CAN_IF_CHANNEL_t * CAN_IF_GetChannel(INT8U u8_fChannel)
+{
+    ST_CAN_IF_CHANNEL_t * p_stlChannel = PNULL;
+    
+    if((u8_fChannel < CAN_IF_CHANNEL_NUM) && (0U != u8_gaChannelCtx[u8_fChannel]) && \
+       (PNULL != st_gaChannel[u8_gaChannelCtx[u8_fChannel] - 1U].p_mConfig))
+    {
+        p_stlChannel = &st_gaChannel[u8_gaChannelCtx[u8_fChannel] - 1U];
+    }
+    else
+    {
+        /* No Action */
+    }
+    
+    return p_stlChannel;
+}
+
+#if (CAN_IF_GATEWAY == 1U)
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_GwForward                                                             */
+/*                                                                                                */
+/* Description     : Forwards a received frame on a gateway route : remote frames are dropped,    */
+/*                   the rate limit is checked on the reception time stamp, then the frame is     */
+/*                   queued straight from its driver slot in the Tx queue of each destination     */
+/*                   channel, with its rewritten ID. Called from the FlexCAN ISR of the source    */
+/*                   channel.                                                                     */
+/*                                                                                                */
+/* In Params       : const ST_CAN_IF_CHANNEL_t * p_stfChannel : Source channel                    */
+/*                   ST_CAN_IF_GW_ROUTE_t * p_stfRoute : Gateway route                            */
+/*                   const flexcan_rx_frame_t * p_stfFrame : Frame in its driver slot             */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void CAN_IF_GwForward(const ST_CAN_IF_CHANNEL_t * p_stfChannel, \
+                    ST_CAN_IF_GW_ROUTE_t * p_stfRoute, const flexcan_rx_frame_t * p_stfFrame)
+{
+    ST_CAN_IF_CHANNEL_t * p_stlDst;
+    ST_CAN_IF_TX_PDU_t st_lPdu;
+    BOOLEAN b_lQueued = 0U;
+    INT32U u32_lLatency;
+    INT8U u8_lChannel;
+    
+    if((p_stfFrame->cs & CAN_CS_RTR_MASK) != 0U)
+    {
+        /* The Tx path only sends data frames, a remote frame would go out as a data one */
+        p_stfRoute->st_mStats.u32_mRemoteDropCount++;
+    }
+    else if((0U != p_stfRoute->b_mForwarded) && \
+       ((p_stfFrame->timeStamp - p_stfRoute->u32_mLastForward) < p_stfRoute->u32_mMinInterval))
+    {
+        p_stfRoute->st_mStats.u32_mRateDropCount++;
+    }
+    else
+    {
+        st_lPdu.u32_mCANID = (p_stfFrame->msgId & ~p_stfRoute->u32_mDstMask) | \
+                                                                        p_stfRoute->u32_mDstID;
+        st_lPdu.b_mExtended = ((p_stfFrame->cs & CAN_CS_IDE_MASK) != 0U) ? 1U : 0U;
+        st_lPdu.u8_mDLC = p_stfFrame->length;
+        st_lPdu.u8_mFdEnable = ((p_stfFrame->cs & CAN_MB_EDL_MASK) != 0U) ? 1U : 0U;
+        st_lPdu.u8_mEnableBrs = ((p_stfFrame->cs & CAN_MB_BRS_MASK) != 0U) ? 1U : 0U;
+        st_lPdu.u8_mFdPadding = 0U;
+        st_lPdu.b_mGateway = 1U;
+        memcpy((void *)&st_lPdu.u8_maData[0], (const void *)&p_stfFrame->data[0], \
+                                                                        p_stfFrame->length);
+        
+        for(u8_lChannel = 0; u8_lChannel < CAN_IF_CHANNEL_NUM; u8_lChannel++)
+        {
+            if(0U == (p_stfRoute->u8_mDstChannels & (1U << u8_lChannel)))
+            {
+                continue;
+            }
+            
+            p_stlDst = CAN_IF_GetChannel(u8_lChannel);
+            if((PNULL == p_stlDst) || ((0U != st_lPdu.u8_mFdEnable) && \
+                                       (!p_stlDst->p_mConfig->p_mUserConfig->fd_enable)))
+            {
+                /* Channel gone, or FD frame towards a classic CAN controller */
+                p_stfRoute->st_mStats.u32_mTxDropCount++;
+                continue;
+            }
+            
+            /* The destination FlexCAN ISR may preempt the source one */
+            INT_SYS_DisableIRQGlobal();
+            if(p_stlDst->u32_mTxHeapCount >= CAN_IF_TX_QUEUE_SIZE)
+            {
+                p_stfRoute->st_mStats.u32_mTxDropCount++;
+            }
+            else
+            {
+                st_lPdu.u32_mSeqNo = p_stlDst->u32_mTxSeqNo++;
+                (void)CAN_IF_TxHeapPush(p_stlDst, &st_lPdu);
+                CAN_IF_TxSchedule(p_stlDst);
+                b_lQueued = 1U;
+            }
+            INT_SYS_EnableIRQGlobal();
+        }
+        
+        if(0U != b_lQueued)
+        {
+            p_stfRoute->u32_mLastForward = p_stfFrame->timeStamp;
+            p_stfRoute->b_mForwarded = 1U;
+            
+            u32_lLatency = FLEXCAN_DRV_GetTime(p_stfChannel->u8_mInstance) - p_stfFrame->timeStamp;
+            p_stfRoute->st_mStats.u32_mForwardCount++;
+            p_stfRoute->st_mStats.u32_mLatencyLast = u32_lLatency;
+            p_stfRoute->st_mStats.u32_mLatencySum += u32_lLatency;
+            if(u32_lLatency > p_stfRoute->st_mStats.u32_mLatencyMax)
+            {
+                p_stfRoute->st_mStats.u32_mLatencyMax = u32_lLatency;
+            }
+        }
+    }
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_GwRxFrame                                                             */
+/*                                                                                                */
+/* Description     : Gateway routes of a received frame : the candidate routes are kept with the  */
+/*                   Rx routing of its ID, the frame is forwarded on each one it matches.         */
+/*                   Called from the FlexCAN ISR of the source channel.                           */
+/*                                                                                                */
+/* In Params       : const ST_CAN_IF_CHANNEL_t * p_stfChannel : Source channel                    */
+/*                   const flexcan_rx_frame_t * p_stfFrame : Frame in its driver slot             */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void CAN_IF_GwRxFrame(const ST_CAN_IF_CHANNEL_t * p_stfChannel, \
+                                                            const flexcan_rx_frame_t * p_stfFrame)
+{
+    const ST_CAN_IF_RX_ROUTE_t * p_stlRoute;
+    ST_CAN_IF_GW_ROUTE_t * p_stlGwRoute;
+    INT32U u32_lKey = p_stfFrame->msgId | \
+                        (((p_stfFrame->cs & CAN_CS_IDE_MASK) != 0U) ? CAN_IF_EXT_ID_KEY : 0U);
+    INT32U u32_lRoutes = 0U;
+    INT32U u32_lIndex = 0U;
+    
+    if(0U != b_gGwEnabled)
+    {
+        p_stlRoute = CAN_IF_RxRouteFind(p_stfChannel, u32_lKey);
+        if(PNULL != p_stlRoute)
+        {
+            u32_lRoutes = p_stlRoute->u32_mGwRoutes;
+        }
+    }
+    
+    while(0U != u32_lRoutes)
+    {
+        if(0U != (u32_lRoutes & 1U))
+        {
+            p_stlGwRoute = &st_gaGwRoute[p_stfChannel->u8_maGwRoute[u32_lIndex]];
+            if((u32_lKey & p_stlGwRoute->u32_mKeyMask) == p_stlGwRoute->u32_mKey)
+            {
+                CAN_IF_GwForward(p_stfChannel, p_stlGwRoute, p_stfFrame);
+            }
+        }
+        u32_lRoutes >>= 1;
+        u32_lIndex++;
+    }
+}
+#endif
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_MsgTxHandler                                                          */
+/*                                                                                                */
+/* Description     : Call back function called from CAN Low Level Driver                          */
+/*                                                                                                */
+/* In Params       : INT8U u8_fInstance : FlexCAN instance                                        */
+/*                   mailBox_t * p_fMsgInfo : Transmitted Message ID, MB, time stamp              */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+void CAN_TX_Confirmation(INT8U u8_fInstance, mailBox_t * p_fMsgInfo)
+{
+    ST_CAN_IF_CHANNEL_t * p_stlChannel = CAN_IF_GetChannel(u8_fInstance);
+#if (CAN_IF_TX_PRIO_QUEUE == 1U)
+    ST_CAN_IF_TX_MB_t * p_stlMailBox = PNULL;
+    INT32U u32_lCANID;
+    BOOLEAN b_lGateway;
+    INT8U u8_lIndex;
+#endif
+    
+    if(PNULL == p_stlChannel)
+    {
+        /* Instance not driven by CAN IF */
+    }
+    else
+    {
+        p_stlChannel->u32_mTxTimeStamp = p_fMsgInfo->mb_timeStamp;
+        
+        if(0U == p_fMsgInfo->mb_aborted)
+        {
+            /* The bus carries our frames again, the next bus off starts with the shortest delay */
+            p_stlChannel->u32_mBusOffDelay = p_stlChannel->p_mConfig->u32_mBusOffDelayMin;
+        }
+        
+#if (CAN_IF_TX_PRIO_QUEUE == 1U)
+        for(u8_lIndex = 0; u8_lIndex < p_stlChannel->u8_mTxMailBoxCount; u8_lIndex++)
+        {
+            if(p_stlChannel->st_maTxMailBox[u8_lIndex].u8_mMailBoxIndex == p_fMsgInfo->mb_index)
+            {
+                p_stlMailBox = &p_stlChannel->st_maTxMailBox[u8_lIndex];
+                break;
+            }
+        }
+        
+        if((PNULL != p_stlMailBox) && (p_stlMailBox->b_mBusy))
+        {
+            p_stlMailBox->b_mBusy = 0U;
+            p_stlMailBox->b_mAbortPending = 0U;
+            
+            if(p_fMsgInfo->mb_aborted)
+            {
+                /* The frame did not reach the bus, it competes again with its original order */
+                (void)CAN_IF_TxHeapPush(p_stlChannel, &p_stlMailBox->st_mPdu);
+                CAN_IF_TxSchedule(p_stlChannel);
+            }
+            else
+            {
+                /* Refill the mailbox first, then confirm : the refill may overwrite the frame */
+                u32_lCANID = p_stlMailBox->st_mPdu.u32_mCANID;
+                b_lGateway = p_stlMailBox->st_mPdu.b_mGateway;
+                CAN_IF_TxSchedule(p_stlChannel);
+                if(0U == b_lGateway)
+                {
+                    CAN_IF_ConfirmTxPdu(p_stlChannel, u32_lCANID);
+                }
+                else
+                {
+                    /* Forwarded frame, not sent by ISO TP nor COM */
+                }
+            }
+        }
+        else
+        {
+            CAN_IF_ConfirmTxPdu(p_stlChannel, p_fMsgInfo->mb_msgId);
+        }
+#else
+        CAN_IF_ConfirmTxPdu(p_stlChannel, p_fMsgInfo->mb_msgId);
+#endif
+    }
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_MsgRxHandler                                                          */
+/*                                                                                                */
+/* Description     : Call back function called from CAN Low Level Driver. In deferred Rx mode the */
+/*                   frame stays in its driver slot until CAN_IF_MainFunction delivers it,        */
+/*                   gateway routes forward it at once.                                           */
+/*                                                                                                */
+/* In Params       : INT8U u8_fInstance : FlexCAN instance                                        */
+/*                   const flexcan_rx_frame_t * p_stfFrame : Received frame (driver slot)         */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+void CAN_Rx_Notification(INT8U u8_fInstance, const flexcan_rx_frame_t * p_stfFrame)
+{
+#if (CAN_IF_GATEWAY == 1U) || (CAN_IF_RX_DEFERRED == 0U)
+    const ST_CAN_IF_CHANNEL_t * p_stlChannel = CAN_IF_GetChannel(u8_fInstance);
+#endif
+    
+#if (CAN_IF_GATEWAY == 1U)
+    /* Gatewayed frames are forwarded at once, COM gets them later in deferred mode */
+    if(PNULL != p_stlChannel)
+    {
+        CAN_IF_GwRxFrame(p_stlChannel, p_stfFrame);
+    }
+#endif
+    
+#if (CAN_IF_RX_DEFERRED == 1U)
+    /* Nothing else to do, the driver keeps the frame queued */
+    (void)u8_fInstance;
+    (void)p_stfFrame;
+#else
+    if(PNULL != p_stlChannel)
+    {
+        CAN_IF_DispatchRxPdu(p_stlChannel, p_stfFrame);
+    }
+    
+    /* The frame is the oldest one held, hand its slot back */
+    FLEXCAN_DRV_ReleaseRxFrame(u8_fInstance);
+#endif
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_Error_Notification                                                       */
+/*                                                                                                */
+/* Description     : Call back function called from CAN Low Level Driver on the fault confinement */
+/*                   changes of a channel, records the bus off for its back-off recovery          */
+/*                                                                                                */
+/* In Params       : INT8U u8_fInstance : FlexCAN instance                                        */
+/*                   flexcan_error_event_t en_fEvent : Fault confinement change                   */
+/*                   const flexcan_error_stats_t * p_stfStats : Updated error statistics          */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+void CAN_Error_Notification(INT8U u8_fInstance, flexcan_error_event_t en_fEvent, \
+                                                    const flexcan_error_stats_t * p_stfStats)
+{
+    ST_CAN_IF_CHANNEL_t * p_stlChannel = CAN_IF_GetChannel(u8_fInstance);
+    
+    if(PNULL == p_stlChannel)
+    {
+        /* Instance not driven by CAN IF */
+    }
+    else if(FLEXCAN_ERROR_EVENT_BUS_OFF == en_fEvent)
+    {
+        p_stlChannel->b_mBusOff = 1U;
+        p_stlChannel->b_mRecoveryStarted = 0U;
+        p_stlChannel->u32_mBusOffTime = p_stfStats->busOffTime;
+    }
+    else if(FLEXCAN_ERROR_EVENT_ACTIVE == en_fEvent)
+    {
+        p_stlChannel->b_mBusOff = 0U;
+    }
+    else
+    {
+        /* No Action */
+    }
+}
+
+/**************************************************************************************************/
+/* Function Name   : LPIT0_IRQHandler                                                             */
+/*                                                                                                */
+/* Description     : CAN IF tick : counts the ticks and queues the cyclic entries due on this     */
+/*                   tick with the payload of the trigger transmit handler. A frame refused by a  */
+/*                   full Tx queue is dropped, the next cycle carries the newer payload. The      */
+/*                   LPIT0 vector belongs to CAN IF.                                              */
+/*                                                                                                */
+/* In Params       : None                                                                         */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+void LPIT0_IRQHandler(void)
+{
+#if (CAN_IF_CYCLIC_TX == 1U)
+    ST_CAN_IF_CHANNEL_t * p_stlChannel;
+    ST_CAN_IF_CYCLIC_PDU_t * p_stlPdu;
+    const ST_MAILBOX_CONFIG_t * p_stlConfig;
+    INT8U u8_laData[CAN_IF_MAX_PAYLOAD];
+    INT8U u8_lLength;
+    INT8U u8_lChannel;
+    INT32U u32_lIndex;
+#endif
+    
+    LPIT_DRV_ClearInterruptFlagTimerChannels(CAN_IF_LPIT_INSTANCE, \
+                                                      (1UL << CAN_IF_TICK_LPIT_CHANNEL));
+    u32_gTickCount++;
+    
+#if (CAN_IF_CYCLIC_TX == 1U)
+    for(u8_lChannel = 0; u8_lChannel < CAN_IF_CHANNEL_NUM; u8_lChannel++)
+    {
+        p_stlChannel = CAN_IF_GetChannel(u8_lChannel);
+        if(PNULL == p_stlChannel)
+        {
+            continue;
+        }
+        
+        for(u32_lIndex = 0U; u32_lIndex < p_stlChannel->u8_mCyclicCount; u32_lIndex++)
+        {
+            p_stlPdu = &p_stlChannel->st_maCyclic[u32_lIndex];
+            p_stlPdu->u32_mCountdown--;
+            if(0U != p_stlPdu->u32_mCountdown)
+            {
+                continue;
+            }
+            p_stlPdu->u32_mCountdown = p_stlPdu->u32_mPeriod;
+            
+            u8_lLength = (PNULL != fp_gComTriggerTransmit) ? \
+                            fp_gComTriggerTransmit(p_stlPdu->u16_mPduHandle, &u8_laData[0]) : 0U;
+            if(0U != u8_lLength)
+            {
+                p_stlConfig = &st_gMailBoxConfig[p_stlPdu->u16_mPduHandle];
+                (void)CAN_IF_WriteMsg(u8_lChannel, p_stlConfig->u32_mMsgID, \
+                                    p_stlConfig->u8_mMailBoxIndex, &u8_laData[0], u8_lLength);
+            }
+        }
+    }
+#endif
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_GetTickCount()                                                        */
+/*                                                                                                */
+/* Description     : Number of CAN IF ticks since CAN_IF_Init, wraps around. The main loop runs   */
+/*                   its periodic tasks once per tick and sleeps in between.                      */
+/*                                                                                                */
+/* In Params       : None                                                                         */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT32U : Tick count, one tick every CAN_IF_TICK_US                           */
+/**************************************************************************************************/
+
+INT32U CAN_IF_GetTickCount(void)
+{
+    return u32_gTickCount;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_BusOffRecovery                                                        */
+/*                                                                                                */
+/* Description     : Releases a channel held in bus off once its back-off delay has elapsed, and  */
+/*                   grows the delay of the next bus off                                          */
+/*                                                                                                */
+/* In Params       : ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                                 */
+/*                   INT32U u32_fNow : Current time of the channel (bit times)                    */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void CAN_IF_BusOffRecovery(ST_CAN_IF_CHANNEL_t * p_stfChannel, INT32U u32_fNow)
+{
+    const ST_CAN_IF_CHANNEL_CONFIG_t * p_stlConfig = p_stfChannel->p_mConfig;
+    INT32U u32_lDelay;
+    
+    INT_SYS_DisableIRQGlobal();
+    if((0U != p_stfChannel->b_mBusOff) && (0U == p_stfChannel->b_mRecoveryStarted))
+    {
+        /* Delay in ms converted to bit times of the nominal bit rate, the channel timebase */
+        u32_lDelay = p_stfChannel->u32_mBusOffDelay * (p_stfChannel->st_mBitTiming.bitrate / 1000U);
+        
+        if((u32_fNow - p_stfChannel->u32_mBusOffTime) >= u32_lDelay)
+        {
+            p_stfChannel->b_mRecoveryStarted = 1U;
+            p_stfChannel->u32_mRecoveryCount++;
+            
+            /* A bus off without a confirmed transmission in between waits longer */
+            if((p_stlConfig->u32_mBusOffDelayFactor > 1U) && \
+               (p_stfChannel->u32_mBusOffDelay < \
+                    (p_stlConfig->u32_mBusOffDelayMax / p_stlConfig->u32_mBusOffDelayFactor)))
+            {
+                p_stfChannel->u32_mBusOffDelay *= p_stlConfig->u32_mBusOffDelayFactor;
+            }
+            else if(p_stlConfig->u32_mBusOffDelayFactor > 1U)
+            {
+                p_stfChannel->u32_mBusOffDelay = p_stlConfig->u32_mBusOffDelayMax;
+            }
+            else
+            {
+                /* No Action */
+            }
+            
+            /* The node leaves bus off once 128 x 11 recessive bits have been seen */
+            (void)FLEXCAN_DRV_RecoverBusOff(p_stfChannel->u8_mInstance);
+        }
+    }
+    INT_SYS_EnableIRQGlobal();
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_MainFunction()                                                        */
+/*                                                                                                */
+/* Description     : Delivers up to CAN_IF_RX_BATCH_SIZE frames per channel queued by the FlexCAN */
+/*                   ISRs to ISO TP / OSEK COM. To be called cyclically from the main loop or a   */
+/*                   task. Each channel has its own batch, a busy bus does not starve the others. */
+/*                   Also ends the bus off back-off delays, with the resolution of its period.    */
+/*                                                                                                */
+/* In Params       : None                                                                         */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+void CAN_IF_MainFunction(void)
+{
+    ST_CAN_IF_CHANNEL_t * p_stlChannel;
+    INT8U u8_lChannel;
+    INT32U u32_lNow;
+#if (CAN_IF_RX_DEFERRED == 1U)
+    const flexcan_rx_frame_t * p_stlFrame;
+    INT32U u32_lCount;
+#endif
+    
+    for(u8_lChannel = 0; u8_lChannel < CAN_IF_CHANNEL_NUM; u8_lChannel++)
+    {
+        p_stlChannel = CAN_IF_GetChannel(u8_lChannel);
+        if(PNULL == p_stlChannel)
+        {
+            continue;
+        }
+        
+        /* Keeps the timer wrap count of the driver running while the bus is quiet */
+        u32_lNow = FLEXCAN_DRV_GetTime(p_stlChannel->u8_mInstance);
+        
+        if(0U != p_stlChannel->p_mConfig->u32_mBusOffDelayMin)
+        {
+            CAN_IF_BusOffRecovery(p_stlChannel, u32_lNow);
+        }
+        
+#if (CAN_IF_RX_DEFERRED == 1U)
+        u32_lCount = 0;
+        while(u32_lCount < CAN_IF_RX_BATCH_SIZE)
+        {
+            p_stlFrame = FLEXCAN_DRV_PeekRxFrame(p_stlChannel->u8_mInstance);
+            if(PNULL == p_stlFrame)
+            {
+                break;
+            }
+            
+            CAN_IF_DispatchRxPdu(p_stlChannel, p_stlFrame);
+            
+            /* Hand the slot back to the ISR only after it has been consumed */
+            FLEXCAN_DRV_ReleaseRxFrame(p_stlChannel->u8_mInstance);
+            u32_lCount++;
+        }
+#endif
+    }
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_GetTimeStamp()                                                        */
+/*                                                                                                */
+/* Description     : Reads the FlexCAN timebase of a channel, in the unit of its Rx / Tx time     */
+/*                   stamps (bit times of the nominal bit rate)                                   */
+/*                                                                                                */
+/* In Params       : INT8U u8_fChannel : Channel                                                  */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT32U : Current time, 0 if the channel is not used                          */
+/**************************************************************************************************/
+
+INT32U CAN_IF_GetTimeStamp(INT8U u8_fChannel)
+{
+    const ST_CAN_IF_CHANNEL_t * p_stlChannel = CAN_IF_GetChannel(u8_fChannel);
+    INT32U u32_lTime = 0;
+    
+    if(PNULL != p_stlChannel)
+    {
+        u32_lTime = FLEXCAN_DRV_GetTime(p_stlChannel->u8_mInstance);
+    }
+    
+    return u32_lTime;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_GetTxTimeStamp()                                                      */
+/*                                                                                                */
+/* Description     : Transmission time of the frame being confirmed on a channel, only valid     */
+/*                   from the ISO TP / COM Tx confirmation handlers                               */
+/*                                                                                                */
+/* In Params       : INT8U u8_fChannel : Channel                                                  */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT32U : Time stamp of the confirmed frame, 0 if the channel is not used     */
+/**************************************************************************************************/
+
+INT32U CAN_IF_GetTxTimeStamp(INT8U u8_fChannel)
+{
+    const ST_CAN_IF_CHANNEL_t * p_stlChannel = CAN_IF_GetChannel(u8_fChannel);
+    INT32U u32_lTime = 0;
+    
+    if(PNULL != p_stlChannel)
+    {
+        u32_lTime = p_stlChannel->u32_mTxTimeStamp;
+    }
+    
+    return u32_lTime;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_GetRxRingStats()                                                      */
+/*                                                                                                */
+/* Description     : Reads the Rx frame slot high water mark and overflow counter of a channel    */
+/*                                                                                                */
+/* In Params       : INT8U u8_fChannel : Channel                                                  */
+/*                   BOOLEAN b_fClear : TRUE to reset the statistics after reading                */
+/*                                                                                                */
+/* Out Params      : ST_CAN_IF_RX_RING_STATS_t * p_stfStats : Statistics                          */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if the channel is not used         */
+/**************************************************************************************************/
+
+EN_CAN_IF_RESULT_t CAN_IF_GetRxRingStats(INT8U u8_fChannel, ST_CAN_IF_RX_RING_STATS_t * p_stfStats, \
+                                                                                BOOLEAN b_fClear)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    const ST_CAN_IF_CHANNEL_t * p_stlChannel = CAN_IF_GetChannel(u8_fChannel);
+    flexcan_rx_frame_stats_t st_lStats;
+    
+    if(PNULL == p_stlChannel)
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    else
+    {
+        FLEXCAN_DRV_GetRxFrameStats(p_stlChannel->u8_mInstance, &st_lStats, (b_fClear != 0U));
+        p_stfStats->u32_mHighWater = st_lStats.highWater;
+        p_stfStats->u32_mOverflowCount = st_lStats.overflowCount;
+    }
+    
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_GetBusStats()                                                         */
+/*                                                                                                */
+/* Description     : Reads the error counters by class, TEC / REC, fault confinement transitions  */
+/*                   and bus off recoveries of a channel, kept by the FlexCAN error interrupts    */
+/*                                                                                                */
+/* In Params       : INT8U u8_fChannel : Channel                                                  */
+/*                   BOOLEAN b_fClear : TRUE to reset the counters and peaks after reading        */
+/*                                                                                                */
+/* Out Params      : ST_CAN_IF_BUS_STATS_t * p_stfStats : Statistics                              */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if the channel is not used         */
+/**************************************************************************************************/
+
+EN_CAN_IF_RESULT_t CAN_IF_GetBusStats(INT8U u8_fChannel, ST_CAN_IF_BUS_STATS_t * p_stfStats, \
+                                                                                BOOLEAN b_fClear)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    ST_CAN_IF_CHANNEL_t * p_stlChannel = CAN_IF_GetChannel(u8_fChannel);
+    
+    if(PNULL == p_stlChannel)
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    else
+    {
+        INT_SYS_DisableIRQGlobal();
+        FLEXCAN_DRV_GetErrorStats(p_stlChannel->u8_mInstance, &p_stfStats->st_mError, \
+                                                                            (b_fClear != 0U));
+        p_stfStats->u32_mRecoveryCount = p_stlChannel->u32_mRecoveryCount;
+        p_stfStats->u32_mBusOffDelay = p_stlChannel->u32_mBusOffDelay;
+        if(0U != b_fClear)
+        {
+            p_stlChannel->u32_mRecoveryCount = 0;
+        }
+        INT_SYS_EnableIRQGlobal();
+    }
+    
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_GetGatewayStats()                                                     */
+/*                                                                                                */
+/* Description     : Reads the forward, drop and latency counters of a gateway route              */
+/*                                                                                                */
+/* In Params       : INT16U u16_fRoute : Route, index of st_gaGwRouteConfig                       */
+/*                   BOOLEAN b_fClear : TRUE to reset the counters after reading                  */
+/*                                                                                                */
+/* Out Params      : ST_CAN_IF_GW_STATS_t * p_stfStats : Counters                                 */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if the gateway is not running or   */
+/*                   the route does not exist                                                     */
+/**************************************************************************************************/
+
+EN_CAN_IF_RESULT_t CAN_IF_GetGatewayStats(INT16U u16_fRoute, ST_CAN_IF_GW_STATS_t * p_stfStats, \
+                                                                                BOOLEAN b_fClear)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_ERROR;
+#if (CAN_IF_GATEWAY == 1U)
+    if((0U != b_gGwEnabled) && (u16_fRoute < CAN_IF_GW_ROUTE_NUM))
+    {
+        INT_SYS_DisableIRQGlobal();
+        *p_stfStats = st_gaGwRoute[u16_fRoute].st_mStats;
+        if(0U != b_fClear)
+        {
+            memset((void *)&st_gaGwRoute[u16_fRoute].st_mStats, 0, sizeof(ST_CAN_IF_GW_STATS_t));
+        }
+        INT_SYS_EnableIRQGlobal();
+        en_lResult = CAN_IF_OK;
+    }
+#else
+    (void)u16_fRoute;
+    (void)p_stfStats;
+    (void)b_fClear;
+#endif
+    
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_RxFilterSize                                                          */
+/*                                                                                                */
+/* Description     : Number of IDs accepted by a filter                                           */
+/*                                                                                                */
+/* In Params       : INT32U u32_fMask : Compared ID bits                                          */
+/*                   BOOLEAN b_fExtended : Extended ID filter                                     */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT32U : 2 ^ number of ID bits not compared                                  */
+/**************************************************************************************************/
+
+static INT32U CAN_IF_RxFilterSize(INT32U u32_fMask, BOOLEAN b_fExtended)
+{
+    INT32U u32_lFree = (b_fExtended != 0U) ? CAN_IF_EXT_ID_MASK : CAN_IF_STD_ID_MASK;
+    INT32U u32_lBits = 0U;
+    
+    /* Count the ID bits left out of the mask */
+    u32_lFree &= ~u32_fMask;
+    while(0U != u32_lFree)
+    {
+        u32_lFree &= (u32_lFree - 1U);
+        u32_lBits++;
+    }
+    
+    return (1UL << u32_lBits);
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_RxIdKeyInsert                                                         */
+/*                                                                                                */
+/* Description     : Adds an ID to the sorted configured Rx IDs and its routing, the first entry  */
+/*                   of a duplicate ID keeps its upper layer                                      */
+/*                                                                                                */
+/* In Params       : ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                                 */
+/*                   INT32U u32_fKey : CAN ID, bit 31 set for an extended ID                      */
+/*                   INT16U u16_fPduHandle : PDU handle of the ID                                 */
+/*                   EN_CAN_IF_RX_HANDLER_t en_fHandler : Upper layer of the ID                   */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if CAN_IF_RX_FILTER_MAX is reached */
+/**************************************************************************************************/
+
+static EN_CAN_IF_RESULT_t CAN_IF_RxIdKeyInsert(ST_CAN_IF_CHANNEL_t * p_stfChannel, \
+                        INT32U u32_fKey, INT16U u16_fPduHandle, EN_CAN_IF_RX_HANDLER_t en_fHandler)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    INT32U * p_lKey = &p_stfChannel->u32_maRxIdKey[0];
+    ST_CAN_IF_RX_ROUTE_t * p_stlRoute;
+    INT32U u32_lIndex;
+    
+    if(0U != CAN_IF_RxIdKeyFind(p_stfChannel, u32_fKey))
+    {
+        /* The UDS request ID takes the PDU handle of its entry */
+        for(u32_lIndex = 0U; u32_lIndex < p_stfChannel->u32_mRxRouteCount; u32_lIndex++)
+        {
+            p_stlRoute = &p_stfChannel->st_maRxRoute[u32_lIndex];
+            if((u32_fKey == p_stlRoute->u32_mKey) && \
+               (CAN_IF_PDU_HANDLE_NONE == p_stlRoute->u16_mPduHandle))
+            {
+                p_stlRoute->u16_mPduHandle = u16_fPduHandle;
+            }
+        }
+    }
+    else if(p_stfChannel->u32_mRxIdKeyCount >= CAN_IF_RX_FILTER_MAX)
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    else
+    {
+        u32_lIndex = p_stfChannel->u32_mRxIdKeyCount;
+        while((u32_lIndex > 0U) && (p_lKey[u32_lIndex - 1U] > u32_fKey))
+        {
+            p_lKey[u32_lIndex] = p_lKey[u32_lIndex - 1U];
+            u32_lIndex--;
+        }
+        p_lKey[u32_lIndex] = u32_fKey;
+        p_stfChannel->u32_mRxIdKeyCount++;
+        
+        p_stlRoute = &p_stfChannel->st_maRxRoute[p_stfChannel->u32_mRxRouteCount];
+        p_stlRoute->u32_mKey = u32_fKey;
+        p_stlRoute->u16_mPduHandle = u16_fPduHandle;
+        p_stlRoute->u8_mHandler = (INT8U)en_fHandler;
+        p_stfChannel->u32_mRxRouteCount++;
+    }
+    
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_RxRouteHash                                                           */
+/*                                                                                                */
+/* Description     : Builds the Rx routing hash table : each multiplier candidate is tried with   */
+/*                   linear probing, the one needing the fewest probes for its worst ID is kept.  */
+/*                   A candidate without collision gives a single probe per lookup                */
+/*                                                                                                */
+/* In Params       : ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                                 */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void CAN_IF_RxRouteHash(ST_CAN_IF_CHANNEL_t * p_stfChannel)
+{
+    INT8U * p_lSlot = &p_stfChannel->u8_maRxRouteSlot[0];
+    INT32U u32_lSeed;
+    INT32U u32_lMult;
+    INT32U u32_lRoute;
+    INT32U u32_lSlot;
+    INT32U u32_lProbes;
+    INT32U u32_lWorst;
+    INT32U u32_lBestMult = CAN_IF_RX_ROUTE_MULT;
+    INT32U u32_lBestProbes = 0xFFFFFFFFUL;
+    
+    for(u32_lSeed = 0U; u32_lSeed <= CAN_IF_RX_ROUTE_SEEDS; u32_lSeed++)
+    {
+        /* Last pass rebuilds the table with the best candidate */
+        u32_lMult = (u32_lSeed < CAN_IF_RX_ROUTE_SEEDS) ? \
+                            (CAN_IF_RX_ROUTE_MULT * ((2U * u32_lSeed) + 1U)) : u32_lBestMult;
+        memset((void *)p_lSlot, CAN_IF_RX_ROUTE_EMPTY, sizeof(p_stfChannel->u8_maRxRouteSlot));
+        u32_lWorst = 1U;
+        for(u32_lRoute = 0U; (u32_lRoute < p_stfChannel->u32_mRxRouteCount) && \
+                             ((u32_lWorst < u32_lBestProbes) || \
+                              (u32_lSeed == CAN_IF_RX_ROUTE_SEEDS)); u32_lRoute++)
+        {
+            u32_lSlot = CAN_IF_RxRouteSlot(p_stfChannel->st_maRxRoute[u32_lRoute].u32_mKey, \
+                                                                                    u32_lMult);
+            u32_lProbes = 1U;
+            while(CAN_IF_RX_ROUTE_EMPTY != p_lSlot[u32_lSlot])
+            {
+                u32_lSlot = (u32_lSlot + 1U) & ((1UL << CAN_IF_RX_ROUTE_BITS) - 1U);
+                u32_lProbes++;
+            }
+            p_lSlot[u32_lSlot] = (INT8U)u32_lRoute;
+            if(u32_lProbes > u32_lWorst)
+            {
+                u32_lWorst = u32_lProbes;
+            }
+        }
+        
+        if(u32_lSeed == CAN_IF_RX_ROUTE_SEEDS)
+        {
+            /* No Action */
+        }
+        else if(u32_lWorst < u32_lBestProbes)
+        {
+            u32_lBestProbes = u32_lWorst;
+            u32_lBestMult = u32_lMult;
+            if(1U == u32_lBestProbes)
+            {
+                /* Perfect hash, the table is already built with it */
+                break;
+            }
+        }
+        else
+        {
+            /* No Action */
+        }
+    }
+    
+    p_stfChannel->u32_mRxRouteMult = u32_lBestMult;
+    p_stfChannel->u32_mRxRouteProbes = u32_lBestProbes;
+}
+
+#if (CAN_IF_GATEWAY == 1U)
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_GwRouteBits                                                           */
+/*                                                                                                */
+/* Description     : Gateway routes of the channel sharing at least one ID with a key and mask    */
+/*                                                                                                */
+/* In Params       : const ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                           */
+/*                   INT32U u32_fKey : CAN ID, bit 31 set for an extended ID                      */
+/*                   INT32U u32_fMask : Compared key bits, bit 31 included                        */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT32U : bit n set if u8_maGwRoute[n] may match                              */
+/**************************************************************************************************/
+
+static INT32U CAN_IF_GwRouteBits(const ST_CAN_IF_CHANNEL_t * p_stfChannel, INT32U u32_fKey, \
+                                                                                INT32U u32_fMask)
+{
+    const ST_CAN_IF_GW_ROUTE_t * p_stlGwRoute;
+    INT32U u32_lBits = 0U;
+    INT32U u32_lIndex;
+    
+    for(u32_lIndex = 0U; u32_lIndex < p_stfChannel->u8_mGwRouteCount; u32_lIndex++)
+    {
+        /* Both match an ID when they agree on the bits compared by both */
+        p_stlGwRoute = &st_gaGwRoute[p_stfChannel->u8_maGwRoute[u32_lIndex]];
+        if(0U == ((u32_fKey ^ p_stlGwRoute->u32_mKey) & u32_fMask & p_stlGwRoute->u32_mKeyMask))
+        {
+            u32_lBits |= (1UL << u32_lIndex);
+        }
+    }
+    
+    return u32_lBits;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_GwCollectRxIds                                                        */
+/*                                                                                                */
+/* Description     : Collects the gateway routes whose source is the channel : a single source    */
+/*                   ID is added to the Rx IDs, a masked one to the ID ranges, so the hardware    */
+/*                   filters accept them. Each Rx routing entry then lists the routes it may      */
+/*                   match, the ISR only checks those.                                            */
+/*                                                                                                */
+/* In Params       : ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                                 */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if there are too many IDs, ranges  */
+/*                   or routes                                                                    */
+/**************************************************************************************************/
+
+static EN_CAN_IF_RESULT_t CAN_IF_GwCollectRxIds(ST_CAN_IF_CHANNEL_t * p_stfChannel)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    const ST_CAN_IF_GW_ROUTE_CONFIG_t * p_stlConfig;
+    ST_CAN_IF_GW_ROUTE_t * p_stlGwRoute;
+    ST_CAN_IF_FILTER_t * p_stlRange;
+    ST_CAN_IF_RX_ROUTE_t * p_stlRoute;
+    INT32U u32_lRoute;
+    INT32U u32_lIdMask;
+    INT32U u32_lSrcMask;
+    
+    p_stfChannel->u8_mGwRouteCount = 0U;
+    
+    for(u32_lRoute = 0U; u32_lRoute < CAN_IF_GW_ROUTE_NUM; u32_lRoute++)
+    {
+        p_stlConfig = &st_gaGwRouteConfig[u32_lRoute];
+        if(p_stfChannel->u8_mInstance != p_stlConfig->u8_mSrcChannel)
+        {
+            continue;
+        }
+        if(p_stfChannel->u8_mGwRouteCount >= CAN_IF_GW_ROUTE_MAX)
+        {
+            en_lResult = CAN_IF_ERROR;
+            continue;
+        }
+        
+        u32_lIdMask = (EN_FLEXCAN_MSG_ID_EXT == p_stlConfig->en_mMsgIdType) ? \
+                                                            CAN_IF_EXT_ID_MASK : CAN_IF_STD_ID_MASK;
+        u32_lSrcMask = (0U == p_stlConfig->u32_mSrcMask) ? u32_lIdMask : \
+                                                        (p_stlConfig->u32_mSrcMask & u32_lIdMask);
+        p_stlGwRoute = &st_gaGwRoute[u32_lRoute];
+        p_stlGwRoute->u32_mKey = (p_stlConfig->u32_mSrcID & u32_lSrcMask) | \
+                                    ((CAN_IF_EXT_ID_MASK == u32_lIdMask) ? CAN_IF_EXT_ID_KEY : 0U);
+        p_stlGwRoute->u32_mKeyMask = u32_lSrcMask | CAN_IF_EXT_ID_KEY;
+        p_stlGwRoute->u8_mDstChannels = p_stlConfig->u8_mDstChannels;
+        p_stlGwRoute->u32_mDstMask = p_stlConfig->u32_mDstMask & u32_lIdMask;
+        p_stlGwRoute->u32_mDstID = p_stlConfig->u32_mDstID & p_stlGwRoute->u32_mDstMask;
+        p_stfChannel->u8_maGwRoute[p_stfChannel->u8_mGwRouteCount] = (INT8U)u32_lRoute;
+        p_stfChannel->u8_mGwRouteCount++;
+        
+        if(u32_lSrcMask == u32_lIdMask)
+        {
+            /* Single ID, an upper layer entry of the same ID keeps its routing */
+            if(CAN_IF_OK != CAN_IF_RxIdKeyInsert(p_stfChannel, p_stlGwRoute->u32_mKey, \
+                                                CAN_IF_PDU_HANDLE_NONE, CAN_IF_RX_HANDLER_NONE))
+            {
+                en_lResult = CAN_IF_ERROR;
+            }
+        }
+        else if(p_stfChannel->u32_mRxRangeCount >= CAN_IF_RX_RANGE_MAX)
+        {
+            en_lResult = CAN_IF_ERROR;
+        }
+        else
+        {
+            /* After the ranges of the configuration table, which take the IDs they share */
+            p_stlRange = &p_stfChannel->st_maRxRange[p_stfChannel->u32_mRxRangeCount];
+            p_stlRange->b_mExtended = (CAN_IF_EXT_ID_MASK == u32_lIdMask) ? 1U : 0U;
+            p_stlRange->u32_mMask = u32_lSrcMask;
+            p_stlRange->u32_mValue = p_stlConfig->u32_mSrcID & u32_lSrcMask;
+            p_stlRange->b_mInexact = 0U;
+            p_stlRange->b_mInFifo = 0U;
+            p_stlRange->u8_mSlot = 0U;
+            p_stlRoute = &p_stfChannel->st_maRxRangeRoute[p_stfChannel->u32_mRxRangeCount];
+            p_stlRoute->u32_mKey = p_stlRange->u32_mValue;
+            p_stlRoute->u16_mPduHandle = CAN_IF_PDU_HANDLE_NONE;
+            p_stlRoute->u8_mHandler = (INT8U)CAN_IF_RX_HANDLER_NONE;
+            p_stfChannel->u32_mRxRangeCount++;
+        }
+    }
+    
+    for(u32_lRoute = 0U; u32_lRoute < p_stfChannel->u32_mRxRouteCount; u32_lRoute++)
+    {
+        p_stlRoute = &p_stfChannel->st_maRxRoute[u32_lRoute];
+        p_stlRoute->u32_mGwRoutes = CAN_IF_GwRouteBits(p_stfChannel, p_stlRoute->u32_mKey, \
+                                                                                0xFFFFFFFFUL);
+    }
+    for(u32_lRoute = 0U; u32_lRoute < p_stfChannel->u32_mRxRangeCount; u32_lRoute++)
+    {
+        p_stlRange = &p_stfChannel->st_maRxRange[u32_lRoute];
+        p_stfChannel->st_maRxRangeRoute[u32_lRoute].u32_mGwRoutes = \
+                CAN_IF_GwRouteBits(p_stfChannel, p_stlRange->u32_mValue | \
+                                ((0U != p_stlRange->b_mExtended) ? CAN_IF_EXT_ID_KEY : 0U), \
+                                p_stlRange->u32_mMask | CAN_IF_EXT_ID_KEY);
+    }
+    
+    return en_lResult;
+}
+#endif
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_CollectRxIds                                                          */
+/*                                                                                                */
+/* Description     : Collects the Rx IDs and ID ranges of the channel in the configuration table  */
+/*                   and the UDS request ID with their routing, and the Rx mailboxes which can    */
+/*                   take a filter                                                                */
+/*                                                                                                */
+/* In Params       : ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                                 */
+/*                   INT32U u32_fFirstMb : First MB not taken by the Rx FIFO                      */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if there are too many IDs          */
+/**************************************************************************************************/
+
+static EN_CAN_IF_RESULT_t CAN_IF_CollectRxIds(ST_CAN_IF_CHANNEL_t * p_stfChannel, \
+                                                                            INT32U u32_fFirstMb)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    const ST_MAILBOX_CONFIG_t * p_stlConfig = &st_gMailBoxConfig[0];
+    const ST_MAILBOX_CONFIG_t * p_stlOther;
+    const flexcan_user_config_t * p_stlUserConfig = p_stfChannel->p_mConfig->p_mUserConfig;
+    ST_CAN_IF_FILTER_t * p_stlRange;
+    ST_CAN_IF_RX_ROUTE_t * p_stlRoute;
+    BOOLEAN b_lFree;
+    INT32U u32_lIndex;
+    INT32U u32_lMask;
+    INT16U u16_lPduHandle;
+    
+    p_stfChannel->u32_mRxIdKeyCount = 0U;
+    p_stfChannel->u32_mRxRouteCount = 0U;
+    p_stfChannel->u32_mRxRangeCount = 0U;
+    p_stfChannel->u32_mRxPoolMbCount = 0U;
+    
+    if((p_stfChannel->u8_mInstance == u8_gIsoTpChannel) && \
+       (CAN_IF_OK != CAN_IF_RxIdKeyInsert(p_stfChannel, \
+                        (INT32U)u16_gUdsReqID & CAN_IF_STD_ID_MASK, CAN_IF_PDU_HANDLE_NONE, \
+                                                                    CAN_IF_RX_HANDLER_ISOTP)))
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    
+    while(1)
+    {
+        if((EN_MAILBOX_RECEIVE == p_stlConfig->en_mMailBoxDirection) && \
+           (p_stfChannel->u8_mInstance == p_stlConfig->u8_mCanNode))
+        {
+            u16_lPduHandle = (INT16U)(p_stlConfig - &st_gMailBoxConfig[0]);
+            u32_lMask = (EN_FLEXCAN_MSG_ID_EXT == \
+                         p_stlConfig->st_mFlexCanDataInfo.en_mMsgIdType) ? \
+                                                            CAN_IF_EXT_ID_MASK : CAN_IF_STD_ID_MASK;
+            if((0U != p_stlConfig->u32_mAcceptanceMask) && \
+               (u32_lMask != (p_stlConfig->u32_mAcceptanceMask & u32_lMask)))
+            {
+                /* Masked entry : its range becomes a filter of its own */
+                if(p_stfChannel->u32_mRxRangeCount >= CAN_IF_RX_RANGE_MAX)
+                {
+                    en_lResult = CAN_IF_ERROR;
+                }
+                else
+                {
+                    p_stlRange = &p_stfChannel->st_maRxRange[p_stfChannel->u32_mRxRangeCount];
+                    p_stlRange->b_mExtended = (CAN_IF_EXT_ID_MASK == u32_lMask) ? 1U : 0U;
+                    p_stlRange->u32_mMask = p_stlConfig->u32_mAcceptanceMask & u32_lMask;
+                    p_stlRange->u32_mValue = p_stlConfig->u32_mMsgID & p_stlRange->u32_mMask;
+                    p_stlRange->b_mInexact = 0U;
+                    p_stlRange->b_mInFifo = 0U;
+                    p_stlRange->u8_mSlot = 0U;
+                    p_stlRoute = &p_stfChannel->st_maRxRangeRoute[p_stfChannel->u32_mRxRangeCount];
+                    p_stlRoute->u32_mKey = p_stlRange->u32_mValue;
+                    p_stlRoute->u16_mPduHandle = u16_lPduHandle;
+                    p_stlRoute->u8_mHandler = (INT8U)CAN_IF_RX_HANDLER_COM;
+                    p_stfChannel->u32_mRxRangeCount++;
+                }
+            }
+            else if(CAN_IF_EXT_ID_MASK == u32_lMask)
+            {
+                if(CAN_IF_OK != CAN_IF_RxIdKeyInsert(p_stfChannel, (p_stlConfig->u32_mMsgID & \
+                                                  CAN_IF_EXT_ID_MASK) | CAN_IF_EXT_ID_KEY, \
+                                                  u16_lPduHandle, CAN_IF_RX_HANDLER_COM))
+                {
+                    en_lResult = CAN_IF_ERROR;
+                }
+            }
+            else
+            {
+                if(CAN_IF_OK != CAN_IF_RxIdKeyInsert(p_stfChannel, \
+                                                    p_stlConfig->u32_mMsgID & CAN_IF_STD_ID_MASK, \
+                                                    u16_lPduHandle, CAN_IF_RX_HANDLER_COM))
+                {
+                    en_lResult = CAN_IF_ERROR;
+                }
+            }
+            
+            /* The MB takes a filter if it exists, is out of the Rx FIFO area, is not a Tx */
+            /* mailbox and is not listed twice                                             */
+            b_lFree = ((p_stlConfig->u8_mMailBoxIndex >= u32_fFirstMb) && \
+                       (p_stlConfig->u8_mMailBoxIndex < p_stlUserConfig->max_num_mb) && \
+                       (p_stfChannel->u32_mRxPoolMbCount < CAN_IF_RX_FILTER_MAX)) ? 1U : 0U;
+            for(u32_lIndex = 0U; (u32_lIndex < p_stfChannel->u32_mRxPoolMbCount) && \
+                                 (0U != b_lFree); u32_lIndex++)
+            {
+                if(p_stfChannel->u8_maRxPoolMb[u32_lIndex] == p_stlConfig->u8_mMailBoxIndex)
+                {
+                    b_lFree = 0U;
+                }
+            }
+            p_stlOther = &st_gMailBoxConfig[0];
+            while(0U != b_lFree)
+            {
+                if((EN_MAILBOX_TRANSMIT == p_stlOther->en_mMailBoxDirection) && \
+                   (p_stfChannel->u8_mInstance == p_stlOther->u8_mCanNode) && \
+                   (p_stlOther->u8_mMailBoxIndex == p_stlConfig->u8_mMailBoxIndex))
+                {
+                    b_lFree = 0U;
+                }
+                
+                if(p_stlOther->u8_EOL)
+                {
+                    break;
+                }
+                p_stlOther++;
+            }
+            if(0U != b_lFree)
+            {
+                p_stfChannel->u8_maRxPoolMb[p_stfChannel->u32_mRxPoolMbCount] = \
+                                                                    p_stlConfig->u8_mMailBoxIndex;
+                p_stfChannel->u32_mRxPoolMbCount++;
+            }
+        }
+        else
+        {
+            /* No Action */
+        }
+        
+        if(p_stlConfig->u8_EOL)
+        {
+            break;
+        }
+        p_stlConfig++;
+    }
+    
+#if (CAN_IF_GATEWAY == 1U)
+    /* Source IDs of the gateway routes */
+    if(CAN_IF_OK != CAN_IF_GwCollectRxIds(p_stfChannel))
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+#endif
+    
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_MergeExactRxFilters                                                   */
+/*                                                                                                */
+/* Description     : Merges filters with the same mask whose values differ in a single bit, the  */
+/*                   merged filter accepts exactly the IDs of both                                */
+/*                                                                                                */
+/* In Params       : ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                                 */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void CAN_IF_MergeExactRxFilters(ST_CAN_IF_CHANNEL_t * p_stfChannel)
+{
+    ST_CAN_IF_FILTER_t * p_stlRxFilter = &p_stfChannel->st_maRxFilter[0];
+    BOOLEAN b_lMerged = 1U;
+    INT32U u32_lIndex;
+    INT32U u32_lOther;
+    INT32U u32_lDiff;
+    
+    while(0U != b_lMerged)
+    {
+        b_lMerged = 0U;
+        for(u32_lIndex = 0U; u32_lIndex < p_stfChannel->u32_mRxFilterCount; u32_lIndex++)
+        {
+            u32_lOther = u32_lIndex + 1U;
+            while(u32_lOther < p_stfChannel->u32_mRxFilterCount)
+            {
+                u32_lDiff = p_stlRxFilter[u32_lIndex].u32_mValue ^ p_stlRxFilter[u32_lOther].u32_mValue;
+                if((p_stlRxFilter[u32_lIndex].b_mExtended == p_stlRxFilter[u32_lOther].b_mExtended) && \
+                   (p_stlRxFilter[u32_lIndex].u32_mMask == p_stlRxFilter[u32_lOther].u32_mMask) && \
+                   (0U != u32_lDiff) && (0U == (u32_lDiff & (u32_lDiff - 1U))))
+                {
+                    p_stlRxFilter[u32_lIndex].u32_mMask &= ~u32_lDiff;
+                    p_stlRxFilter[u32_lIndex].u32_mValue &= ~u32_lDiff;
+                    p_stfChannel->u32_mRxFilterCount--;
+                    p_stlRxFilter[u32_lOther] = p_stlRxFilter[p_stfChannel->u32_mRxFilterCount];
+                    b_lMerged = 1U;
+                }
+                else
+                {
+                    u32_lOther++;
+                }
+            }
+        }
+    }
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_FitRxFilters                                                          */
+/*                                                                                                */
+/* Description     : Merges filters until they fit the hardware, each step takes the pair of     */
+/*                   filters whose merge accepts the fewest IDs which are not configured           */
+/*                                                                                                */
+/* In Params       : ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                                 */
+/*                   INT32U u32_fMaskedSlots : Filters taking a mask (Rx MBs, FIFO elements)      */
+/*                   INT32U u32_fExactSlots : Filters taking a single ID (FIFO elements)          */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if the filters cannot fit         */
+/**************************************************************************************************/
+
+static EN_CAN_IF_RESULT_t CAN_IF_FitRxFilters(ST_CAN_IF_CHANNEL_t * p_stfChannel, \
+                                                INT32U u32_fMaskedSlots, INT32U u32_fExactSlots)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    ST_CAN_IF_FILTER_t * p_stlRxFilter = &p_stfChannel->st_maRxFilter[0];
+    ST_CAN_IF_FILTER_t * p_stlFilter;
+    ST_CAN_IF_FILTER_t * p_stlOther;
+    INT32U u32_lMaskedCount;
+    INT32U u32_lIndex;
+    INT32U u32_lOther;
+    INT32U u32_lMask;
+    INT32U u32_lUnion;
+    INT32U u32_lCost;
+    INT32U u32_lBestCost;
+    INT32U u32_lBestIndex = 0U;
+    INT32U u32_lBestOther = 0U;
+    INT32U u32_lBestMask = 0U;
+    BOOLEAN b_lMaskedOnly;
+    
+    while(CAN_IF_OK == en_lResult)
+    {
+        u32_lMaskedCount = 0U;
+        for(u32_lIndex = 0U; u32_lIndex < p_stfChannel->u32_mRxFilterCount; u32_lIndex++)
+        {
+            if(CAN_IF_RxFilterSize(p_stlRxFilter[u32_lIndex].u32_mMask, \
+                                   p_stlRxFilter[u32_lIndex].b_mExtended) > 1U)
+            {
+                u32_lMaskedCount++;
+            }
+        }
+        
+        if((u32_lMaskedCount <= u32_fMaskedSlots) && \
+           (p_stfChannel->u32_mRxFilterCount <= (u32_fMaskedSlots + u32_fExactSlots)))
+        {
+            break;
+        }
+        
+        /* Too many masked filters : only merging two of them frees a masked slot */
+        b_lMaskedOnly = (u32_lMaskedCount > u32_fMaskedSlots) ? 1U : 0U;
+        u32_lBestCost = 0xFFFFFFFFUL;
+        for(u32_lIndex = 0U; u32_lIndex < p_stfChannel->u32_mRxFilterCount; u32_lIndex++)
+        {
+            p_stlFilter = &p_stlRxFilter[u32_lIndex];
+            for(u32_lOther = u32_lIndex + 1U; u32_lOther < p_stfChannel->u32_mRxFilterCount; \
+                                                                                    u32_lOther++)
+            {
+                p_stlOther = &p_stlRxFilter[u32_lOther];
+                if((p_stlFilter->b_mExtended != p_stlOther->b_mExtended) || \
+                   ((0U != b_lMaskedOnly) && \
+                    ((1U == CAN_IF_RxFilterSize(p_stlFilter->u32_mMask, p_stlFilter->b_mExtended)) || \
+                     (1U == CAN_IF_RxFilterSize(p_stlOther->u32_mMask, p_stlOther->b_mExtended)))))
+                {
+                    continue;
+                }
+                
+                /* Keep the bits both filters compare and agree on */
+                u32_lMask = p_stlFilter->u32_mMask & p_stlOther->u32_mMask & \
+                                        ~(p_stlFilter->u32_mValue ^ p_stlOther->u32_mValue);
+                u32_lUnion = CAN_IF_RxFilterSize(p_stlFilter->u32_mMask, p_stlFilter->b_mExtended) + \
+                             CAN_IF_RxFilterSize(p_stlOther->u32_mMask, p_stlOther->b_mExtended);
+                if(0U == ((p_stlFilter->u32_mValue ^ p_stlOther->u32_mValue) & \
+                                        p_stlFilter->u32_mMask & p_stlOther->u32_mMask))
+                {
+                    /* Overlapping filters */
+                    u32_lUnion -= CAN_IF_RxFilterSize(p_stlFilter->u32_mMask | \
+                                        p_stlOther->u32_mMask, p_stlFilter->b_mExtended);
+                }
+                u32_lCost = CAN_IF_RxFilterSize(u32_lMask, p_stlFilter->b_mExtended) - u32_lUnion;
+                if(u32_lCost < u32_lBestCost)
+                {
+                    u32_lBestCost = u32_lCost;
+                    u32_lBestIndex = u32_lIndex;
+                    u32_lBestOther = u32_lOther;
+                    u32_lBestMask = u32_lMask;
+                }
+            }
+        }
+        
+        if(0xFFFFFFFFUL == u32_lBestCost)
+        {
+            en_lResult = CAN_IF_ERROR;
+        }
+        else
+        {
+            p_stlFilter = &p_stlRxFilter[u32_lBestIndex];
+            p_stlFilter->u32_mMask = u32_lBestMask;
+            p_stlFilter->u32_mValue &= u32_lBestMask;
+            p_stlFilter->b_mInexact = ((0U != p_stlFilter->b_mInexact) || \
+                                       (0U != p_stlRxFilter[u32_lBestOther].b_mInexact) || \
+                                       (0U != u32_lBestCost)) ? 1U : 0U;
+            p_stfChannel->u32_mRxFilterCount--;
+            p_stlRxFilter[u32_lBestOther] = p_stlRxFilter[p_stfChannel->u32_mRxFilterCount];
+            if(u32_lBestIndex == p_stfChannel->u32_mRxFilterCount)
+            {
+                /* Merged filter was the last one */
+                u32_lBestIndex = u32_lBestOther;
+                p_stlFilter = &p_stlRxFilter[u32_lBestIndex];
+            }
+            
+            /* Drop the filters the merged filter now covers */
+            u32_lOther = 0U;
+            while(u32_lOther < p_stfChannel->u32_mRxFilterCount)
+            {
+                p_stlOther = &p_stlRxFilter[u32_lOther];
+                if((u32_lOther != u32_lBestIndex) && \
+                   (p_stlFilter->b_mExtended == p_stlOther->b_mExtended) && \
+                   (0U == (p_stlFilter->u32_mMask & ~p_stlOther->u32_mMask)) && \
+                   ((p_stlOther->u32_mValue & p_stlFilter->u32_mMask) == p_stlFilter->u32_mValue))
+                {
+                    p_stlFilter->b_mInexact |= p_stlOther->b_mInexact;
+                    p_stfChannel->u32_mRxFilterCount--;
+                    *p_stlOther = p_stlRxFilter[p_stfChannel->u32_mRxFilterCount];
+                    if(u32_lBestIndex == p_stfChannel->u32_mRxFilterCount)
+                    {
+                        u32_lBestIndex = u32_lOther;
+                        p_stlFilter = p_stlOther;
+                    }
+                }
+                else
+                {
+                    u32_lOther++;
+                }
+            }
+        }
+    }
+    
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_PlanRxFilters                                                         */
+/*                                                                                                */
+/* Description     : Compiles the Rx IDs of the configuration table into hardware acceptance     */
+/*                   filters : Rx FIFO filter elements first (FIFO mode), then the Rx mailboxes   */
+/*                   of the table with individual masks. IDs are grouped under shared masks while */
+/*                   exact, then at the lowest cost in extra IDs, which are filtered in software  */
+/*                                                                                                */
+/* In Params       : ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                                 */
+/*                   BOOLEAN b_fRxFifo : Rx FIFO mode                                             */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if the IDs cannot be filtered     */
+/**************************************************************************************************/
+
+static EN_CAN_IF_RESULT_t CAN_IF_PlanRxFilters(ST_CAN_IF_CHANNEL_t * p_stfChannel, \
+                                                                                BOOLEAN b_fRxFifo)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    const flexcan_user_config_t * p_stlUserConfig = p_stfChannel->p_mConfig->p_mUserConfig;
+    ST_CAN_IF_FILTER_t * p_stlRxFilter = &p_stfChannel->st_maRxFilter[0];
+    ST_CAN_IF_FILTER_t * p_stlFilter;
+    INT32U u32_lFifoMasked = 0U;
+    INT32U u32_lFifoElements = 0U;
+    INT32U u32_lFirstMb = 0U;
+    INT32U u32_lNextMasked = 0U;
+    INT32U u32_lNextExact;
+    INT32U u32_lNextMb = 0U;
+    INT32U u32_lPass;
+    INT32U u32_lIndex;
+    INT32U u32_lOther;
+    INT32U u32_lKey;
+    
+    if(0U != b_fRxFifo)
+    {
+        u32_lFifoElements = RxFifoFilterElementNum(p_stlUserConfig->num_id_filters);
+        u32_lFifoMasked = RxFifoIndividualMaskElementNum(p_stlUserConfig->num_id_filters);
+        if(u32_lFifoMasked > u32_lFifoElements)
+        {
+            u32_lFifoMasked = u32_lFifoElements;
+        }
+        u32_lFirstMb = RxFifoOcuppiedLastMsgBuff(p_stlUserConfig->num_id_filters) + 1U;
+    }
+    
+    if(CAN_IF_OK != CAN_IF_CollectRxIds(p_stfChannel, u32_lFirstMb))
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    
+    /* One exact filter per ID */
+    p_stfChannel->u32_mRxFilterCount = p_stfChannel->u32_mRxIdKeyCount;
+    for(u32_lIndex = 0U; u32_lIndex < p_stfChannel->u32_mRxIdKeyCount; u32_lIndex++)
+    {
+        p_stlFilter = &p_stlRxFilter[u32_lIndex];
+        p_stlFilter->b_mExtended = \
+                ((p_stfChannel->u32_maRxIdKey[u32_lIndex] & CAN_IF_EXT_ID_KEY) != 0U) ? 1U : 0U;
+        p_stlFilter->u32_mMask = (0U != p_stlFilter->b_mExtended) ? CAN_IF_EXT_ID_MASK : CAN_IF_STD_ID_MASK;
+        p_stlFilter->u32_mValue = p_stfChannel->u32_maRxIdKey[u32_lIndex] & p_stlFilter->u32_mMask;
+        p_stlFilter->b_mInexact = 0U;
+        p_stlFilter->b_mInFifo = 0U;
+        p_stlFilter->u8_mSlot = 0U;
+    }
+    
+    /* Masked entries are filters as given */
+    for(u32_lIndex = 0U; u32_lIndex < p_stfChannel->u32_mRxRangeCount; u32_lIndex++)
+    {
+        p_stlRxFilter[p_stfChannel->u32_mRxFilterCount] = p_stfChannel->st_maRxRange[u32_lIndex];
+        p_stfChannel->u32_mRxFilterCount++;
+    }
+    
+    CAN_IF_MergeExactRxFilters(p_stfChannel);
+    
+    if(CAN_IF_OK != CAN_IF_FitRxFilters(p_stfChannel, \
+                                        u32_lFifoMasked + p_stfChannel->u32_mRxPoolMbCount, \
+                                        u32_lFifoElements - u32_lFifoMasked))
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    
+    /* Masked filters first (FIFO masked elements, then MBs), then the exact filters */
+    /* (FIFO exact elements, then whatever is left)                                  */
+    u32_lNextExact = u32_lFifoMasked;
+    for(u32_lPass = 0U; (u32_lPass < 2U) && (CAN_IF_OK == en_lResult); u32_lPass++)
+    {
+        for(u32_lIndex = 0U; u32_lIndex < p_stfChannel->u32_mRxFilterCount; u32_lIndex++)
+        {
+            p_stlFilter = &p_stlRxFilter[u32_lIndex];
+            if((CAN_IF_RxFilterSize(p_stlFilter->u32_mMask, p_stlFilter->b_mExtended) > 1U) == \
+                                                                            (0U != u32_lPass))
+            {
+                continue;
+            }
+            
+            if((0U != u32_lPass) && (u32_lNextExact < u32_lFifoElements))
+            {
+                p_stlFilter->b_mInFifo = 1U;
+                p_stlFilter->u8_mSlot = (INT8U)u32_lNextExact;
+                u32_lNextExact++;
+            }
+            else if(u32_lNextMasked < u32_lFifoMasked)
+            {
+                p_stlFilter->b_mInFifo = 1U;
+                p_stlFilter->u8_mSlot = (INT8U)u32_lNextMasked;
+                u32_lNextMasked++;
+            }
+            else
+            {
+                p_stlFilter->b_mInFifo = 0U;
+                p_stlFilter->u8_mSlot = p_stfChannel->u8_maRxPoolMb[u32_lNextMb];
+                u32_lNextMb++;
+            }
+        }
+    }
+    
+    /* Configured IDs sharing an inexact filter */
+    p_stfChannel->u32_mSwFilterIdCount = 0U;
+    for(u32_lIndex = 0U; u32_lIndex < p_stfChannel->u32_mRxIdKeyCount; u32_lIndex++)
+    {
+        u32_lKey = p_stfChannel->u32_maRxIdKey[u32_lIndex];
+        for(u32_lOther = 0U; u32_lOther < p_stfChannel->u32_mRxFilterCount; u32_lOther++)
+        {
+            p_stlFilter = &p_stlRxFilter[u32_lOther];
+            if((((u32_lKey & CAN_IF_EXT_ID_KEY) != 0U) == (0U != p_stlFilter->b_mExtended)) && \
+               ((u32_lKey & p_stlFilter->u32_mMask) == p_stlFilter->u32_mValue))
+            {
+                if(0U != p_stlFilter->b_mInexact)
+                {
+                    p_stfChannel->u32_maSwFilterId[p_stfChannel->u32_mSwFilterIdCount] = u32_lKey;
+                    p_stfChannel->u32_mSwFilterIdCount++;
+                }
+                break;
+            }
+        }
+    }
+    
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_RxInitMailBoxes                                                       */
+/*                                                                                                */
+/* Description     : Configures the Rx mailboxes of the planned filters once and leaves them     */
+/*                   armed, the FlexCAN ISR only reads and unlocks them                           */
+/*                                                                                                */
+/* In Params       : ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                                 */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if a mailbox could not be armed    */
+/**************************************************************************************************/
+
+static EN_CAN_IF_RESULT_t CAN_IF_RxInitMailBoxes(const ST_CAN_IF_CHANNEL_t * p_stfChannel)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    const ST_CAN_IF_FILTER_t * p_stlFilter;
+    INT8U u8_lInstance = p_stfChannel->u8_mInstance;
+    INT32U u32_lIndex;
+    
+    g_dataInfo_rx.data_length = 0U;
+    g_dataInfo_rx.enable_brs = false;
+    g_dataInfo_rx.fd_enable = p_stfChannel->p_mConfig->p_mUserConfig->fd_enable;
+    g_dataInfo_rx.fd_padding = 0U;
+    
+    for(u32_lIndex = 0U; u32_lIndex < p_stfChannel->u32_mRxFilterCount; u32_lIndex++)
+    {
+        p_stlFilter = &p_stfChannel->st_maRxFilter[u32_lIndex];
+        if(0U == p_stlFilter->b_mInFifo)
+        {
+            g_dataInfo_rx.msg_id_type = (0U != p_stlFilter->b_mExtended) ? \
+                                                        FLEXCAN_MSG_ID_EXT : FLEXCAN_MSG_ID_STD;
+            
+            /* Configure the MB EMPTY, then keep it armed : frames are delivered through */
+            /* the driver slots                                                          */
+            if((FLEXCAN_STATUS_SUCCESS != FLEXCAN_DRV_SetRxIndividualMask(u8_lInstance, \
+                    g_dataInfo_rx.msg_id_type, p_stlFilter->u8_mSlot, p_stlFilter->u32_mMask)) || \
+               (FLEXCAN_STATUS_SUCCESS != FLEXCAN_DRV_ConfigRxMb(u8_lInstance, \
+                    p_stlFilter->u8_mSlot, &g_dataInfo_rx, p_stlFilter->u32_mValue)) || \
+               (FLEXCAN_STATUS_SUCCESS != FLEXCAN_DRV_RxMessageBuffer(u8_lInstance, \
+                    p_stlFilter->u8_mSlot, NULL)))
+            {
+                en_lResult = CAN_IF_ERROR;
+            }
+        }
+        else
+        {
+            /* No Action */
+        }
+    }
+    
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_RxInitFifo                                                            */
+/*                                                                                                */
+/* Description     : Loads the planned Rx FIFO filter elements, unused elements repeat the first */
+/*                   filter so that they accept nothing more                                      */
+/*                                                                                                */
+/* In Params       : ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                                 */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if the FIFO could not be set       */
+/**************************************************************************************************/
+
+static EN_CAN_IF_RESULT_t CAN_IF_RxInitFifo(ST_CAN_IF_CHANNEL_t * p_stfChannel)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    const flexcan_user_config_t * p_stlUserConfig = p_stfChannel->p_mConfig->p_mUserConfig;
+    const ST_CAN_IF_FILTER_t * p_stlRxFilter = &p_stfChannel->st_maRxFilter[0];
+    const ST_CAN_IF_FILTER_t * p_stlFirst = PNULL;
+    const ST_CAN_IF_FILTER_t * p_stlFilter;
+    INT8U u8_lInstance = p_stfChannel->u8_mInstance;
+    flexcan_id_table_t st_lFifoTable;
+    INT32U u32_lFifoElements = RxFifoFilterElementNum(p_stlUserConfig->num_id_filters);
+    INT32U u32_lFifoMasked = RxFifoIndividualMaskElementNum(p_stlUserConfig->num_id_filters);
+    INT32U u32_lElement;
+    INT32U u32_lIndex;
+    INT32U u32_lMask;
+    
+    for(u32_lIndex = 0U; (u32_lIndex < p_stfChannel->u32_mRxFilterCount) && \
+                         (PNULL == p_stlFirst); u32_lIndex++)
+    {
+        if(0U != p_stlRxFilter[u32_lIndex].b_mInFifo)
+        {
+            p_stlFirst = &p_stlRxFilter[u32_lIndex];
+        }
+    }
+    
+    st_lFifoTable.isRemoteFrame = false;
+    st_lFifoTable.isExtendedFrame = (PNULL != p_stlFirst) && (0U != p_stlFirst->b_mExtended);
+    st_lFifoTable.idFilter = &p_stfChannel->u32_maRxFifoIdFilter[0];
+    
+    if(PNULL == p_stlFirst)
+    {
+        /* No ID for the FIFO : reject every frame */
+        if(FLEXCAN_STATUS_SUCCESS != FLEXCAN_DRV_ConfigRxFifo(u8_lInstance, \
+                                                FLEXCAN_RX_FIFO_ID_FORMAT_D, &st_lFifoTable))
+        {
+            en_lResult = CAN_IF_ERROR;
+        }
+    }
+    else
+    {
+        for(u32_lElement = 0U; u32_lElement < u32_lFifoElements; u32_lElement++)
+        {
+            p_stfChannel->u32_maRxFifoIdFilter[u32_lElement] = p_stlFirst->u32_mValue;
+        }
+        if(FLEXCAN_STATUS_SUCCESS != FLEXCAN_DRV_ConfigRxFifo(u8_lInstance, \
+                                                FLEXCAN_RX_FIFO_ID_FORMAT_A, &st_lFifoTable))
+        {
+            en_lResult = CAN_IF_ERROR;
+        }
+        
+        for(u32_lElement = 0U; u32_lElement < u32_lFifoElements; u32_lElement++)
+        {
+            p_stlFilter = p_stlFirst;
+            for(u32_lIndex = 0U; u32_lIndex < p_stfChannel->u32_mRxFilterCount; u32_lIndex++)
+            {
+                if((0U != p_stlRxFilter[u32_lIndex].b_mInFifo) && \
+                   (p_stlRxFilter[u32_lIndex].u8_mSlot == u32_lElement))
+                {
+                    p_stlFilter = &p_stlRxFilter[u32_lIndex];
+                }
+            }
+            
+            /* Elements past the individual masks only compare full IDs */
+            u32_lMask = p_stlFilter->u32_mMask;
+            if(u32_lElement >= u32_lFifoMasked)
+            {
+                u32_lMask = (0U != p_stlFilter->b_mExtended) ? CAN_IF_EXT_ID_MASK : CAN_IF_STD_ID_MASK;
+            }
+            if(FLEXCAN_STATUS_SUCCESS != FLEXCAN_DRV_SetRxFifoFilterElement(u8_lInstance, \
+                    u32_lElement, (0U != p_stlFilter->b_mExtended) ? FLEXCAN_MSG_ID_EXT : \
+                    FLEXCAN_MSG_ID_STD, p_stlFilter->u32_mValue, u32_lMask))
+            {
+                en_lResult = CAN_IF_ERROR;
+            }
+        }
+    }
+    
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_GetFilterReport                                                       */
+/*                                                                                                */
+/* Description     : Result of the acceptance filter planning done by CAN_IF_Init for a channel   */
+/*                                                                                                */
+/* In Params       : INT8U u8_fChannel : Channel                                                  */
+/*                                                                                                */
+/* Out Params      : ST_CAN_IF_FILTER_REPORT_t * p_stfReport : Filter count, software filtered   */
+/*                   IDs (bit 31 set for an extended ID)                                          */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if the channel is not used         */
+/**************************************************************************************************/
+
+EN_CAN_IF_RESULT_t CAN_IF_GetFilterReport(INT8U u8_fChannel, ST_CAN_IF_FILTER_REPORT_t * p_stfReport)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    const ST_CAN_IF_CHANNEL_t * p_stlChannel = CAN_IF_GetChannel(u8_fChannel);
+    INT32U u32_lIndex;
+    
+    if(PNULL == p_stlChannel)
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    else
+    {
+        p_stfReport->u32_mFilterCount = p_stlChannel->u32_mRxFilterCount;
+        p_stfReport->u32_mInexactCount = 0U;
+        for(u32_lIndex = 0U; u32_lIndex < p_stlChannel->u32_mRxFilterCount; u32_lIndex++)
+        {
+            if(0U != p_stlChannel->st_maRxFilter[u32_lIndex].b_mInexact)
+            {
+                p_stfReport->u32_mInexactCount++;
+            }
+        }
+        p_stfReport->u32_mSwFilterIdCount = p_stlChannel->u32_mSwFilterIdCount;
+        p_stfReport->p_mSwFilterIds = &p_stlChannel->u32_maSwFilterId[0];
+    }
+    
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_GetCyclicOffset                                                       */
+/*                                                                                                */
+/* Description     : Start offset chosen by CAN_IF_Init for a cyclic Tx entry, relative to the    */
+/*                   start of the scheduler tick                                                  */
+/*                                                                                                */
+/* In Params       : INT8U u8_fChannel : Channel                                                  */
+/*                   INT16U u16_fPduHandle : Entry index in st_gMailBoxConfig                     */
+/*                                                                                                */
+/* Out Params      : INT32U * p_fOffset : Offset in ms                                            */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if the entry is not cyclic on the  */
+/*                   channel                                                                      */
+/**************************************************************************************************/
+
+EN_CAN_IF_RESULT_t CAN_IF_GetCyclicOffset(INT8U u8_fChannel, INT16U u16_fPduHandle, \
+                                                                        INT32U * p_fOffset)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_ERROR;
+#if (CAN_IF_CYCLIC_TX == 1U)
+    const ST_CAN_IF_CHANNEL_t * p_stlChannel = CAN_IF_GetChannel(u8_fChannel);
+    INT32U u32_lIndex;
+    
+    if(PNULL != p_stlChannel)
+    {
+        for(u32_lIndex = 0U; u32_lIndex < p_stlChannel->u8_mCyclicCount; u32_lIndex++)
+        {
+            if(u16_fPduHandle == p_stlChannel->st_maCyclic[u32_lIndex].u16_mPduHandle)
+            {
+                *p_fOffset = (p_stlChannel->st_maCyclic[u32_lIndex].u32_mOffset * \
+                                                                   CAN_IF_TICK_US) / 1000UL;
+                en_lResult = CAN_IF_OK;
+            }
+        }
+    }
+#else
+    (void)u8_fChannel;
+    (void)u16_fPduHandle;
+    (void)p_fOffset;
+#endif
+    
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_SetBitTiming                                                          */
+/*                                                                                                */
+/* Description     : Solves the bit timing for the FlexCAN PE clock and programs it, the solution */
+/*                   is refused if a bit rate error exceeds CAN_IF_BITRATE_TOLERANCE              */
+/*                                                                                                */
+/* In Params       : INT8U u8_fChannel : Channel                                                  */
+/*                   INT32U u32_fBitrate : Nominal bit rate in bit/s                              */
+/*                   INT32U u32_fSamplePoint : Nominal sample point in per mille                  */
+/*                   INT32U u32_fSjw : Nominal resync jump width in tq, 0 : largest possible      */
+/*                   INT32U u32_fFdBitrate : FD data phase bit rate in bit/s, 0 : none            */
+/*                   INT32U u32_fFdSamplePoint : Data phase sample point in per mille             */
+/*                   INT32U u32_fFdSjw : Data phase resync jump width in tq, 0 : largest possible */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if the bit rates cannot be reached */
+/**************************************************************************************************/
+
+EN_CAN_IF_RESULT_t CAN_IF_SetBitTiming(INT8U u8_fChannel, INT32U u32_fBitrate, \
+                INT32U u32_fSamplePoint, INT32U u32_fSjw, INT32U u32_fFdBitrate, \
+                INT32U u32_fFdSamplePoint, INT32U u32_fFdSjw)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    ST_CAN_IF_CHANNEL_t * p_stlChannel = CAN_IF_GetChannel(u8_fChannel);
+    flexcan_bit_timing_config_t st_lConfig;
+    flexcan_bit_timing_t st_lTiming;
+    uint32_t u32_lPeClock;
+    
+    st_lConfig.bitrate = u32_fBitrate;
+    st_lConfig.samplePoint = u32_fSamplePoint;
+    st_lConfig.sjw = u32_fSjw;
+    st_lConfig.bitrateFd = u32_fFdBitrate;
+    st_lConfig.samplePointFd = u32_fFdSamplePoint;
+    st_lConfig.sjwFd = u32_fFdSjw;
+    
+    /* Solve first, nothing is programmed if the error is out of tolerance */
+    if(PNULL == p_stlChannel)
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    else if((FLEXCAN_STATUS_SUCCESS != \
+                FLEXCAN_DRV_GetPeClockFreq(p_stlChannel->u8_mInstance, &u32_lPeClock)) || \
+            (FLEXCAN_STATUS_SUCCESS != \
+                FLEXCAN_DRV_ComputeBitTiming(u32_lPeClock, &st_lConfig, &st_lTiming)))
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    else if((CAN_IF_ABS(st_lTiming.bitrateError) > CAN_IF_BITRATE_TOLERANCE) || \
+            (CAN_IF_ABS(st_lTiming.bitrateErrorFd) > CAN_IF_BITRATE_TOLERANCE))
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    else
+    {
+        FLEXCAN_DRV_SetBitrate(p_stlChannel->u8_mInstance, &st_lTiming.nominal);
+        if((0U != u32_fFdBitrate) && (FLEXCAN_STATUS_SUCCESS != \
+                FLEXCAN_DRV_SetBitrateCbt(p_stlChannel->u8_mInstance, &st_lTiming.data)))
+        {
+            en_lResult = CAN_IF_ERROR;
+        }
+        p_stlChannel->st_mBitTiming = st_lTiming;
+    }
+    
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_GetBitTiming                                                          */
+/*                                                                                                */
+/* Description     : Bit timing programmed by CAN_IF_SetBitTiming : time segments, achieved bit  */
+/*                   rates, their error in ppm and sample points                                  */
+/*                                                                                                */
+/* In Params       : INT8U u8_fChannel : Channel                                                  */
+/*                                                                                                */
+/* Out Params      : flexcan_bit_timing_t * p_stfTiming : Bit timing                              */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if the channel is not used         */
+/**************************************************************************************************/
+
+EN_CAN_IF_RESULT_t CAN_IF_GetBitTiming(INT8U u8_fChannel, flexcan_bit_timing_t * p_stfTiming)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    const ST_CAN_IF_CHANNEL_t * p_stlChannel = CAN_IF_GetChannel(u8_fChannel);
+    
+    if(PNULL == p_stlChannel)
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    else
+    {
+        *p_stfTiming = p_stlChannel->st_mBitTiming;
+    }
+    
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_RespInitMailBoxes                                                     */
+/*                                                                                                */
+/* Description     : Arms the remote request auto-response mailboxes of the configuration table   */
+/*                   with an all zero payload, the application updates it in place                */
+/*                                                                                                */
+/* In Params       : ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                                 */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if a mailbox could not be armed    */
+/**************************************************************************************************/
+
+static EN_CAN_IF_RESULT_t CAN_IF_RespInitMailBoxes(ST_CAN_IF_CHANNEL_t * p_stfChannel)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    const ST_MAILBOX_CONFIG_t * p_stlConfig = &st_gMailBoxConfig[0];
+    ST_CAN_IF_RESPONSE_MB_t * p_stlMailBox;
+    flexcan_data_info_t st_lDataInfo;
+    INT8U u8_laZero[8] = {0};
+    INT8U u8_lInstance = p_stfChannel->u8_mInstance;
+    
+    p_stfChannel->u8_mRespMailBoxCount = 0;
+    
+    while(1)
+    {
+        if((EN_MAILBOX_TRANSMIT == p_stlConfig->en_mMailBoxDirection) && \
+           (CAN_REMOTE_FRAME == p_stlConfig->en_mFrameType) && \
+           (u8_lInstance == p_stlConfig->u8_mCanNode))
+        {
+            st_lDataInfo.msg_id_type = (EN_FLEXCAN_MSG_ID_EXT == \
+                                        p_stlConfig->st_mFlexCanDataInfo.en_mMsgIdType) ? \
+                                                        FLEXCAN_MSG_ID_EXT : FLEXCAN_MSG_ID_STD;
+            st_lDataInfo.data_length = p_stlConfig->st_mFlexCanDataInfo.u8_mDataLength;
+            st_lDataInfo.fd_enable = 0U;
+            st_lDataInfo.enable_brs = 0U;
+            st_lDataInfo.fd_padding = 0U;
+            
+            /* Remote frames are classic frames, the request must match the whole ID */
+            if((p_stfChannel->u8_mRespMailBoxCount >= CAN_IF_RESPONSE_MB_MAX) || \
+               (0U != p_stlConfig->st_mFlexCanDataInfo.u8_mFdEnable) || \
+               (FLEXCAN_STATUS_SUCCESS != FLEXCAN_DRV_SetRxIndividualMask(u8_lInstance, \
+                    st_lDataInfo.msg_id_type, p_stlConfig->u8_mMailBoxIndex, \
+                    (FLEXCAN_MSG_ID_EXT == st_lDataInfo.msg_id_type) ? \
+                                                    CAN_IF_EXT_ID_MASK : CAN_IF_STD_ID_MASK)) || \
+               (FLEXCAN_STATUS_SUCCESS != FLEXCAN_DRV_ConfigRemoteResponseMb(u8_lInstance, \
+                    p_stlConfig->u8_mMailBoxIndex, &st_lDataInfo, p_stlConfig->u32_mMsgID, \
+                                                                                    u8_laZero)))
+            {
+                en_lResult = CAN_IF_ERROR;
+            }
+            else
+            {
+                p_stlMailBox = &p_stfChannel->st_maRespMailBox[p_stfChannel->u8_mRespMailBoxCount];
+                p_stlMailBox->u32_mCANID = p_stlConfig->u32_mMsgID;
+                p_stlMailBox->u8_mMailBoxIndex = p_stlConfig->u8_mMailBoxIndex;
+                p_stfChannel->u8_mRespMailBoxCount++;
+            }
+        }
+        else
+        {
+            /* No Action */
+        }
+        
+        if(p_stlConfig->u8_EOL)
+        {
+            break;
+        }
+        p_stlConfig++;
+    }
+    
+    return en_lResult;
+}
+
+#if (CAN_IF_CYCLIC_TX == 1U)
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_Gcd                                                                   */
+/*                                                                                                */
+/* Description     : Greatest common divisor of two cycle times                                   */
+/*                                                                                                */
+/* In Params       : INT32U u32_fA : Cycle time in ticks, not 0                                   */
+/*                   INT32U u32_fB : Cycle time in ticks, not 0                                   */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT32U : gcd(u32_fA, u32_fB)                                                 */
+/**************************************************************************************************/
+
+static INT32U CAN_IF_Gcd(INT32U u32_fA, INT32U u32_fB)
+{
+    INT32U u32_lRest;
+    
+    while(0U != u32_fB)
+    {
+        u32_lRest = u32_fA % u32_fB;
+        u32_fA = u32_fB;
+        u32_fB = u32_lRest;
+    }
+    
+    return u32_fA;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_CyclicOffset                                                          */
+/*                                                                                                */
+/* Description     : Chooses the start offset of a cyclic entry against the entries placed before */
+/*                   it. Two entries share a tick every lcm of their cycle times if their offsets */
+/*                   are congruent modulo the gcd of the cycle times, else they always stay the   */
+/*                   distance of the offsets modulo the gcd apart. The offset kept is the one     */
+/*                   farthest from every other entry, then the one sharing the fewest bits per    */
+/*                   tick with the other entries.                                                 */
+/*                                                                                                */
+/* In Params       : const ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                           */
+/*                   INT32U u32_fIndex : Entry in st_maCyclic, the entries before it are placed   */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT32U : Offset in ticks, lower than the cycle time of the entry             */
+/**************************************************************************************************/
+
+static INT32U CAN_IF_CyclicOffset(const ST_CAN_IF_CHANNEL_t * p_stfChannel, INT32U u32_fIndex)
+{
+    const ST_CAN_IF_CYCLIC_PDU_t * p_stlPdu = &p_stfChannel->st_maCyclic[u32_fIndex];
+    const ST_CAN_IF_CYCLIC_PDU_t * p_stlOther;
+    INT32U u32_lBestOffset = 0U;
+    INT32U u32_lBestGap = 0U;
+    INT32U u32_lBestLoad = 0xFFFFFFFFUL;
+    INT32U u32_lOffset;
+    INT32U u32_lGap;
+    INT32U u32_lLoad;
+    INT32U u32_lGcd;
+    INT32U u32_lDistance;
+    INT32U u32_lBits;
+    INT32U u32_lIndex;
+    
+    for(u32_lOffset = 0U; u32_lOffset < p_stlPdu->u32_mPeriod; u32_lOffset++)
+    {
+        u32_lGap = 0xFFFFFFFFUL;
+        u32_lLoad = 0U;
+        
+        for(u32_lIndex = 0U; u32_lIndex < u32_fIndex; u32_lIndex++)
+        {
+            p_stlOther = &p_stfChannel->st_maCyclic[u32_lIndex];
+            u32_lGcd = CAN_IF_Gcd(p_stlPdu->u32_mPeriod, p_stlOther->u32_mPeriod);
+            u32_lDistance = ((u32_lOffset % u32_lGcd) + u32_lGcd - \
+                                            (p_stlOther->u32_mOffset % u32_lGcd)) % u32_lGcd;
+            if((u32_lGcd - u32_lDistance) < u32_lDistance)
+            {
+                u32_lDistance = u32_lGcd - u32_lDistance;
+            }
+            
+            if(u32_lDistance < u32_lGap)
+            {
+                u32_lGap = u32_lDistance;
+            }
+            
+            if(0U == u32_lDistance)
+            {
+                /* Bits of the other frame, times the share of the ticks of this entry it uses */
+                u32_lBits = CAN_IF_CYCLIC_FRAME_BITS(st_gMailBoxConfig[ \
+                                p_stlOther->u16_mPduHandle].st_mFlexCanDataInfo.u8_mDataLength);
+                u32_lLoad += (u32_lBits << 8) / (p_stlOther->u32_mPeriod / u32_lGcd);
+            }
+        }
+        
+        if((u32_lGap > u32_lBestGap) || ((u32_lGap == u32_lBestGap) && (u32_lLoad < u32_lBestLoad)))
+        {
+            u32_lBestOffset = u32_lOffset;
+            u32_lBestGap = u32_lGap;
+            u32_lBestLoad = u32_lLoad;
+        }
+    }
+    
+    return u32_lBestOffset;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_CyclicInit                                                            */
+/*                                                                                                */
+/* Description     : Collects the cyclic Tx entries of a channel, shortest cycle time first, and  */
+/*                   spreads their start offsets over the scheduler ticks                         */
+/*                                                                                                */
+/* In Params       : ST_CAN_IF_CHANNEL_t * p_stfChannel : Channel                                 */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if there are more than             */
+/*                   CAN_IF_CYCLIC_MAX cyclic entries or a cycle time is not a multiple of the    */
+/*                   tick                                                                         */
+/**************************************************************************************************/
+
+static EN_CAN_IF_RESULT_t CAN_IF_CyclicInit(ST_CAN_IF_CHANNEL_t * p_stfChannel)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    const ST_MAILBOX_CONFIG_t * p_stlConfig = &st_gMailBoxConfig[0];
+    ST_CAN_IF_CYCLIC_PDU_t * p_stlPdu;
+    ST_CAN_IF_CYCLIC_PDU_t st_lPdu;
+    INT32U u32_lCycleUs;
+    INT32U u32_lIndex;
+    INT16U u16_lHandle = 0U;
+    
+    p_stfChannel->u8_mCyclicCount = 0U;
+    
+    while(1)
+    {
+        if((p_stfChannel->u8_mInstance == p_stlConfig->u8_mCanNode) && \
+           (EN_MAILBOX_TRANSMIT == p_stlConfig->en_mMailBoxDirection) && \
+           (CAN_DATA_FRAME == p_stlConfig->en_mFrameType) && (0U != p_stlConfig->u16_mCycleTime))
+        {
+            u32_lCycleUs = (INT32U)p_stlConfig->u16_mCycleTime * 1000UL;
+            
+            if((p_stfChannel->u8_mCyclicCount >= CAN_IF_CYCLIC_MAX) || \
+               (0U != (u32_lCycleUs % CAN_IF_TICK_US)))
+            {
+                en_lResult = CAN_IF_ERROR;
+            }
+            else
+            {
+                /* Insertion by cycle time */
+                memset((void *)&st_lPdu, 0, sizeof(st_lPdu));
+                st_lPdu.u16_mPduHandle = u16_lHandle;
+                st_lPdu.u32_mPeriod = u32_lCycleUs / CAN_IF_TICK_US;
+                
+                u32_lIndex = p_stfChannel->u8_mCyclicCount;
+                p_stlPdu = &p_stfChannel->st_maCyclic[u32_lIndex];
+                while((u32_lIndex > 0U) && ((p_stlPdu - 1)->u32_mPeriod > st_lPdu.u32_mPeriod))
+                {
+                    *p_stlPdu = *(p_stlPdu - 1);
+                    p_stlPdu--;
+                    u32_lIndex--;
+                }
+                *p_stlPdu = st_lPdu;
+                p_stfChannel->u8_mCyclicCount++;
+            }
+        }
+        
+        if(p_stlConfig->u8_EOL)
+        {
+            break;
+        }
+        p_stlConfig++;
+        u16_lHandle++;
+    }
+    
+    /* The shortest cycles have the fewest free ticks, they are placed first */
+    for(u32_lIndex = 0U; u32_lIndex < p_stfChannel->u8_mCyclicCount; u32_lIndex++)
+    {
+        p_stlPdu = &p_stfChannel->st_maCyclic[u32_lIndex];
+        p_stlPdu->u32_mOffset = CAN_IF_CyclicOffset(p_stfChannel, u32_lIndex);
+        
+        /* First transmission on the tick of the offset */
+        p_stlPdu->u32_mCountdown = p_stlPdu->u32_mOffset + 1U;
+    }
+    
+    return en_lResult;
+}
+#endif
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_TickStart                                                             */
+/*                                                                                                */
+/* Description     : Starts the LPIT0 channel of the CAN IF tick, even without cyclic entries :   */
+/*                   the tick keeps waking the main loop for the bus off recovery and the time    */
+/*                   stamp extension                                                              */
+/*                                                                                                */
+/* In Params       : None                                                                         */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if the tick cannot be programmed   */
+/**************************************************************************************************/
+
+static EN_CAN_IF_RESULT_t CAN_IF_TickStart(void)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    const lpit_user_config_t st_lLpitConfig =
+    {
+        .enableRunInDebug = false,
+        .enableRunInDoze = true
+    };
+    const lpit_user_channel_config_t st_lTickConfig =
+    {
+        .chainChannel = false,
+        .isInterruptEnabled = true,
+        .timerMode = LPIT_PERIODIC_COUNTER,
+        .triggerSource = LPIT_TRIGGER_SOURCE_INTERNAL,
+        .triggerSelect = CAN_IF_TICK_LPIT_CHANNEL,
+        .enableReloadOnTrigger = false,
+        .enableStopOnInterrupt = false,
+        .enableStartOnTrigger = false,
+        .periodUs = CAN_IF_TICK_US
+    };
+    
+    /* Periodic counter, its period is set by LPIT_DRV_SetTimerPeriodByUs() */
+    if((LPIT_STATUS_SUCCESS != LPIT_DRV_Init(CAN_IF_LPIT_INSTANCE, &st_lLpitConfig)) || \
+       (LPIT_STATUS_SUCCESS != LPIT_DRV_InitChannel(CAN_IF_LPIT_INSTANCE, \
+                                                  CAN_IF_TICK_LPIT_CHANNEL, &st_lTickConfig)))
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    else
+    {
+        LPIT_DRV_StartTimerChannels(CAN_IF_LPIT_INSTANCE, (1UL << CAN_IF_TICK_LPIT_CHANNEL));
+    }
+    
+    return en_lResult;
+}
+
+#if (CAN_IF_GATEWAY == 1U)
 /**************************************************************************************************/
-/* Function Name   : CAN_IF_MsgTxHandler                                                          */
+/* Function Name   : CAN_IF_GwStart                                                               */
 /*                                                                                                */
-/* Description     : Call back function called from CAN Low Level Driver                          */
+/* Description     : Checks the gateway routes against the initialized channels, converts their   */
+/*                   rate limits to bit times of the source channel and resets their counters.    */
+/*                   Forwarding starts only if every route is valid.                              */
 /*                                                                                                */
-/* In Params       : INT16U u16_fMsgID : Transmitted Message ID                                   */
+/* In Params       : None                                                                         */
 /*                                                                                                */
 /* Out Params      : None                                                                         */
 /*                                                                                                */
-/* Return Value    : void                                                                         */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if a route has an uninitialized    */
+/*                   channel, no destination, or forwards IDs that a route of a destination       */
+/*                   channel matches again                                                        */
 /**************************************************************************************************/
 
-void CAN_TX_Confirmation(mailBox_t * p_fMsgInfo)
+static EN_CAN_IF_RESULT_t CAN_IF_GwStart(void)
 {
-    /* Check if the Mag trasmitted Belong to ISOTP or COM */
-    if(p_fMsgInfo->mb_msgId == u16_gUdsRespID)
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    const ST_CAN_IF_GW_ROUTE_CONFIG_t * p_stlConfig;
+    const ST_CAN_IF_CHANNEL_t * p_stlChannel;
+    ST_CAN_IF_GW_ROUTE_t * p_stlGwRoute;
+    const ST_CAN_IF_GW_ROUTE_t * p_stlOther;
+    INT32U u32_lOutKey;
+    INT32U u32_lOutMask;
+    INT32U u32_lRoute;
+    INT32U u32_lOther;
+    INT8U u8_lChannel;
+    
+    for(u32_lRoute = 0U; u32_lRoute < CAN_IF_GW_ROUTE_NUM; u32_lRoute++)
     {
-        /* Call back to ISO TP Layers */
-        if(PNULL != fp_gIsoTpTxHandler)
+        p_stlConfig = &st_gaGwRouteConfig[u32_lRoute];
+        p_stlGwRoute = &st_gaGwRoute[u32_lRoute];
+        p_stlChannel = CAN_IF_GetChannel(p_stlConfig->u8_mSrcChannel);
+        
+        if((PNULL == p_stlChannel) || (0U == p_stlConfig->u8_mDstChannels) || \
+           (0U != (p_stlConfig->u8_mDstChannels >> CAN_IF_CHANNEL_NUM)))
         {
-            fp_gIsoTpTxHandler(p_fMsgInfo->mb_msgId);
+            en_lResult = CAN_IF_ERROR;
+            continue;
         }
-        else
+        for(u8_lChannel = 0; u8_lChannel < CAN_IF_CHANNEL_NUM; u8_lChannel++)
         {
-            /* No Action */
+            if((0U != (p_stlConfig->u8_mDstChannels & (1U << u8_lChannel))) && \
+               (PNULL == CAN_IF_GetChannel(u8_lChannel)))
+            {
+                en_lResult = CAN_IF_ERROR;
+            }
+        }
+        
+        /* A forwarded frame comes back on its destination channel (self reception, loopback) :  */
+        /* it must not match a route of that channel, or it would be forwarded again without end */
+        u32_lOutMask = p_stlGwRoute->u32_mKeyMask | p_stlGwRoute->u32_mDstMask;
+        u32_lOutKey = (p_stlGwRoute->u32_mKey & ~p_stlGwRoute->u32_mDstMask) | \
+                                                                    p_stlGwRoute->u32_mDstID;
+        for(u32_lOther = 0U; u32_lOther < CAN_IF_GW_ROUTE_NUM; u32_lOther++)
+        {
+            p_stlOther = &st_gaGwRoute[u32_lOther];
+            if((0U != (p_stlConfig->u8_mDstChannels & \
+                                    (1U << st_gaGwRouteConfig[u32_lOther].u8_mSrcChannel))) && \
+               (0U == ((u32_lOutKey ^ p_stlOther->u32_mKey) & u32_lOutMask & \
+                                                                p_stlOther->u32_mKeyMask)))
+            {
+                en_lResult = CAN_IF_ERROR;
+            }
         }
+        
+        p_stlGwRoute->u32_mMinInterval = (INT32U)(((INT64U)p_stlConfig->u32_mMinIntervalUs * \
+                                        p_stlChannel->st_mBitTiming.bitrate) / 1000000ULL);
+        p_stlGwRoute->u32_mLastForward = 0U;
+        p_stlGwRoute->b_mForwarded = 0U;
+        memset((void *)&p_stlGwRoute->st_mStats, 0, sizeof(ST_CAN_IF_GW_STATS_t));
+    }
+    
+    if(CAN_IF_OK == en_lResult)
+    {
+        b_gGwEnabled = 1U;
     }
     else
     {
-        /* Update to OSEK COM */
-        if(PNULL != fp_gComTxConformation)
-        {
-            fp_gComTxConformation(p_fMsgInfo->mb_msgId);
-        }
-        else
-        {
-            /* No Action */
-        }
+        /* No Action */
     }
+    
+    return en_lResult;
 }
+#endif
 
 /**************************************************************************************************/
-/* Function Name   : CAN_IF_MsgRxHandler                                                          */
+/* Function Name   : CAN_IF_CheckMailBoxConfig                                                    */
 /*                                                                                                */
-/* Description     : Call back function called from CAN Low Level Driver                          */
+/* Description     : Checks the entries of a channel in the configuration table before anything   */
+/*                   is programmed : ID and frame format, mailbox index against the controller    */
+/*                   and the Rx FIFO area, mailbox index used by a single entry. The MB index of  */
+/*                   an Rx entry only offers the MB to the filter planner, out of range it is not */
+/*                   used                                                                         */
 /*                                                                                                */
-/* In Params       : void * p_fRxMsgData : Receive CAN Message Data pointer                       */
+/* In Params       : INT8U u8_fChannel : Channel, its entry of st_gaChannelConfig is used         */
 /*                                                                                                */
 /* Out Params      : None                                                                         */
 /*                                                                                                */
-/* Return Value    : void                                                                         */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR on the first conflicting entry     */
 /**************************************************************************************************/
 
-void CAN_Rx_Notification(mailBox_t * p_fMsgInfo)
+static EN_CAN_IF_RESULT_t CAN_IF_CheckMailBoxConfig(INT8U u8_fChannel)
 {
-    ST_RX_PDU_t st_lRxMsg = {0, };
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    const flexcan_user_config_t * p_stlUserConfig = st_gaChannelConfig[u8_fChannel].p_mUserConfig;
+    const ST_MAILBOX_CONFIG_t * p_stlConfig = &st_gMailBoxConfig[0];
+    const ST_MAILBOX_CONFIG_t * p_stlOther;
+    const ST_FLEXCAN_DATA_INFO_t * p_stlDataInfo;
+    INT32U u32_lFirstMb = 0U;
+    BOOLEAN b_lUsable;
     
-    /* Copy the Received Message */
-    st_lRxMsg.u32_mArbitrationID = p_fMsgInfo->mb_msgId;
-    memcpy((void *)&st_lRxMsg.u8_maDataBuff, \
-                    (const void *)p_fMsgInfo->mb_payload, p_fMsgInfo->mb_dlc);
-    st_lRxMsg.u8_mDataSize = p_fMsgInfo->mb_dlc;
+    if(p_stlUserConfig->is_rx_fifo_needed)
+    {
+        u32_lFirstMb = RxFifoOcuppiedLastMsgBuff(p_stlUserConfig->num_id_filters) + 1U;
+    }
     
-    /* Check if the received message id UDS Request or COM Message */
-    if(p_fMsgInfo->mb_msgId == u16_gUdsReqID)
-    {   
-        /* Call Back to ISO TP callback */
-        if(PNULL != fp_gIsoTpRxHandler)
+    while(CAN_IF_OK == en_lResult)
+    {
+        p_stlDataInfo = &p_stlConfig->st_mFlexCanDataInfo;
+        b_lUsable = ((p_stlConfig->u8_mMailBoxIndex >= u32_lFirstMb) && \
+                     (p_stlConfig->u8_mMailBoxIndex < p_stlUserConfig->max_num_mb)) ? 1U : 0U;
+        
+        if(u8_fChannel != p_stlConfig->u8_mCanNode)
         {
-            fp_gIsoTpRxHandler(&st_lRxMsg);
+            /* Entry of another channel */
+        }
+        else if(((EN_MAILBOX_TRANSMIT != p_stlConfig->en_mMailBoxDirection) && \
+                 (EN_MAILBOX_RECEIVE != p_stlConfig->en_mMailBoxDirection)) || \
+                (p_stlConfig->u32_mMsgID & \
+                    ~((EN_FLEXCAN_MSG_ID_EXT == p_stlDataInfo->en_mMsgIdType) ? \
+                                                CAN_IF_EXT_ID_MASK : CAN_IF_STD_ID_MASK)) || \
+                (p_stlDataInfo->u8_mDataLength > ((0U != p_stlDataInfo->u8_mFdEnable) ? \
+                                                                    CAN_IF_MAX_PAYLOAD : 8U)) || \
+                ((0U != p_stlDataInfo->u8_mFdEnable) && (!p_stlUserConfig->fd_enable)) || \
+                ((0U != p_stlDataInfo->u8_mEnableBrs) && (0U == p_stlDataInfo->u8_mFdEnable)))
+        {
+            /* ID out of its format, payload out of the frame format or the controller */
+            en_lResult = CAN_IF_ERROR;
+        }
+        else if((EN_MAILBOX_TRANSMIT == p_stlConfig->en_mMailBoxDirection) ? \
+                    (0U == b_lUsable) : (CAN_DATA_FRAME != p_stlConfig->en_mFrameType))
+        {
+            /* Tx MB missing or in the Rx FIFO area, remote frame entry which does not transmit */
+            en_lResult = CAN_IF_ERROR;
+        }
+        else if((CAN_REMOTE_FRAME == p_stlConfig->en_mFrameType) && \
+                (0U != p_stlDataInfo->u8_mFdEnable))
+        {
+            /* Remote frames are classic frames */
+            en_lResult = CAN_IF_ERROR;
+        }
+        else if(0U != b_lUsable)
+        {
+            /* A MB belongs to a single entry */
+            p_stlOther = p_stlConfig;
+            while(0U == p_stlOther->u8_EOL)
+            {
+                p_stlOther++;
+                if((u8_fChannel == p_stlOther->u8_mCanNode) && \
+                   (p_stlConfig->u8_mMailBoxIndex == p_stlOther->u8_mMailBoxIndex))
+                {
+                    en_lResult = CAN_IF_ERROR;
+                }
+            }
         }
         else
         {
             /* No Action */
         }
+        
+        if(p_stlConfig->u8_EOL)
+        {
+            break;
+        }
+        p_stlConfig++;
+    }
+    
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_InitChannel                                                           */
+/*                                                                                                */
+/* Description     : Initializes the FlexCAN instance of a channel : driver, callbacks, bit      */
+/*                   timing, Tx mailboxes and hardware acceptance filters                         */
+/*                                                                                                */
+/* In Params       : INT8U u8_fChannel : Channel, its entry of st_gaChannelConfig is used         */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_OK On success                            */
+/**************************************************************************************************/
+
+static EN_CAN_IF_RESULT_t CAN_IF_InitChannel(INT8U u8_fChannel)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    const ST_CAN_IF_CHANNEL_CONFIG_t * p_stlConfig = &st_gaChannelConfig[u8_fChannel];
+    ST_CAN_IF_CHANNEL_t * p_stlChannel = &st_gaChannel[u8_gaChannelCtx[u8_fChannel] - 1U];
+    BOOLEAN b_lRxFifo = p_stlConfig->p_mUserConfig->is_rx_fifo_needed ? 1U : 0U;
+    
+    memset((void *)p_stlChannel, 0, sizeof(ST_CAN_IF_CHANNEL_t));
+    p_stlChannel->u8_mInstance = u8_fChannel;
+    
+    /* Initialize FlexCAN driver */
+    FLEXCAN_DRV_Init(u8_fChannel, p_stlConfig->p_mState, p_stlConfig->p_mUserConfig);
+    
+    /* Initialization of CAN RX/TX  callback function handler, kept in the driver state */
+    CAN_Mgr_Init(u8_fChannel, CAN_TX_Confirmation, CAN_Rx_Notification);
+    FLEXCAN_DRV_InstallErrorCallback(u8_fChannel, CAN_Error_Notification);
+    
+    /* Bus off : held by the driver for the back-off delay, or left to the hardware recovery */
+    p_stlChannel->u32_mBusOffDelay = p_stlConfig->u32_mBusOffDelayMin;
+    FLEXCAN_DRV_SetBusOffRecovery(u8_fChannel, (0U != p_stlConfig->u32_mBusOffDelayMin) ? \
+                                    FLEXCAN_BUSOFF_RECOVERY_MANUAL : FLEXCAN_BUSOFF_RECOVERY_AUTO);
+    
+    /* The channel is reachable from now on */
+    p_stlChannel->p_mConfig = p_stlConfig;
+    
+    /* Bit timing solved for the PE clock, data phase of the FD frames sent with BRS */
+    if(CAN_IF_OK != CAN_IF_SetBitTiming(u8_fChannel, p_stlConfig->u32_mBitrate, \
+                        p_stlConfig->u32_mSamplePoint, p_stlConfig->u32_mSjw, \
+                        p_stlConfig->p_mUserConfig->fd_enable ? p_stlConfig->u32_mFdBitrate : 0U, \
+                        p_stlConfig->u32_mFdSamplePoint, p_stlConfig->u32_mFdSjw))
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+
+    /* Tx mailboxes, bound once to the ID of their entry */
+    if(CAN_IF_OK != CAN_IF_TxInitMailBoxes(p_stlChannel))
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+
+    /* Hardware acceptance filters : frames which are not configured never reach the ISR */
+    FLEXCAN_DRV_SetRxMaskType(u8_fChannel, FLEXCAN_RX_MASK_INDIVIDUAL);
+    if(CAN_IF_OK != CAN_IF_PlanRxFilters(p_stlChannel, b_lRxFifo))
+    {
+        en_lResult = CAN_IF_ERROR;
     }
     else
     {
-        /* Send the Data to OSEK COM */
-        if(PNULL != fp_gComRxIndication)
+        /* Routing of the accepted IDs to their PDU and upper layer */
+        CAN_IF_RxRouteHash(p_stlChannel);
+        
+        if(0U != b_lRxFifo)
         {
-            fp_gComRxIndication(p_fMsgInfo->mb_msgId, &st_lRxMsg);
+            /* Rx FIFO mode : FIFO filter elements first, CAN IF routes the frames by ID */
+            if((CAN_IF_OK != CAN_IF_RxInitFifo(p_stlChannel)) || \
+               (FLEXCAN_STATUS_SUCCESS != FLEXCAN_DRV_StartRxFifoContinuous(u8_fChannel)))
+            {
+                en_lResult = CAN_IF_ERROR;
+            }
         }
-        else
+        
+        /* Persistent Rx mailboxes of the filters which did not fit the FIFO */
+        if(CAN_IF_OK != CAN_IF_RxInitMailBoxes(p_stlChannel))
         {
-            /* No Action */
+            en_lResult = CAN_IF_ERROR;
         }
-    }  
+    }
+    
+    /* Mailboxes answering remote requests, their own exact mask keeps other IDs out */
+    if(CAN_IF_OK != CAN_IF_RespInitMailBoxes(p_stlChannel))
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    
+#if (CAN_IF_CYCLIC_TX == 1U)
+    /* Cyclic Tx entries and their start offsets */
+    if(CAN_IF_OK != CAN_IF_CyclicInit(p_stlChannel))
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+#endif
+    
+    return en_lResult;
 }
 
 /**************************************************************************************************/
 /* Function Name   : CAN_IF_Init()                                                                */
 /*                                                                                                */
-/* Description     : Initializes the CAN Low Level Driver                                         */
+/* Description     : Initializes the CAN Low Level Driver of each channel of st_gaChannelConfig  */
+/*                   with its entries of the mailbox configuration table, checked first           */
 /*                                                                                                */
 /* In Params       : None                                                                         */
 /*                                                                                                */
@@ -142,6 +3346,8 @@ void CAN_Rx_Notification(mailBox_t * p_fMsgInfo)
 EN_CAN_IF_RESULT_t CAN_IF_Init(void)
 {
     EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    INT8U u8_lChannel;
+    INT8U u8_lCtxCount = 0;
  
     /* Initialize and configure clocks
      * 	see clock manager component for details */
@@ -152,32 +3358,100 @@ EN_CAN_IF_RESULT_t CAN_IF_Init(void)
 	/* Initialize pins See PinSettings component for more info */
     Pins_DRV_Init(NUM_OF_CONFIGURED_PINS, g_pin_mux_InitConfigArr);
 
-    /* Initialization of CAN RX/TX  callback function handler */       
-    CAN_Mgr_Init(CAN_TX_Confirmation , CAN_Rx_Notification);
-    
-    /* Initialize FlexCAN driver */
-    FLEXCAN_DRV_Init(FSL_CANCOM1, &canCom1_State, &canCom1_InitConfig0);
-
-    /* Set bit rate */
-    flexcan_time_segment_t myBitRate = {0x04, 0x07, 0x01, 0x00, 1};
-    FLEXCAN_DRV_SetBitrate(FSL_CANCOM1, &myBitRate);
-
-    g_dataInfo_rx.data_length = 8U;
-    g_dataInfo_rx.msg_id_type = FLEXCAN_MSG_ID_STD;
-    g_dataInfo_rx.enable_brs = false;
-    g_dataInfo_rx.fd_enable = false;
-    g_dataInfo_rx.fd_padding = 0U;
-
-    /* Configure Rx message buffer with index 1 and rx_mb_id = 256 */
-    FLEXCAN_DRV_ConfigRxMb(FSL_CANCOM1, 1UL, &g_dataInfo_rx, 2);
+    /* No tick while the channel contexts are rebuilt */
+    INT_SYS_DisableIRQ(LPIT0_IRQn);
+#if (CAN_IF_GATEWAY == 1U)
+    /* No forwarding towards a channel being rebuilt */
+    b_gGwEnabled = 0U;
+#endif
 
-    /* Define receive buffer */
-	recvBuff.cs = 0;
-	recvBuff.msgId = 2;
+    for(u8_lChannel = 0; u8_lChannel < CAN_IF_CHANNEL_NUM; u8_lChannel++)
+    {
+        u8_gaChannelCtx[u8_lChannel] = 0U;
+        if(PNULL == st_gaChannelConfig[u8_lChannel].p_mState)
+        {
+            /* Channel not used */
+        }
+        else if(u8_lCtxCount >= CAN_IF_CHANNEL_CTX_NUM)
+        {
+            /* More configured channels than CAN_IF_CHANNEL_CTX_NUM : left uninitialized */
+            en_lResult = CAN_IF_ERROR;
+        }
+        else if(CAN_IF_OK != CAN_IF_CheckMailBoxConfig(u8_lChannel))
+        {
+            /* Conflicting configuration table : the channel is left uninitialized */
+            en_lResult = CAN_IF_ERROR;
+        }
+        else
+        {
+            u8_lCtxCount++;
+            u8_gaChannelCtx[u8_lChannel] = u8_lCtxCount;
+            if(CAN_IF_OK != CAN_IF_InitChannel(u8_lChannel))
+            {
+                en_lResult = CAN_IF_ERROR;
+            }
+        }
+    }
+    
+    /* One LPIT0 channel ticks the cyclic entries of all channels and the main loop */
+    if(CAN_IF_OK != CAN_IF_TickStart())
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    
+#if (CAN_IF_GATEWAY == 1U)
+    /* Forwarding starts once every channel of the routes is up */
+    if(CAN_IF_OK != CAN_IF_GwStart())
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+#endif
+    
+    return en_lResult;
+}
 
-	/* Start receiving data in MB 1. */
-	FLEXCAN_DRV_RxMessageBuffer(FSL_CANCOM1, 1UL, &recvBuff);
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_UpdateRemoteResponse()                                                */
+/*                                                                                                */
+/* Description     : Writes the payload returned by the controller to the remote requests of an   */
+/*                   ID, the next request is answered with it without any CPU involvement         */
+/*                                                                                                */
+/* In Params       : INT8U u8_fChannel : Channel                                                  */
+/*                   INT32U u32_fCANID : ID of a remote frame entry of the configuration table    */
+/*                   const INT8U * p_fData : Payload, of the configured data length               */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_ERROR if the ID has no response mailbox  */
+/**************************************************************************************************/
 
+EN_CAN_IF_RESULT_t CAN_IF_UpdateRemoteResponse(INT8U u8_fChannel, INT32U u32_fCANID, \
+                                                                        const INT8U * p_fData)
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_ERROR;
+    const ST_CAN_IF_CHANNEL_t * p_stlChannel = CAN_IF_GetChannel(u8_fChannel);
+    INT8U u8_lIndex;
+    
+    if((PNULL != p_stlChannel) && (PNULL != p_fData))
+    {
+        for(u8_lIndex = 0U; u8_lIndex < p_stlChannel->u8_mRespMailBoxCount; u8_lIndex++)
+        {
+            if(u32_fCANID == p_stlChannel->st_maRespMailBox[u8_lIndex].u32_mCANID)
+            {
+                if(FLEXCAN_STATUS_SUCCESS == FLEXCAN_DRV_UpdateRemoteResponseMb( \
+                        p_stlChannel->u8_mInstance, \
+                        p_stlChannel->st_maRespMailBox[u8_lIndex].u8_mMailBoxIndex, p_fData))
+                {
+                    en_lResult = CAN_IF_OK;
+                }
+                break;
+            }
+        }
+    }
+    else
+    {
+        /* No Action */
+    }
     
     return en_lResult;
 }
@@ -185,64 +3459,285 @@ EN_CAN_IF_RESULT_t CAN_IF_Init(void)
 /**************************************************************************************************/
 /* Function Name   : CAN_IF_WriteMsg()                                                            */
 /*                                                                                                */
-/* Description     :                                                                              */
+/* Description     : Queues a frame for transmission. With CAN_IF_TX_PRIO_QUEUE the frame is     */
+/*                   sent from the Tx mailbox pool of the channel in CAN ID order and             */
+/*                   u8_fMONumber is unused. Else it is sent from the Tx mailbox u8_fMONumber of  */
+/*                   the configuration table, only its payload is written while the mailbox       */
+/*                   keeps the ID and format of the frame.                                        */
 /*                                                                                                */
-/* In Params       : INT32U u32_fCANID : Transmit Message ID                                      */
+/* In Params       : INT8U u8_fChannel : Channel                                                  */
+/*                   INT32U u32_fCANID : Transmit Message ID                                      */
 /*                   INT8U u8_fMONumber : Trasmit MO Number                                       */
 /*                   INT8U * u8_fPtr : Transmit Data Pointer                                      */
-/*                   INT8U u8_fDLC : Transmit Message Length                                      */
+/*                   INT8U u8_fDLC : Transmit Message Length in bytes (up to 64 for CAN FD)       */
 /*                                                                                                */
 /* Out Params      : None                                                                         */
 /*                                                                                                */
-/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_OK On success                            */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_OK On success, CAN_IF_BUSY if the queue  */
+/*                   is full (the mailbox still holds a frame), CAN_IF_ERROR if the channel or    */
+/*                   mailbox is not used or the length does not fit the frame format              */
 /**************************************************************************************************/
 
-EN_CAN_IF_RESULT_t CAN_IF_WriteMsg(INT32U u32_fCANID, INT8U u8_fMONumber, \
+EN_CAN_IF_RESULT_t CAN_IF_WriteMsg(INT8U u8_fChannel, INT32U u32_fCANID, INT8U u8_fMONumber, \
                                                                INT8U * u8_fPtr, INT8U u8_fDLC)
 {
     EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
-        
+    ST_CAN_IF_CHANNEL_t * p_stlChannel = CAN_IF_GetChannel(u8_fChannel);
+#if (CAN_IF_TX_PRIO_QUEUE == 1U)
+    ST_CAN_IF_TX_PDU_t st_lPdu;
+#else
+    ST_CAN_IF_TX_MB_t * p_stlMailBox = PNULL;
+    INT8U u8_lIndex;
+#endif
     flexcan_data_info_t g_dataInfo_tx;
+    
+#if (CAN_IF_TX_PRIO_QUEUE == 1U)
+    (void)u8_fMONumber;
+    
+    if(PNULL == p_stlChannel)
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    else if(CAN_IF_OK != CAN_IF_GetTxDataInfo(p_stlChannel, u32_fCANID, u8_fDLC, &g_dataInfo_tx))
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    else
+    {
+        st_lPdu.u32_mCANID = u32_fCANID;
+        st_lPdu.b_mExtended = (FLEXCAN_MSG_ID_EXT == g_dataInfo_tx.msg_id_type) ? 1U : 0U;
+        st_lPdu.u8_mDLC = u8_fDLC;
+        st_lPdu.u8_mFdEnable = g_dataInfo_tx.fd_enable;
+        st_lPdu.u8_mEnableBrs = g_dataInfo_tx.enable_brs;
+        st_lPdu.u8_mFdPadding = g_dataInfo_tx.fd_padding;
+        st_lPdu.b_mGateway = 0U;
+        memcpy((void *)&st_lPdu.u8_maData[0], (const void *)u8_fPtr, u8_fDLC);
+    
+        INT_SYS_DisableIRQGlobal();
+        if(p_stlChannel->u32_mTxHeapCount >= CAN_IF_TX_QUEUE_SIZE)
+        {
+            en_lResult = CAN_IF_BUSY;
+        }
+        else
+        {
+            st_lPdu.u32_mSeqNo = p_stlChannel->u32_mTxSeqNo++;
+            (void)CAN_IF_TxHeapPush(p_stlChannel, &st_lPdu);
+            CAN_IF_TxSchedule(p_stlChannel);
+        }
+        INT_SYS_EnableIRQGlobal();
+    }
+#else
+    if(PNULL == p_stlChannel)
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    else if(CAN_IF_OK != CAN_IF_GetTxDataInfo(p_stlChannel, u32_fCANID, u8_fDLC, &g_dataInfo_tx))
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    else
+    {
+        for(u8_lIndex = 0; u8_lIndex < p_stlChannel->u8_mTxMailBoxCount; u8_lIndex++)
+        {
+            if(p_stlChannel->st_maTxMailBox[u8_lIndex].u8_mMailBoxIndex == u8_fMONumber)
+            {
+                p_stlMailBox = &p_stlChannel->st_maTxMailBox[u8_lIndex];
+                break;
+            }
+        }
         
-    g_dataInfo_tx.data_length = 8U;
-    g_dataInfo_tx.msg_id_type = FLEXCAN_MSG_ID_STD;
-    g_dataInfo_tx.enable_brs = false;
-    g_dataInfo_tx.fd_enable = false;
-    g_dataInfo_tx.fd_padding = 0U;
+        if(PNULL == p_stlMailBox)
+        {
+            /* Not a Tx mailbox of the configuration table */
+            en_lResult = CAN_IF_ERROR;
+        }
+        else
+        {
+            /* Execute send non-blocking, shared with the cyclic Tx of the LPIT0 ISR */
+            INT_SYS_DisableIRQGlobal();
+            en_lResult = CAN_IF_TxSendMailBox(p_stlChannel, p_stlMailBox, u32_fCANID, \
+                                                                        &g_dataInfo_tx, u8_fPtr);
+            INT_SYS_EnableIRQGlobal();
+        }
+    }
+#endif
     
-    /* Configure Tx message buffer with index 1 */
-    FLEXCAN_DRV_ConfigTxMb(FSL_CANCOM1, u8_fMONumber, &g_dataInfo_tx, u32_fCANID);
-	
-	/* Execute send non-blocking */
-    FLEXCAN_DRV_Send(FSL_CANCOM1, u8_fMONumber, &g_dataInfo_tx, u32_fCANID, u8_fPtr);
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_WriteMsgBatch()                                                       */
+/*                                                                                                */
+/* Description     : Sends a batch of frames, CAN_IF_TX_BATCH_CHUNK frames at a time : the frame  */
+/*                   formats and payloads of a chunk are prepared with the interrupts enabled,    */
+/*                   the interrupts are then disabled once for the chunk. With                    */
+/*                   CAN_IF_TX_PRIO_QUEUE the lock only queues the frames and runs the Tx         */
+/*                   scheduler once, which fills every free Tx mailbox in a single pass, lowest   */
+/*                   ID first, the others wait in the queue. Else each frame is sent from its Tx  */
+/*                   mailbox. Frames are taken in order up to the first one refused, the caller   */
+/*                   resends the rest.                                                            */
+/*                                                                                                */
+/* In Params       : INT8U u8_fChannel : Channel                                                  */
+/*                   const ST_CAN_IF_TX_FRAME_t * p_stfFrames : Frames                            */
+/*                   INT32U u32_fCount : Number of frames                                         */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT32U : Number of frames taken, the next one was refused for the reason     */
+/*                   CAN_IF_WriteMsg() would return                                               */
+/**************************************************************************************************/
 
+INT32U CAN_IF_WriteMsgBatch(INT8U u8_fChannel, const ST_CAN_IF_TX_FRAME_t * p_stfFrames, \
+                                                                        INT32U u32_fCount)
+{
+    ST_CAN_IF_CHANNEL_t * p_stlChannel = CAN_IF_GetChannel(u8_fChannel);
+    const ST_CAN_IF_TX_FRAME_t * p_stlFrame;
+#if (CAN_IF_TX_PRIO_QUEUE == 1U)
+    ST_CAN_IF_TX_PDU_t st_laPdu[CAN_IF_TX_BATCH_CHUNK];
+    ST_CAN_IF_TX_PDU_t * p_stlPdu;
+#else
+    ST_CAN_IF_TX_MB_t * p_stlaMailBox[CAN_IF_TX_BATCH_CHUNK];
+    INT8U u8_lIndex;
+#endif
+    flexcan_data_info_t st_laDataInfo[CAN_IF_TX_BATCH_CHUNK];
+    INT32U u32_lAccepted = 0U;
+    INT32U u32_lBuilt;
+    INT32U u32_lSent;
+    BOOLEAN b_lStop = 0U;
     
-    return en_lResult;
+    if(PNULL == p_stlChannel)
+    {
+        b_lStop = 1U;
+    }
+    else
+    {
+        /* No Action */
+    }
+    
+    while((0U == b_lStop) && (u32_lAccepted < u32_fCount))
+    {
+        /* The frame formats only read the configuration table : the chunk is prepared with */
+        /* the interrupts enabled                                                            */
+        for(u32_lBuilt = 0U; (u32_lBuilt < CAN_IF_TX_BATCH_CHUNK) && \
+                                    ((u32_lAccepted + u32_lBuilt) < u32_fCount); u32_lBuilt++)
+        {
+            p_stlFrame = &p_stfFrames[u32_lAccepted + u32_lBuilt];
+            if(CAN_IF_OK != CAN_IF_GetTxDataInfo(p_stlChannel, p_stlFrame->u32_mCANID, \
+                                                p_stlFrame->u8_mDLC, &st_laDataInfo[u32_lBuilt]))
+            {
+                b_lStop = 1U;
+                break;
+            }
+#if (CAN_IF_TX_PRIO_QUEUE == 1U)
+            p_stlPdu = &st_laPdu[u32_lBuilt];
+            p_stlPdu->u32_mCANID = p_stlFrame->u32_mCANID;
+            p_stlPdu->b_mExtended = \
+                        (FLEXCAN_MSG_ID_EXT == st_laDataInfo[u32_lBuilt].msg_id_type) ? 1U : 0U;
+            p_stlPdu->u8_mDLC = p_stlFrame->u8_mDLC;
+            p_stlPdu->u8_mFdEnable = st_laDataInfo[u32_lBuilt].fd_enable;
+            p_stlPdu->u8_mEnableBrs = st_laDataInfo[u32_lBuilt].enable_brs;
+            p_stlPdu->u8_mFdPadding = st_laDataInfo[u32_lBuilt].fd_padding;
+            p_stlPdu->b_mGateway = 0U;
+            memcpy((void *)&p_stlPdu->u8_maData[0], (const void *)p_stlFrame->p_mData, \
+                                                                        p_stlFrame->u8_mDLC);
+#else
+            p_stlaMailBox[u32_lBuilt] = PNULL;
+            for(u8_lIndex = 0; u8_lIndex < p_stlChannel->u8_mTxMailBoxCount; u8_lIndex++)
+            {
+                if(p_stlChannel->st_maTxMailBox[u8_lIndex].u8_mMailBoxIndex == \
+                                                                    p_stlFrame->u8_mMONumber)
+                {
+                    p_stlaMailBox[u32_lBuilt] = &p_stlChannel->st_maTxMailBox[u8_lIndex];
+                    break;
+                }
+            }
+            if(PNULL == p_stlaMailBox[u32_lBuilt])
+            {
+                b_lStop = 1U;
+                break;
+            }
+#endif
+        }
+        
+        INT_SYS_DisableIRQGlobal();
+        for(u32_lSent = 0U; u32_lSent < u32_lBuilt; u32_lSent++)
+        {
+#if (CAN_IF_TX_PRIO_QUEUE == 1U)
+            if(p_stlChannel->u32_mTxHeapCount >= CAN_IF_TX_QUEUE_SIZE)
+            {
+                b_lStop = 1U;
+                break;
+            }
+            st_laPdu[u32_lSent].u32_mSeqNo = p_stlChannel->u32_mTxSeqNo++;
+            (void)CAN_IF_TxHeapPush(p_stlChannel, &st_laPdu[u32_lSent]);
+#else
+            p_stlFrame = &p_stfFrames[u32_lAccepted + u32_lSent];
+            if(CAN_IF_OK != CAN_IF_TxSendMailBox(p_stlChannel, p_stlaMailBox[u32_lSent], \
+                        p_stlFrame->u32_mCANID, &st_laDataInfo[u32_lSent], p_stlFrame->p_mData))
+            {
+                b_lStop = 1U;
+                break;
+            }
+#endif
+        }
+#if (CAN_IF_TX_PRIO_QUEUE == 1U)
+        /* One scheduler pass for the whole chunk */
+        CAN_IF_TxSchedule(p_stlChannel);
+#endif
+        INT_SYS_EnableIRQGlobal();
+        
+        u32_lAccepted += u32_lSent;
+    }
+    
+    return u32_lAccepted;
 }
 
 /**************************************************************************************************/
 /* Function Name   : CAN_IF_InitIsoTp()                                                           */
 /*                                                                                                */
-/* Description     : Initialize the ISOTP request and response IDs, and TX and Rx Handlers        */
+/* Description     : Initialize the ISOTP request and response IDs, and TX and Rx Handlers. The   */
+/*                   request ID is compiled into the Rx filters by CAN_IF_Init(), it can not be   */
+/*                   moved to another ID or channel afterwards.                                   */
 /*                                                                                                */
 /* In Params       : ST_ISOTP_CONFIG_PARAMS_t * p_stfIsoTpInitData : ISOTP init data Pointer      */
 /*                                                                                                */
 /* Out Params      : None                                                                         */
 /*                                                                                                */
-/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_OK On success                            */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_OK On success, CAN_IF_ERROR if the       */
+/*                   request ID or channel changes after CAN_IF_Init()                            */
 /**************************************************************************************************/
 
 EN_CAN_IF_RESULT_t CAN_IF_InitIsoTp(ST_ISOTP_CONFIG_PARAMS_t * p_stfIsoTpInitData)  
 {
     EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
 
-    /* update CAN TX and RX Event Handlers */
-    fp_gIsoTpTxHandler = p_stfIsoTpInitData->fp_mIsoTpTxHandler;
-    fp_gIsoTpRxHandler = p_stfIsoTpInitData->fp_mIsoTpRxHandler; 
-    
-     /* Update Request & Respose ID */
-    u16_gUdsReqID = p_stfIsoTpInitData->u16_mIsoTpReqID;
-    u16_gUdsRespID = p_stfIsoTpInitData->u16_mIsoTpRespID;
+    if((PNULL == p_stfIsoTpInitData) || \
+       (p_stfIsoTpInitData->u8_mIsoTpChannel >= CAN_IF_CHANNEL_NUM))
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    else if(((PNULL != CAN_IF_GetChannel(u8_gIsoTpChannel)) || \
+             (PNULL != CAN_IF_GetChannel(p_stfIsoTpInitData->u8_mIsoTpChannel))) && \
+            ((u16_gUdsReqID != p_stfIsoTpInitData->u16_mIsoTpReqID) || \
+             (u8_gIsoTpChannel != p_stfIsoTpInitData->u8_mIsoTpChannel)))
+    {
+        en_lResult = CAN_IF_ERROR;
+    }
+    else
+    {
+        INT_SYS_DisableIRQGlobal();
+        
+        /* update CAN TX and RX Event Handlers */
+        fp_gIsoTpTxHandler = p_stfIsoTpInitData->fp_mIsoTpTxHandler;
+        fp_gIsoTpRxHandler = p_stfIsoTpInitData->fp_mIsoTpRxHandler; 
+        
+        /* Update Request & Respose ID */
+        u16_gUdsReqID = p_stfIsoTpInitData->u16_mIsoTpReqID;
+        u16_gUdsRespID = p_stfIsoTpInitData->u16_mIsoTpRespID;
+        u8_gIsoTpChannel = p_stfIsoTpInitData->u8_mIsoTpChannel;
+        
+        INT_SYS_EnableIRQGlobal();
+    }
     
     return en_lResult;
 }
@@ -272,42 +3767,77 @@ EN_CAN_IF_RESULT_t CAN_IF_UpdateComHandlers(void (* fp_mComTxHandler)(INT16U), \
     return en_lResult;
 }
 
+/**************************************************************************************************/
+/* Function Name   : CAN_IF_UpdateTriggerTransmit()                                               */
+/*                                                                                                */
+/* Description     : Updates the payload source of the cyclic Tx entries                          */
+/*                                                                                                */
+/* In Params       : INT8U (* fp_fTriggerTransmit)(INT16U, INT8U *) : Fills the payload of a      */
+/*                   configuration table entry, returns its size in bytes, 0 to skip the cycle.   */
+/*                   Called from the LPIT0 ISR                                                    */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_OK On success                            */
+/**************************************************************************************************/
+
+EN_CAN_IF_RESULT_t CAN_IF_UpdateTriggerTransmit( \
+                            INT8U (* fp_fTriggerTransmit)(INT16U u16_fPduHandle, INT8U * p_fData))
+{
+    EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
+    
+    fp_gComTriggerTransmit = fp_fTriggerTransmit;
+    
+    return en_lResult;
+}
+
 /**************************************************************************************************/
 /* Function Name   : CAN_IF_ISOTP_WriteMsg()                                                      */
 /*                                                                                                */
-/* Description     :                                                                              */
+/* Description     : Queues an ISO TP frame on the ISO TP channel, frames of one ID are sent in   */
+/*                   the order they are queued. Without CAN_IF_TX_PRIO_QUEUE the frame goes       */
+/*                   through the Tx mailbox of the ID in the configuration table.                 */
 /*                                                                                                */
 /* In Params       : INT32U u32_fCANID : Transmit Message ID                                      */
 /*                   INT8U * u8_fPtr : Transmit Data Pointer                                      */
-/*                   INT8U u8_fDLC : Transmit Message Length                                      */
+/*                   INT8U u8_fDLC : Transmit Message Length in bytes (up to 64 for CAN FD)       */
 /*                                                                                                */
 /* Out Params      : None                                                                         */
 /*                                                                                                */
-/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_OK On success                            */
+/* Return Value    : EN_CAN_IF_RESULT_t : returns CAN_IF_OK On success, see CAN_IF_WriteMsg()     */
 /**************************************************************************************************/
 
 EN_CAN_IF_RESULT_t CAN_IF_ISOTP_WriteMsg(INT32U u32_fCANID, INT8U * u8_fPtr, INT8U u8_fDLC)
 {
     EN_CAN_IF_RESULT_t en_lResult = CAN_IF_OK;
-#if 0    
-    ST_CAN_MO_INIT_t st_lMOInit = {0,};
-
-    st_lMOInit.u32_mCANID =  u32_fCANID;
-    st_lMOInit.u8_mMONumber =  0;
-    st_lMOInit.u8_mDLC = u8_fDLC;    
-    st_lMOInit.en_mCANIDType = CAN_STANDARD_ID;	
-    st_lMOInit.en_mMIDE = CAN_RECEIVE_MATCH_IDE;
-    st_lMOInit.u8_mAcceptanceMask = 0x7FF;
-    st_lMOInit.en_mCANFrameType = CAN_DATA_FRAME;
-    st_lMOInit.en_mCANMOType = CAN_MO_TRANSMIT;
-    st_lMOInit.en_mMsgObjStatus = CAN_ENABLE;
-
-    memcpy((INT8U *)&(st_lMOInit.au8_mData[0]), &(u8_fPtr[0]), u8_fDLC );
+#if (CAN_IF_TX_PRIO_QUEUE == 1U)
+    
+    en_lResult = CAN_IF_WriteMsg(u8_gIsoTpChannel, u32_fCANID, 0U, u8_fPtr, u8_fDLC);
+#else
+    const ST_MAILBOX_CONFIG_t * p_stlConfig = &st_gMailBoxConfig[0];
+    
+    while(1)
+    {
+        if((EN_MAILBOX_TRANSMIT == p_stlConfig->en_mMailBoxDirection) && \
+           (CAN_DATA_FRAME == p_stlConfig->en_mFrameType) && \
+           (u8_gIsoTpChannel == p_stlConfig->u8_mCanNode) && \
+           (u32_fCANID == p_stlConfig->u32_mMsgID))
+        {
+            en_lResult = CAN_IF_WriteMsg(u8_gIsoTpChannel, u32_fCANID, \
+                                            p_stlConfig->u8_mMailBoxIndex, u8_fPtr, u8_fDLC);
+            break;
+        }
+        
+        if(p_stlConfig->u8_EOL)
+        {
+            /* No Tx mailbox for the ID */
+            en_lResult = CAN_IF_ERROR;
+            break;
+        }
+        p_stlConfig++;
+    }
+#endif
     
-     /* Configure the Mail Box and Transmit */
-    CAN_ConfigMO(&st_lMOInit);
-    CAN_Transmit_DataFrame(st_lMOInit.u8_mMONumber);
-#endif    
     return en_lResult;
 }
 
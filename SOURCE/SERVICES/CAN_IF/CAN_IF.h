@@ -20,9 +20,13 @@
 /**************************************************************************************************/
 
 #define FLEXCAN_SWAP_BYTES_IN_WORD_INDEX(index)       (((index) & ~3U) + (3U - ((index) & 3U)))
+/* Largest PDU payload in bytes (CAN FD) */
+#define CAN_IF_MAX_PAYLOAD                            (64U)
+/* PDU handle of a received frame without entry in the configuration table (UDS request) */
+#define CAN_IF_PDU_HANDLE_NONE                        (0xFFFFU)
 /*CAN Channel Definetion*/
-#define MBFM CAN1
-#define TRANSMIT_TPMS CAN0
+#define MBFM                                          (CAN_IF_CHANNEL_1)
+#define TRANSMIT_TPMS                                 (CAN_IF_CHANNEL_0)
 
 /**************************************************************************************************/
 /* Export Global Variable Section                                                                 */
@@ -37,7 +41,9 @@ typedef enum
 typedef enum
 {
     CAN_IF_OK = 0x00,
-    CAN_IF_ERROR
+    CAN_IF_ERROR,
+    /* Tx mailbox still holds the previous frame, or the Tx queue is full */
+    CAN_IF_BUSY
       
 }EN_CAN_IF_RESULT_t;
 
@@ -64,7 +70,15 @@ typedef struct
 }ST_CAN_PARA_INIT_t;
 #endif
 
-/* DEVICE SELECTION*/
+/* DEVICE SELECTION : a CAN IF channel is the FlexCAN instance of the same number */
+typedef enum
+{
+    CAN_IF_CHANNEL_0 = 0x00,
+    CAN_IF_CHANNEL_1,
+    CAN_IF_CHANNEL_2,
+    CAN_IF_CHANNEL_NUM
+
+}EN_CAN_IF_CHANNEL_t;
 
 /* ENUM for CAN ID Type */
 typedef enum
@@ -133,7 +147,7 @@ typedef struct
 	INT8U  u8_mDLC;
 
 	/* */
-	INT8U  au8_mData[8];
+	INT8U  au8_mData[CAN_IF_MAX_PAYLOAD];
 	
 
 	/* CAN Message Object(MO) Type*/
@@ -234,6 +248,8 @@ typedef struct
     void (* fp_mIsoTpRxHandler)(void * p_fRxData);
     INT16U u16_mIsoTpReqID;
     INT16U u16_mIsoTpRespID;  
+    /* Channel carrying the ISO TP request and response IDs */
+    INT8U u8_mIsoTpChannel;
     
 }ST_ISOTP_CONFIG_PARAMS_t;
 
@@ -264,33 +280,203 @@ typedef struct
     ST_FLEXCAN_DATA_INFO_t st_mFlexCanDataInfo;
     /* */
     INT32U u32_mMsgID;  
+    /* Rx entry : ID bits compared, the entry accepts every ID matching u32_mMsgID on them. */
+    /* 0 : all bits (single ID)                                                             */
+    INT32U u32_mAcceptanceMask;
+    /* Data frame (default) or, for a Tx mailbox, remote frame : the mailbox answers the */
+    /* remote requests of u32_mMsgID in hardware, see CAN_IF_UpdateRemoteResponse()     */
+    EN_CAN_FRAME_TYPE_t en_mFrameType;
+    /* Tx data frame entry : cycle time in ms, the frame is sent by CAN IF every cycle with the */
+    /* payload of the trigger transmit handler, see CAN_IF_UpdateTriggerTransmit(). 0 : sent   */
+    /* by CAN_IF_WriteMsg only                                                                 */
+    INT16U u16_mCycleTime;
     /* */
     INT8U u8_EOL;
   
 }ST_MAILBOX_CONFIG_t;
 
+/* Channel configuration, one entry per FlexCAN instance */
+typedef struct
+{
+    /* Driver state and controller configuration, PNULL : channel not used */
+    flexcan_state_t * p_mState;
+    const flexcan_user_config_t * p_mUserConfig;
+    /* Nominal bit rate (bit/s), sample point (per mille), SJW (tq, 0 : largest possible) */
+    INT32U u32_mBitrate;
+    INT32U u32_mSamplePoint;
+    INT32U u32_mSjw;
+    /* FD data phase bit timing, used when the controller runs in FD mode */
+    INT32U u32_mFdBitrate;
+    INT32U u32_mFdSamplePoint;
+    INT32U u32_mFdSjw;
+    /* Bus off back-off : delay before the first recovery (ms, 0 : hardware recovery right */
+    /* after 128 x 11 recessive bits), growth factor per bus off and delay limit (ms)     */
+    INT32U u32_mBusOffDelayMin;
+    INT32U u32_mBusOffDelayFactor;
+    INT32U u32_mBusOffDelayMax;
+    
+}ST_CAN_IF_CHANNEL_CONFIG_t;
+
+/* Gateway route : the frames of the source channel whose ID matches u32_mSrcID on the        */
+/* u32_mSrcMask bits are forwarded to the destination channels, without going through COM   */
+typedef struct
+{
+    /* Source channel, ID, compared ID bits (0 : all bits) and ID type */
+    INT8U u8_mSrcChannel;
+    INT32U u32_mSrcID;
+    INT32U u32_mSrcMask;
+    EN_MSG_ID_TYPE_t en_mMsgIdType;
+    /* Destination channels, bit n set for CAN_IF_CHANNEL_n, the source one with a rewritten ID */
+    INT8U u8_mDstChannels;
+    /* ID rewrite : the u32_mDstMask bits of the ID are replaced by the ones of u32_mDstID, */
+    /* 0 : the ID is kept                                                                   */
+    INT32U u32_mDstID;
+    INT32U u32_mDstMask;
+    /* Rate limit : minimum time between two forwarded frames in us, 0 : no limit */
+    INT32U u32_mMinIntervalUs;
+    
+}ST_CAN_IF_GW_ROUTE_CONFIG_t;
+
+/* Counters of a gateway route */
+typedef struct
+{
+    /* Frames queued to at least one destination channel */
+    INT32U u32_mForwardCount;
+    /* Frames dropped by the rate limit of the route */
+    INT32U u32_mRateDropCount;
+    /* Destination copies dropped : Tx queue full, or FD frame towards a classic CAN channel */
+    INT32U u32_mTxDropCount;
+    /* Remote frames, not forwarded : the Tx path only sends data frames */
+    INT32U u32_mRemoteDropCount;
+    /* Forwarding latency, from the reception to the last destination Tx queue, in bit times */
+    /* of the source channel : last frame, highest, sum over u32_mForwardCount              */
+    INT32U u32_mLatencyLast;
+    INT32U u32_mLatencyMax;
+    INT32U u32_mLatencySum;
+    
+}ST_CAN_IF_GW_STATS_t;
+
+/* Frame of a CAN_IF_WriteMsgBatch() call, see CAN_IF_WriteMsg() for the fields */
+typedef struct
+{
+    INT32U u32_mCANID;
+    /* Tx mailbox of the configuration table, unused with CAN_IF_TX_PRIO_QUEUE */
+    INT8U u8_mMONumber;
+    INT8U * p_mData;
+    INT8U u8_mDLC;
+    
+}ST_CAN_IF_TX_FRAME_t;
+
+/* Received frame view, the payload stays in the FlexCAN driver frame slot and is */
+/* only valid during the ISO TP / COM Rx indication                               */
 typedef struct 
 {
+    /* Channel the frame was received on */
+    INT8U u8_mChannel;
+    /* Index of the Rx entry of the frame in st_gMailBoxConfig, CAN_IF_PDU_HANDLE_NONE if none */
+    INT16U u16_mPduHandle;
     INT32U u32_mArbitrationID;
-    INT8U u8_maDataBuff[8];
+    const INT8U * p_mDataBuff;
     INT8U u8_mDataSize;
+    /* Reception time, same timebase as CAN_IF_GetTimeStamp() */
+    INT32U u32_mTimeStamp;
+    /* 1 : CAN FD frame (up to 64 bytes) */
+    BOOLEAN b_mFdFrame;
+    /* 1 : FD frame sent with bit rate switch */
+    BOOLEAN b_mBrs;
     
 }ST_RX_PDU_t;
 
+/* Rx frame slot statistics (FlexCAN driver slots) */
+typedef struct
+{
+    /* Highest number of frames waiting for delivery */
+    INT32U u32_mHighWater;
+    /* Number of frames dropped because no slot was free */
+    INT32U u32_mOverflowCount;
+    
+}ST_CAN_IF_RX_RING_STATS_t;
+
+/* Result of the acceptance filter planning done by CAN_IF_Init */
+typedef struct
+{
+    /* Number of hardware filters (Rx mailboxes and Rx FIFO filter elements) in use */
+    INT32U u32_mFilterCount;
+    /* Number of filters accepting IDs which are not configured */
+    INT32U u32_mInexactCount;
+    /* Configured IDs sharing an inexact filter, CAN IF drops the other IDs in software */
+    INT32U u32_mSwFilterIdCount;
+    const INT32U * p_mSwFilterIds;
+    
+}ST_CAN_IF_FILTER_REPORT_t;
+
+/* Bus health of a channel */
+typedef struct
+{
+    /* Error counters by class, TEC / REC, fault confinement state and transition times */
+    flexcan_error_stats_t st_mError;
+    /* Bus off recoveries started by CAN IF after their back-off delay */
+    INT32U u32_mRecoveryCount;
+    /* Back-off delay applied to the next bus off, ms */
+    INT32U u32_mBusOffDelay;
+    
+}ST_CAN_IF_BUS_STATS_t;
+
 
 
 /**************************************************************************************************/
 /* Export Functions Section                                                                       */
 /**************************************************************************************************/
 
-/* */
+/* Initializes every channel of st_gaChannelConfig */
 extern EN_CAN_IF_RESULT_t CAN_IF_Init(void);
 
-/* */
-extern EN_CAN_IF_RESULT_t CAN_IF_WriteMsg(INT32U u32_fCANID, INT8U u8_fMONumber, \
-                                                        INT8U * u8_fPtr, INT8U u8_fDLC);
+/* Solves and programs the bit timing for the PE clock : bit rates in bit/s, sample points */
+/* in per mille, SJW in time quanta (0 : largest possible), u32_fFdBitrate 0 : no FD data  */
+extern EN_CAN_IF_RESULT_t CAN_IF_SetBitTiming(INT8U u8_fChannel, INT32U u32_fBitrate, \
+                INT32U u32_fSamplePoint, INT32U u32_fSjw, INT32U u32_fFdBitrate, \
+                INT32U u32_fFdSamplePoint, INT32U u32_fFdSjw);
 
-/* */
+/* Bit timing programmed by CAN_IF_SetBitTiming, with the achieved bit rate errors in ppm */
+extern EN_CAN_IF_RESULT_t CAN_IF_GetBitTiming(INT8U u8_fChannel, flexcan_bit_timing_t * p_stfTiming);
+
+/* Cyclic task of all channels, delivers the frames queued by the ISRs in deferred Rx mode */
+extern void CAN_IF_MainFunction(void);
+
+/* FlexCAN timebase extended to 32 bits (bit times), Rx / Tx time stamps use it */
+extern INT32U CAN_IF_GetTimeStamp(INT8U u8_fChannel);
+
+/* Transmission time of the frame being confirmed, valid in the Tx confirmation handlers */
+extern INT32U CAN_IF_GetTxTimeStamp(INT8U u8_fChannel);
+
+/* Read (and optionally reset) the Rx frame slot statistics */
+extern EN_CAN_IF_RESULT_t CAN_IF_GetRxRingStats(INT8U u8_fChannel, \
+                                    ST_CAN_IF_RX_RING_STATS_t * p_stfStats, BOOLEAN b_fClear);
+
+/* Read (and optionally reset) the bus error statistics and bus off recovery state */
+extern EN_CAN_IF_RESULT_t CAN_IF_GetBusStats(INT8U u8_fChannel, \
+                                    ST_CAN_IF_BUS_STATS_t * p_stfStats, BOOLEAN b_fClear);
+
+/* Hardware acceptance filters built from the configuration table, valid after CAN_IF_Init */
+extern EN_CAN_IF_RESULT_t CAN_IF_GetFilterReport(INT8U u8_fChannel, \
+                                                    ST_CAN_IF_FILTER_REPORT_t * p_stfReport);
+
+/* Updates the RANSWER response payload of u32_fCANID, its length is the configured one */
+extern EN_CAN_IF_RESULT_t CAN_IF_UpdateRemoteResponse(INT8U u8_fChannel, INT32U u32_fCANID, \
+                                                                        const INT8U * p_fData);
+
+/* Frame format (FD, BRS, padding) is taken from the Tx PDU of the configuration table,    */
+/* u8_fDLC is the payload size in bytes, up to CAN_IF_MAX_PAYLOAD on an FD controller      */
+/* Returns CAN_IF_BUSY when the frame can not be taken yet, CAN_IF_ERROR when it never can */
+extern EN_CAN_IF_RESULT_t CAN_IF_WriteMsg(INT8U u8_fChannel, INT32U u32_fCANID, \
+                                    INT8U u8_fMONumber, INT8U * u8_fPtr, INT8U u8_fDLC);
+
+/* Sends the frames in order, one critical section per CAN_IF_TX_BATCH_CHUNK frames, returns */
+/* how many were taken : the frames after the first refused one are not sent                */
+extern INT32U CAN_IF_WriteMsgBatch(INT8U u8_fChannel, const ST_CAN_IF_TX_FRAME_t * p_stfFrames, \
+                                                                        INT32U u32_fCount);
+
+/* Queues a frame on the ISO TP channel, used by the ISOTP transport layer */
 extern EN_CAN_IF_RESULT_t CAN_IF_ISOTP_WriteMsg(INT32U u32_fCANID, INT8U * u8_fPtr, \
                                                                         INT8U u8_fDLC);
 
@@ -298,12 +484,28 @@ extern EN_CAN_IF_RESULT_t CAN_IF_ISOTP_WriteMsg(INT32U u32_fCANID, INT8U * u8_fP
 extern EN_CAN_IF_RESULT_t CAN_IF_ConfigRxMO(INT32 u32_fCANID, INT8U u8_fMONumber, \
                                                       EN_CAN_MO_TYPE_t en_fMoDirection);
 
-/* */
+/* ISO TP frame handlers and IDs, the request ID must be set before CAN_IF_Init() */
 extern EN_CAN_IF_RESULT_t CAN_IF_InitIsoTp(ST_ISOTP_CONFIG_PARAMS_t * p_stfIsoTpInitData); 
 
 /* */
 extern EN_CAN_IF_RESULT_t CAN_IF_UpdateComHandlers(void (* fp_mComTxHandler)(INT16U), \
                              void (* fp_mComRxHandler)(INT16U u16_fMsgID, void * p_fRxData)); 
+/* Payload source of the cyclic Tx entries, called from the LPIT0 ISR : fills the payload of */
+/* the entry u16_fPduHandle of st_gMailBoxConfig, returns its size (0 : skip this cycle)    */
+extern EN_CAN_IF_RESULT_t CAN_IF_UpdateTriggerTransmit( \
+                        INT8U (* fp_fTriggerTransmit)(INT16U u16_fPduHandle, INT8U * p_fData));
+
+/* Number of CAN IF ticks (CAN_IF_TICK_US) since CAN_IF_Init, paces the main loop tasks */
+extern INT32U CAN_IF_GetTickCount(void);
+
+/* Start offset chosen by CAN_IF_Init for a cyclic Tx entry, in ms */
+extern EN_CAN_IF_RESULT_t CAN_IF_GetCyclicOffset(INT8U u8_fChannel, INT16U u16_fPduHandle, \
+                                                                        INT32U * p_fOffset);
+
+/* Read (and optionally reset) the counters of a gateway route, index of st_gaGwRouteConfig */
+extern EN_CAN_IF_RESULT_t CAN_IF_GetGatewayStats(INT16U u16_fRoute, \
+                                        ST_CAN_IF_GW_STATS_t * p_stfStats, BOOLEAN b_fClear);
+
 /* Function to read received message object data and identifier */
 extern EN_CAN_RESULT_t CAN_ReadMsg(ST_CAN_MO_INIT_t * p_stfCANMOInit,  \
 				INT8U u8_fMsgobjNo);
@@ -316,8 +518,13 @@ extern EN_CAN_RESULT_t CAN_ConfigMO(ST_CAN_MO_INIT_t * p_stfCANMOInit);
 
 extern flexcan_state_t * g_flexcanStatePtr[CAN_INSTANCE_COUNT];
 
-extern void CAN_TX_Confirmation(mailBox_t *pValue);
-extern void CAN_Rx_Notification(mailBox_t *pValue);
+extern void CAN_TX_Confirmation(INT8U u8_fInstance, mailBox_t * p_fMsgInfo);
+extern void CAN_Rx_Notification(INT8U u8_fInstance, const flexcan_rx_frame_t * p_stfFrame);
+extern void CAN_Error_Notification(INT8U u8_fInstance, flexcan_error_event_t en_fEvent, \
+                                                    const flexcan_error_stats_t * p_stfStats);
+
+/* CAN IF tick, also runs the cyclic Tx scheduler */
+extern void LPIT0_IRQHandler(void);
 
 #endif
 
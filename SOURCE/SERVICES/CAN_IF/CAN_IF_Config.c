@@ -2,7 +2,9 @@
 #include "Includes.h"
 
 #include "CAN_IF.h"
-#include "CAN_IF_COnfig.h"
+#include "CAN_IF_Config.h"
+
+#include "canCom1.h"
 
 /* Mail Box Configuration structure */
 ST_MAILBOX_CONFIG_t st_gMailBoxConfig[] = 
@@ -107,6 +109,7 @@ ST_MAILBOX_CONFIG_t st_gMailBoxConfig[] =
             .u8_mFdPadding = 0
         },
         .u32_mMsgID = 256,
+        .u16_mCycleTime = 100,
     },
     
     /* Signal Group for AVAS_CTRL_CH, ID = 257 */
@@ -124,6 +127,7 @@ ST_MAILBOX_CONFIG_t st_gMailBoxConfig[] =
             .u8_mFdPadding = 0
         },
         .u32_mMsgID = 257,
+        .u16_mCycleTime = 100,
     },
     
     /* Signal Group for EMCM_STAT_CH, ID = 1278 */
@@ -281,4 +285,67 @@ ST_MAILBOX_CONFIG_t st_gMailBoxConfig[] =
         .u32_mMsgID = 1120,
         .u8_EOL = 1,
     }
-};
\ No newline at end of file
+};
+
+/* Channel configuration, index is the FlexCAN instance. The mailboxes of a channel are the */
+/* entries of st_gMailBoxConfig whose u8_mCanNode is the channel number                     */
+const ST_CAN_IF_CHANNEL_CONFIG_t st_gaChannelConfig[CAN_IF_CHANNEL_NUM] = 
+{
+    /* CAN0 : canCom1 component */
+    {
+        .p_mState = &canCom1_State,
+        .p_mUserConfig = &canCom1_InitConfig0,
+        .u32_mBitrate = CAN_IF_BITRATE,
+        .u32_mSamplePoint = CAN_IF_SAMPLE_POINT,
+        .u32_mSjw = CAN_IF_SJW,
+        .u32_mFdBitrate = CAN_IF_FD_DATA_BITRATE,
+        .u32_mFdSamplePoint = CAN_IF_FD_DATA_SAMPLE_POINT,
+        .u32_mFdSjw = CAN_IF_FD_DATA_SJW,
+        .u32_mBusOffDelayMin = CAN_IF_BUSOFF_DELAY_MIN,
+        .u32_mBusOffDelayFactor = CAN_IF_BUSOFF_DELAY_FACTOR,
+        .u32_mBusOffDelayMax = CAN_IF_BUSOFF_DELAY_MAX,
+    },
+    
+    /* CAN1 : not used */
+    {
+        .p_mState = PNULL,
+        .p_mUserConfig = PNULL,
+    },
+    
+    /* CAN2 : not used */
+    {
+        .p_mState = PNULL,
+        .p_mUserConfig = PNULL,
+    }
+};
+
+#if (CAN_IF_GATEWAY == 1U)
+/* Gateway routes, on CAN0 the forwarded IDs are rewritten out of the source ranges : a frame */
+/* received back (self reception, loopback) must not match a route again                      */
+const ST_CAN_IF_GW_ROUTE_CONFIG_t st_gaGwRouteConfig[CAN_IF_GW_ROUTE_NUM] =
+{
+    /* Diagnostic requests 0x700 .. 0x7FF : CAN0 -> CAN0 as 0x600 .. 0x6FF */
+    {
+        .u8_mSrcChannel = CAN_IF_CHANNEL_0,
+        .u32_mSrcID = 0x700,
+        .u32_mSrcMask = 0x700,
+        .en_mMsgIdType = EN_FLEXCAN_MSG_ID_STD,
+        .u8_mDstChannels = (1U << CAN_IF_CHANNEL_0),
+        .u32_mDstID = 0x600,
+        .u32_mDstMask = 0x700,
+        .u32_mMinIntervalUs = 0,
+    },
+    
+    /* BO_ 801 SAS_STAT_CH : CAN0 -> CAN0 as 0x421, at most every 10 ms */
+    {
+        .u8_mSrcChannel = CAN_IF_CHANNEL_0,
+        .u32_mSrcID = 801,
+        .u32_mSrcMask = 0,
+        .en_mMsgIdType = EN_FLEXCAN_MSG_ID_STD,
+        .u8_mDstChannels = (1U << CAN_IF_CHANNEL_0),
+        .u32_mDstID = 0x421,
+        .u32_mDstMask = 0x7FF,
+        .u32_mMinIntervalUs = 10000,
+    }
+};
+#endif
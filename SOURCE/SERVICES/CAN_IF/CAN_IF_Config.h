@@ -2,6 +2,93 @@
 #ifndef _CAN_IF_CONFIG_H_
 #define _CAN_IF_CONFIG_H_
 
+/* 1 : the ISR only queues received frames, CAN_IF_MainFunction delivers them to ISOTP/COM */
+/* 0 : received frames are delivered from the FlexCAN ISR                                 */
+#define CAN_IF_RX_DEFERRED                  (1U)
+
+/* Maximum number of frames per channel delivered per CAN_IF_MainFunction call */
+#define CAN_IF_RX_BATCH_SIZE                (8U)
+
+/* 1 : CAN_IF_WriteMsg queues frames by CAN ID and fills the Tx mailboxes of the */
+/*     configuration table lowest ID first, aborting lower priority frames       */
+/* 0 : CAN_IF_WriteMsg sends directly through the given mailbox                  */
+#define CAN_IF_TX_PRIO_QUEUE                (1U)
+
+/* Number of frames waiting for a Tx mailbox, per channel */
+#define CAN_IF_TX_QUEUE_SIZE                (16U)
+
+/* Frames of a CAN_IF_WriteMsgBatch call prepared on the stack ahead of each interrupt lock */
+#define CAN_IF_TX_BATCH_CHUNK               (4U)
+
+/* Maximum number of Tx mailboxes per channel taken from the configuration table */
+#define CAN_IF_TX_MB_MAX                    (8U)
+
+/* Number of channels with an entry in st_gaChannelConfig, only they get a runtime context */
+#define CAN_IF_CHANNEL_CTX_NUM              (1U)
+
+/* Rx routing hash table of a channel : 2^CAN_IF_RX_ROUTE_BITS slots, at least twice */
+/* CAN_IF_RX_FILTER_MAX                                                              */
+#define CAN_IF_RX_ROUTE_BITS                (7U)
+
+/* Maximum number of masked Rx entries (u32_mAcceptanceMask) per channel */
+#define CAN_IF_RX_RANGE_MAX                 (4U)
+
+/* 1 : Tx entries of the configuration table with a cycle time are sent by CAN IF, paced by */
+/*     an LPIT0 channel, with the payload of the trigger transmit handler                    */
+/* 0 : frames are only sent by CAN_IF_WriteMsg                                               */
+#define CAN_IF_CYCLIC_TX                    (1U)
+
+/* LPIT0 channel and period (us) of the CAN IF tick. It always runs : it paces the cyclic Tx */
+/* entries, whose cycle times are multiples of it, and wakes the main loop every tick        */
+#define CAN_IF_TICK_LPIT_CHANNEL            (0U)
+#define CAN_IF_TICK_US                      (1000UL)
+
+/* Maximum number of cyclic Tx entries per channel */
+#define CAN_IF_CYCLIC_MAX                   (8U)
+
+/* 1 : frames matching a route of st_gaGwRouteConfig are forwarded to the destination channels */
+/*     of the route from the FlexCAN ISR of their source channel, needs CAN_IF_TX_PRIO_QUEUE    */
+/* 0 : no gateway                                                                               */
+#define CAN_IF_GATEWAY                      (0U)
+
+/* Number of gateway routes in st_gaGwRouteConfig, and most routes of one source channel (32 at */
+/* most)                                                                                        */
+#define CAN_IF_GW_ROUTE_NUM                 (2U)
+#define CAN_IF_GW_ROUTE_MAX                 (8U)
+
+/* Maximum number of remote request auto-response mailboxes per channel */
+#define CAN_IF_RESPONSE_MB_MAX              (4U)
+
+/* Maximum number of Rx IDs per channel compiled into hardware acceptance filters at init */
+#define CAN_IF_RX_FILTER_MAX                (64U)
+
+/* Nominal bit timing of CAN0, solved for the FlexCAN PE clock by CAN_IF_Init : bit rate   */
+/* (bit/s), sample point (per mille) and resync jump width (tq, 0 : largest possible)      */
+#define CAN_IF_BITRATE                      (500000UL)
+#define CAN_IF_SAMPLE_POINT                 (875U)
+#define CAN_IF_SJW                          (2U)
+
+/* CAN FD data phase bit timing, used when the controller runs in FD mode */
+#define CAN_IF_FD_DATA_BITRATE              (1000000UL)
+#define CAN_IF_FD_DATA_SAMPLE_POINT         (750U)
+#define CAN_IF_FD_DATA_SJW                  (0U)
+
+/* Bus off recovery of CAN0 : the node stays in bus off for the back-off delay, which starts */
+/* at CAN_IF_BUSOFF_DELAY_MIN ms and grows by CAN_IF_BUSOFF_DELAY_FACTOR per bus off up to   */
+/* CAN_IF_BUSOFF_DELAY_MAX ms. A confirmed transmission resets it. 0 : hardware recovery     */
+#define CAN_IF_BUSOFF_DELAY_MIN             (10UL)
+#define CAN_IF_BUSOFF_DELAY_FACTOR          (2UL)
+#define CAN_IF_BUSOFF_DELAY_MAX             (1000UL)
+
+/* Largest bit rate error accepted by CAN_IF_Init, in ppm (CAN clock tolerance budget) */
+#define CAN_IF_BITRATE_TOLERANCE            (5000UL)
+
 extern ST_MAILBOX_CONFIG_t st_gMailBoxConfig[];
 
+extern const ST_CAN_IF_CHANNEL_CONFIG_t st_gaChannelConfig[CAN_IF_CHANNEL_NUM];
+
+#if (CAN_IF_GATEWAY == 1U)
+extern const ST_CAN_IF_GW_ROUTE_CONFIG_t st_gaGwRouteConfig[CAN_IF_GW_ROUTE_NUM];
+#endif
+
 #endif
\ No newline at end of file
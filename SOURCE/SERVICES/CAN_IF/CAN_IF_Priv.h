@@ -13,6 +13,221 @@
 /* Private Global Definitions Section                                                             */
 /**************************************************************************************************/
 
+/* Pending frame of the Tx priority queue */
+typedef struct
+{
+    /* CAN ID and its format, see CAN_IF_TxArbitrationKey() for the bus arbitration order */
+    INT32U u32_mCANID;
+    BOOLEAN b_mExtended;
+    /* Queueing order, keeps frames of the same ID in FIFO order */
+    INT32U u32_mSeqNo;
+    /* Payload, u8_mDLC bytes used */
+    INT8U u8_maData[CAN_IF_MAX_PAYLOAD];
+    /* Payload size in bytes */
+    INT8U u8_mDLC;
+    /* FD frame format, bit rate switch and padding of the unused DLC bytes */
+    INT8U u8_mFdEnable;
+    INT8U u8_mEnableBrs;
+    INT8U u8_mFdPadding;
+    /* Queued by the gateway, its Tx confirmation is not reported to the upper layers */
+    BOOLEAN b_mGateway;
+    
+}ST_CAN_IF_TX_PDU_t;
+
+/* Tx mailbox owned by the Tx scheduler */
+typedef struct
+{
+    /* FlexCAN MB index */
+    INT8U u8_mMailBoxIndex;
+    /* Frame in the mailbox is waiting for its confirmation */
+    BOOLEAN b_mBusy;
+    /* Abort of the frame has been requested */
+    BOOLEAN b_mAbortPending;
+    /* ID (bit 31 set for an extended ID) and frame format programmed in the mailbox, a frame */
+    /* with the same ones only writes its payload and C/S word                               */
+    INT32U u32_mMbKey;
+    INT8U u8_mMbFdEnable;
+    INT8U u8_mMbEnableBrs;
+    INT8U u8_mMbFdPadding;
+#if (CAN_IF_TX_PRIO_QUEUE == 1U)
+    /* Frame in the mailbox */
+    ST_CAN_IF_TX_PDU_t st_mPdu;
+#endif
+    
+}ST_CAN_IF_TX_MB_t;
+
+/* Mailbox answering the remote requests of an ID in hardware */
+typedef struct
+{
+    /* Answered CAN ID */
+    INT32U u32_mCANID;
+    /* FlexCAN MB index */
+    INT8U u8_mMailBoxIndex;
+    
+}ST_CAN_IF_RESPONSE_MB_t;
+
+/* Cyclic Tx entry of the configuration table */
+typedef struct
+{
+    /* Entry index in st_gMailBoxConfig, handed to the trigger transmit handler */
+    INT16U u16_mPduHandle;
+    /* Cycle time and start offset, in scheduler ticks */
+    INT32U u32_mPeriod;
+    INT32U u32_mOffset;
+    /* Ticks left until the next transmission */
+    INT32U u32_mCountdown;
+    
+}ST_CAN_IF_CYCLIC_PDU_t;
+
+/* Upper layer of a received PDU */
+typedef enum
+{
+    CAN_IF_RX_HANDLER_COM = 0,
+    CAN_IF_RX_HANDLER_ISOTP,
+    /* Gateway source ID without upper layer */
+    CAN_IF_RX_HANDLER_NONE
+    
+}EN_CAN_IF_RX_HANDLER_t;
+
+/* Routing of a configured Rx ID */
+typedef struct
+{
+    /* CAN ID, bit 31 set for an extended ID */
+    INT32U u32_mKey;
+    /* PDU handle handed to the upper layer, see ST_RX_PDU_t */
+    INT16U u16_mPduHandle;
+    /* EN_CAN_IF_RX_HANDLER_t */
+    INT8U u8_mHandler;
+#if (CAN_IF_GATEWAY == 1U)
+    /* Gateway routes of the channel the ID or range may match, bit n : u8_maGwRoute[n] */
+    INT32U u32_mGwRoutes;
+#endif
+    
+}ST_CAN_IF_RX_ROUTE_t;
+
+/* Gateway route, shared with the FlexCAN ISR of its source channel */
+typedef struct
+{
+    /* Source key (bit 31 set for an extended ID) and compared key bits, bit 31 included */
+    INT32U u32_mKey;
+    INT32U u32_mKeyMask;
+    /* Destination channels and ID rewrite, see ST_CAN_IF_GW_ROUTE_CONFIG_t */
+    INT8U u8_mDstChannels;
+    INT32U u32_mDstID;
+    INT32U u32_mDstMask;
+    /* Rate limit and reception time of the last forwarded frame, in bit times of the source */
+    /* channel                                                                              */
+    INT32U u32_mMinInterval;
+    INT32U u32_mLastForward;
+    BOOLEAN b_mForwarded;
+    /* Counters, see CAN_IF_GetGatewayStats() */
+    ST_CAN_IF_GW_STATS_t st_mStats;
+    
+}ST_CAN_IF_GW_ROUTE_t;
+
+/* Hardware acceptance filter : a frame is accepted if (ID & u32_mMask) == u32_mValue */
+typedef struct
+{
+    /* ID bits compared by the filter, already masked */
+    INT32U u32_mValue;
+    /* Compared ID bits */
+    INT32U u32_mMask;
+    /* Filter applies to extended IDs */
+    BOOLEAN b_mExtended;
+    /* Filter also accepts IDs which are not configured, CAN IF filters them in software */
+    BOOLEAN b_mInexact;
+    /* Filter is an Rx FIFO filter element, else a dedicated Rx mailbox */
+    BOOLEAN b_mInFifo;
+    /* Rx FIFO filter element or MB index */
+    INT8U u8_mSlot;
+    
+}ST_CAN_IF_FILTER_t;
+
+/* Runtime context of a channel. Tx scheduler data is shared with the Tx confirmation of the  */
+/* channel (FlexCAN ISR of its instance), accessed with the interrupts disabled outside of it */
+typedef struct
+{
+    /* Configuration of the channel, PNULL : channel not initialized */
+    const ST_CAN_IF_CHANNEL_CONFIG_t * p_mConfig;
+    /* FlexCAN instance */
+    INT8U u8_mInstance;
+    
+#if (CAN_IF_TX_PRIO_QUEUE == 1U)
+    /* Tx priority queue : binary min-heap on (CAN ID, sequence number). Aborted frames come */
+    /* back into the heap, hence the room for one frame per mailbox.                         */
+    ST_CAN_IF_TX_PDU_t st_maTxHeap[CAN_IF_TX_QUEUE_SIZE + CAN_IF_TX_MB_MAX];
+    INT32U u32_mTxHeapCount;
+    INT32U u32_mTxSeqNo;
+#endif
+    
+    /* Tx mailboxes of the configuration table, sorted by MB index */
+    ST_CAN_IF_TX_MB_t st_maTxMailBox[CAN_IF_TX_MB_MAX];
+    INT8U u8_mTxMailBoxCount;
+    
+    /* Transmission time of the frame being confirmed, see CAN_IF_GetTxTimeStamp() */
+    INT32U u32_mTxTimeStamp;
+    
+    /* Bit timing programmed by CAN_IF_SetBitTiming */
+    flexcan_bit_timing_t st_mBitTiming;
+    
+    /* Bus off recovery, shared with the error notification of the channel : node held in  */
+    /* bus off, time it entered bus off, recovery already started, delay of this bus off   */
+    BOOLEAN b_mBusOff;
+    INT32U u32_mBusOffTime;
+    BOOLEAN b_mRecoveryStarted;
+    INT32U u32_mBusOffDelay;
+    INT32U u32_mRecoveryCount;
+    
+    /* Remote request auto-response mailboxes of the configuration table */
+    ST_CAN_IF_RESPONSE_MB_t st_maRespMailBox[CAN_IF_RESPONSE_MB_MAX];
+    INT8U u8_mRespMailBoxCount;
+    
+#if (CAN_IF_CYCLIC_TX == 1U)
+    /* Cyclic Tx entries of the configuration table, shared with the LPIT0 ISR */
+    ST_CAN_IF_CYCLIC_PDU_t st_maCyclic[CAN_IF_CYCLIC_MAX];
+    INT8U u8_mCyclicCount;
+#endif
+    
+#if (CAN_IF_GATEWAY == 1U)
+    /* Gateway routes whose source is the channel, index of st_gaGwRouteConfig */
+    INT8U u8_maGwRoute[CAN_IF_GW_ROUTE_MAX];
+    INT8U u8_mGwRouteCount;
+#endif
+    
+    /* Configured Rx IDs, sorted, bit 31 set for extended IDs */
+    INT32U u32_maRxIdKey[CAN_IF_RX_FILTER_MAX];
+    INT32U u32_mRxIdKeyCount;
+    
+    /* ID ranges of the masked Rx entries and their routing */
+    ST_CAN_IF_FILTER_t st_maRxRange[CAN_IF_RX_RANGE_MAX];
+    ST_CAN_IF_RX_ROUTE_t st_maRxRangeRoute[CAN_IF_RX_RANGE_MAX];
+    INT32U u32_mRxRangeCount;
+    
+    /* Routing of the configured Rx IDs, and its hash table : open addressing on the route  */
+    /* index, multiplier chosen at init for the fewest probes (one : perfect hash)          */
+    ST_CAN_IF_RX_ROUTE_t st_maRxRoute[CAN_IF_RX_FILTER_MAX];
+    INT32U u32_mRxRouteCount;
+    INT8U u8_maRxRouteSlot[1UL << CAN_IF_RX_ROUTE_BITS];
+    INT32U u32_mRxRouteMult;
+    INT32U u32_mRxRouteProbes;
+    
+    /* Hardware acceptance filters planned by CAN_IF_PlanRxFilters */
+    ST_CAN_IF_FILTER_t st_maRxFilter[CAN_IF_RX_FILTER_MAX + CAN_IF_RX_RANGE_MAX];
+    INT32U u32_mRxFilterCount;
+    
+    /* Rx mailboxes of the configuration table free for the filters */
+    INT8U u8_maRxPoolMb[CAN_IF_RX_FILTER_MAX];
+    INT32U u32_mRxPoolMbCount;
+    
+    /* Configured IDs behind an inexact filter, non zero count enables the software filter */
+    INT32U u32_maSwFilterId[CAN_IF_RX_FILTER_MAX];
+    INT32U u32_mSwFilterIdCount;
+    
+    /* Rx FIFO ID filter table handed to the driver, the planned filter elements are set after it */
+    uint32_t u32_maRxFifoIdFilter[128];
+    
+}ST_CAN_IF_CHANNEL_t;
+
 /**************************************************************************************************/
 /* Private Global Variables Section                                                               */
 /**************************************************************************************************/
@@ -0,0 +1,562 @@
+/**************************************************************************************************/
+/* System Header Files Section                                                                    */
+/**************************************************************************************************/
+#include <string.h>
+
+/**************************************************************************************************/
+/* User Header Files Section                                                                      */
+/**************************************************************************************************/
+#include "Includes.h"
+#include "./CAN_IF/CAN_IF.h"
+#include "./CAN_IF/CAN_IF_Config.h"
+#include "COM.h"
+#include "COM_Priv.h"
+
+/**************************************************************************************************/
+/* Global Definitions Section                                                                     */
+/**************************************************************************************************/
+
+/**************************************************************************************************/
+/* Global Variables Section                                                                       */
+/**************************************************************************************************/
+
+/* Raw value of each signal, written by the Rx indication only */
+volatile INT32U u32_gaComSignal[COM_SIGNAL_NUM];
+
+/* Runtime context of each PDU */
+static ST_COM_PDU_t st_gaComPdu[COM_PDU_NUM];
+
+/* COM PDU of each CAN IF PDU handle, COM_PDU_NONE if not bound */
+static INT8U u8_gaComPduOfHandle[COM_CANIF_HANDLE_MAX];
+
+static void COM_RxIndication(INT16U u16_fMsgID, void * p_fRxData);
+static INT8U COM_TriggerTransmit(INT16U u16_fPduHandle, INT8U * p_fData);
+
+/**************************************************************************************************/
+/* Function Name   : COM_LoadWindow                                                               */
+/*                                                                                                */
+/* Description     : Reads the bytes of a signal into its 8 byte window, in the byte order of     */
+/*                   the signal. Called with constant arguments from the pack / unpack cases,     */
+/*                   the loop unrolls into the byte loads of the signal only.                     */
+/*                                                                                                */
+/* In Params       : const INT8U * p_fData : First byte of the window                             */
+/*                   INT8U u8_fBytes : Bytes of the signal, the others read as 0                  */
+/*                   BOOLEAN b_fBigEndian : 1 for a big endian window                             */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT64U : Window, signal LSB at the bit position of the layout                */
+/**************************************************************************************************/
+
+static INT64U COM_LoadWindow(const INT8U * p_fData, INT8U u8_fBytes, BOOLEAN b_fBigEndian)
+{
+    INT64U u64_lWindow = 0U;
+    INT32U u32_lIndex;
+
+    for(u32_lIndex = 0U; u32_lIndex < u8_fBytes; u32_lIndex++)
+    {
+        u64_lWindow |= (INT64U)p_fData[u32_lIndex] << \
+                            ((0U != b_fBigEndian) ? (56U - (8U * u32_lIndex)) : (8U * u32_lIndex));
+    }
+
+    return u64_lWindow;
+}
+
+/**************************************************************************************************/
+/* Function Name   : COM_StoreWindow                                                              */
+/*                                                                                                */
+/* Description     : Writes back the bytes of a signal from its window, reverse of                */
+/*                   COM_LoadWindow()                                                             */
+/*                                                                                                */
+/* In Params       : INT64U u64_fWindow : Window                                                  */
+/*                   INT8U u8_fBytes : Bytes of the signal                                        */
+/*                   BOOLEAN b_fBigEndian : 1 for a big endian window                             */
+/*                                                                                                */
+/* Out Params      : INT8U * p_fData : First byte of the window                                   */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void COM_StoreWindow(INT8U * p_fData, INT64U u64_fWindow, INT8U u8_fBytes, \
+                                                                            BOOLEAN b_fBigEndian)
+{
+    INT32U u32_lIndex;
+
+    for(u32_lIndex = 0U; u32_lIndex < u8_fBytes; u32_lIndex++)
+    {
+        p_fData[u32_lIndex] = (INT8U)(u64_fWindow >> \
+                            ((0U != b_fBigEndian) ? (56U - (8U * u32_lIndex)) : (8U * u32_lIndex)));
+    }
+}
+
+/* Unpack case of a signal of COM_SIGNAL_LIST : byte, width, shift, mask and sign bit are */
+/* constants, signed signals are sign extended by (raw ^ sign) - sign                     */
+#define COM_UNPACK_CASE(sig, pdu, order, start, len, sign, factor, offset)                        \
+        case (sig):                                                                               \
+            u32_lRaw = (INT32U)(COM_LoadWindow(&p_fData[(start) / 8U],                            \
+                            COM_END_BYTE_##order(start, len) - (INT8U)((start) / 8U),             \
+                            COM_BIG_ENDIAN_##order) >> COM_SHIFT_##order(start, len));            \
+            u32_lRaw &= COM_SIGNAL_MASK(len);                                                     \
+            u32_lRaw = (u32_lRaw ^ COM_SIGN_BIT_##sign(len)) - COM_SIGN_BIT_##sign(len);          \
+            break;
+
+/* Pack case of a signal of COM_SIGNAL_LIST, only the bytes of the signal are rewritten */
+#define COM_PACK_CASE(sig, pdu, order, start, len, sign, factor, offset)                          \
+        case (sig):                                                                               \
+            u64_lWindow = COM_LoadWindow(&p_fData[(start) / 8U],                                  \
+                            COM_END_BYTE_##order(start, len) - (INT8U)((start) / 8U),             \
+                            COM_BIG_ENDIAN_##order);                                              \
+            u64_lWindow &= ~((INT64U)COM_SIGNAL_MASK(len) << COM_SHIFT_##order(start, len));      \
+            u64_lWindow |= (INT64U)(u32_fValue & COM_SIGNAL_MASK(len)) <<                         \
+                                                            COM_SHIFT_##order(start, len);        \
+            COM_StoreWindow(&p_fData[(start) / 8U], u64_lWindow,                                  \
+                            COM_END_BYTE_##order(start, len) - (INT8U)((start) / 8U),             \
+                            COM_BIG_ENDIAN_##order);                                              \
+            break;
+
+/**************************************************************************************************/
+/* Function Name   : COM_UnpackSignal                                                             */
+/*                                                                                                */
+/* Description     : Extracts a signal, through the case of the signal expanded from              */
+/*                   COM_SIGNAL_LIST                                                              */
+/*                                                                                                */
+/* In Params       : EN_COM_SIGNAL_ID_t en_fSignal : Signal                                       */
+/*                   const INT8U * p_fData : PDU payload (COM_PDU_BUFFER_SIZE bytes)              */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT32U : Raw value, 0 for an unknown signal                                  */
+/**************************************************************************************************/
+
+static INT32U COM_UnpackSignal(EN_COM_SIGNAL_ID_t en_fSignal, const INT8U * p_fData)
+{
+    INT32U u32_lRaw = 0U;
+
+    switch(en_fSignal)
+    {
+        COM_SIGNAL_LIST(COM_UNPACK_CASE)
+
+        default:
+            break;
+    }
+
+    return u32_lRaw;
+}
+
+/**************************************************************************************************/
+/* Function Name   : COM_PackSignal                                                               */
+/*                                                                                                */
+/* Description     : Inserts a signal through the case of the signal expanded from                */
+/*                   COM_SIGNAL_LIST, higher bits of the value are dropped                        */
+/*                                                                                                */
+/* In Params       : EN_COM_SIGNAL_ID_t en_fSignal : Signal                                       */
+/*                   INT32U u32_fValue : Raw value                                                */
+/*                                                                                                */
+/* Out Params      : INT8U * p_fData : PDU payload (COM_PDU_BUFFER_SIZE bytes)                    */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void COM_PackSignal(EN_COM_SIGNAL_ID_t en_fSignal, INT8U * p_fData, INT32U u32_fValue)
+{
+    INT64U u64_lWindow;
+
+    switch(en_fSignal)
+    {
+        COM_SIGNAL_LIST(COM_PACK_CASE)
+
+        default:
+            break;
+    }
+}
+
+/**************************************************************************************************/
+/* Function Name   : COM_RxIndication                                                             */
+/*                                                                                                */
+/* Description     : CAN IF Rx indication : keeps the payload of the PDU and unpacks all its      */
+/*                   signals. Signals beyond a shorter received frame keep their value.           */
+/*                                                                                                */
+/* In Params       : INT16U u16_fMsgID : Received Message ID                                      */
+/*                   void * p_fRxData : Received frame, ST_RX_PDU_t                               */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void COM_RxIndication(INT16U u16_fMsgID, void * p_fRxData)
+{
+    const ST_RX_PDU_t * p_stlRxPdu = (const ST_RX_PDU_t *)p_fRxData;
+    const ST_COM_SIGNAL_CONFIG_t * p_stlSignal;
+    ST_COM_PDU_t * p_stlPdu;
+    INT32U u32_lIndex;
+    INT8U u8_lLength;
+
+    (void)u16_fMsgID;
+
+    if((p_stlRxPdu->u16_mPduHandle < COM_CANIF_HANDLE_MAX) && \
+       (COM_PDU_NONE != u8_gaComPduOfHandle[p_stlRxPdu->u16_mPduHandle]))
+    {
+        p_stlPdu = &st_gaComPdu[u8_gaComPduOfHandle[p_stlRxPdu->u16_mPduHandle]];
+        u8_lLength = p_stlRxPdu->u8_mDataSize;
+        if(u8_lLength > CAN_IF_MAX_PAYLOAD)
+        {
+            u8_lLength = CAN_IF_MAX_PAYLOAD;
+        }
+
+        /* Odd count : readers of several signals retry */
+        p_stlPdu->u32_mCounter++;
+
+        memcpy((void *)&p_stlPdu->u8_maData[0], (const void *)p_stlRxPdu->p_mDataBuff, \
+                                                                            (size_t)u8_lLength);
+        p_stlSignal = &st_gaComSignalConfig[p_stlPdu->u8_mFirstSignal];
+        for(u32_lIndex = 0U; u32_lIndex < p_stlPdu->u8_mSignalCount; u32_lIndex++)
+        {
+            if(p_stlSignal->u8_mEndByte <= u8_lLength)
+            {
+                u32_gaComSignal[p_stlPdu->u8_mFirstSignal + u32_lIndex] = COM_UnpackSignal( \
+                        (EN_COM_SIGNAL_ID_t)(p_stlPdu->u8_mFirstSignal + u32_lIndex), \
+                                                                &p_stlPdu->u8_maData[0]);
+            }
+            p_stlSignal++;
+        }
+
+        p_stlPdu->u32_mCounter++;
+    }
+}
+
+/**************************************************************************************************/
+/* Function Name   : COM_TriggerTransmit                                                          */
+/*                                                                                                */
+/* Description     : Payload of a cyclic Tx PDU, called by CAN IF from its scheduler tick. Signal */
+/*                   writes are done with the interrupts disabled, the copy is consistent.        */
+/*                                                                                                */
+/* In Params       : INT16U u16_fPduHandle : Entry of the CAN IF configuration table              */
+/*                                                                                                */
+/* Out Params      : INT8U * p_fData : Payload                                                    */
+/*                                                                                                */
+/* Return Value    : INT8U : Payload size in bytes, 0 if the entry is not a COM Tx PDU            */
+/**************************************************************************************************/
+
+static INT8U COM_TriggerTransmit(INT16U u16_fPduHandle, INT8U * p_fData)
+{
+    INT8U u8_lLength = 0U;
+    INT8U u8_lPdu;
+
+    if(u16_fPduHandle < COM_CANIF_HANDLE_MAX)
+    {
+        u8_lPdu = u8_gaComPduOfHandle[u16_fPduHandle];
+        if((COM_PDU_NONE != u8_lPdu) && (COM_PDU_TX == st_gaComPduConfig[u8_lPdu].en_mDirection))
+        {
+            u8_lLength = st_gaComPduConfig[u8_lPdu].u8_mLength;
+            memcpy((void *)p_fData, (const void *)&st_gaComPdu[u8_lPdu].u8_maData[0], \
+                                                                            (size_t)u8_lLength);
+        }
+    }
+
+    return u8_lLength;
+}
+
+/**************************************************************************************************/
+/* Function Name   : COM_Init                                                                     */
+/*                                                                                                */
+/* Description     : Binds each PDU to its entry of the CAN IF configuration table, checks the    */
+/*                   signal table and registers the COM Rx indication with CAN IF                 */
+/*                                                                                                */
+/* In Params       : None                                                                         */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_COM_RESULT_t : COM_ERROR if a PDU has no CAN IF entry or a signal does    */
+/*                   not fit its PDU, or the signals of a PDU are not consecutive                 */
+/**************************************************************************************************/
+
+EN_COM_RESULT_t COM_Init(void)
+{
+    EN_COM_RESULT_t en_lResult = COM_OK;
+    const ST_COM_PDU_CONFIG_t * p_stlPduConfig;
+    const ST_COM_SIGNAL_CONFIG_t * p_stlSignal;
+    const ST_MAILBOX_CONFIG_t * p_stlConfig;
+    ST_COM_PDU_t * p_stlPdu;
+    EN_MAILBOX_DIRECTION_t en_lDirection;
+    INT32U u32_lIndex;
+    INT16U u16_lHandle;
+
+    memset((void *)&st_gaComPdu[0], 0, sizeof(st_gaComPdu));
+    memset((void *)&u8_gaComPduOfHandle[0], COM_PDU_NONE, sizeof(u8_gaComPduOfHandle));
+
+    for(u32_lIndex = 0U; u32_lIndex < COM_PDU_NUM; u32_lIndex++)
+    {
+        p_stlPduConfig = &st_gaComPduConfig[u32_lIndex];
+        en_lDirection = (COM_PDU_TX == p_stlPduConfig->en_mDirection) ? \
+                                                    EN_MAILBOX_TRANSMIT : EN_MAILBOX_RECEIVE;
+        p_stlConfig = &st_gMailBoxConfig[0];
+        u16_lHandle = 0U;
+
+        while(1)
+        {
+            if((en_lDirection == p_stlConfig->en_mMailBoxDirection) && \
+               (CAN_DATA_FRAME == p_stlConfig->en_mFrameType) && \
+               (p_stlPduConfig->u8_mChannel == p_stlConfig->u8_mCanNode) && \
+               (p_stlPduConfig->u32_mCanID == p_stlConfig->u32_mMsgID))
+            {
+                break;
+            }
+
+            if(p_stlConfig->u8_EOL)
+            {
+                u16_lHandle = COM_CANIF_HANDLE_MAX;
+                break;
+            }
+            p_stlConfig++;
+            u16_lHandle++;
+        }
+
+        if((u16_lHandle >= COM_CANIF_HANDLE_MAX) || \
+           (p_stlPduConfig->u8_mLength > CAN_IF_MAX_PAYLOAD))
+        {
+            en_lResult = COM_ERROR;
+        }
+        else
+        {
+            st_gaComPdu[u32_lIndex].u16_mCanIfPdu = u16_lHandle;
+            st_gaComPdu[u32_lIndex].u8_mMailBox = p_stlConfig->u8_mMailBoxIndex;
+            u8_gaComPduOfHandle[u16_lHandle] = (INT8U)u32_lIndex;
+        }
+    }
+
+    for(u32_lIndex = 0U; u32_lIndex < COM_SIGNAL_NUM; u32_lIndex++)
+    {
+        p_stlSignal = &st_gaComSignalConfig[u32_lIndex];
+
+        if((p_stlSignal->en_mPdu >= COM_PDU_NUM) || (0U == p_stlSignal->u32_mMask) || \
+           (p_stlSignal->u8_mEndByte > st_gaComPduConfig[p_stlSignal->en_mPdu].u8_mLength))
+        {
+            en_lResult = COM_ERROR;
+        }
+        else
+        {
+            p_stlPdu = &st_gaComPdu[p_stlSignal->en_mPdu];
+            if(0U == p_stlPdu->u8_mSignalCount)
+            {
+                p_stlPdu->u8_mFirstSignal = (INT8U)u32_lIndex;
+            }
+            else if((p_stlPdu->u8_mFirstSignal + p_stlPdu->u8_mSignalCount) != u32_lIndex)
+            {
+                /* Signals of the PDU are split in the signal table */
+                en_lResult = COM_ERROR;
+            }
+            else
+            {
+                /* No Action */
+            }
+            p_stlPdu->u8_mSignalCount++;
+        }
+        u32_gaComSignal[u32_lIndex] = 0U;
+    }
+
+    if(COM_OK == en_lResult)
+    {
+        (void)CAN_IF_UpdateComHandlers(PNULL, &COM_RxIndication);
+        (void)CAN_IF_UpdateTriggerTransmit(&COM_TriggerTransmit);
+    }
+
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : COM_ReadSignal                                                               */
+/*                                                                                                */
+/* Description     : Raw value of a signal, see COM_READ_SIGNAL_U() for the unchecked read        */
+/*                                                                                                */
+/* In Params       : EN_COM_SIGNAL_ID_t en_fSignal : Signal                                       */
+/*                                                                                                */
+/* Out Params      : INT32U * p_fValue : Raw value, sign extended for a signed signal             */
+/*                                                                                                */
+/* Return Value    : EN_COM_RESULT_t : COM_ERROR on an unknown signal                             */
+/**************************************************************************************************/
+
+EN_COM_RESULT_t COM_ReadSignal(EN_COM_SIGNAL_ID_t en_fSignal, INT32U * p_fValue)
+{
+    EN_COM_RESULT_t en_lResult = COM_OK;
+
+    if(en_fSignal >= COM_SIGNAL_NUM)
+    {
+        en_lResult = COM_ERROR;
+    }
+    else
+    {
+        *p_fValue = u32_gaComSignal[en_fSignal];
+    }
+
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : COM_ReadSignalPhys                                                           */
+/*                                                                                                */
+/* Description     : Physical value of a signal, raw value * factor + offset                      */
+/*                                                                                                */
+/* In Params       : EN_COM_SIGNAL_ID_t en_fSignal : Signal                                       */
+/*                                                                                                */
+/* Out Params      : INT32F * p_fValue : Physical value                                           */
+/*                                                                                                */
+/* Return Value    : EN_COM_RESULT_t : COM_ERROR on an unknown signal                             */
+/**************************************************************************************************/
+
+EN_COM_RESULT_t COM_ReadSignalPhys(EN_COM_SIGNAL_ID_t en_fSignal, INT32F * p_fValue)
+{
+    EN_COM_RESULT_t en_lResult = COM_OK;
+    const ST_COM_SIGNAL_CONFIG_t * p_stlSignal;
+    INT32U u32_lRaw;
+
+    if(en_fSignal >= COM_SIGNAL_NUM)
+    {
+        en_lResult = COM_ERROR;
+    }
+    else
+    {
+        p_stlSignal = &st_gaComSignalConfig[en_fSignal];
+        u32_lRaw = u32_gaComSignal[en_fSignal];
+        *p_fValue = ((0U != p_stlSignal->u32_mSignBit) ? (INT32F)(INT32S)u32_lRaw : \
+                    (INT32F)u32_lRaw) * p_stlSignal->f_mFactor + p_stlSignal->f_mOffset;
+    }
+
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : COM_WriteSignal                                                              */
+/*                                                                                                */
+/* Description     : Packs a signal into the payload of its Tx PDU                                */
+/*                                                                                                */
+/* In Params       : EN_COM_SIGNAL_ID_t en_fSignal : Signal                                       */
+/*                   INT32U u32_fValue : Raw value                                                */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_COM_RESULT_t : COM_ERROR on an unknown signal or a signal of an Rx PDU    */
+/**************************************************************************************************/
+
+EN_COM_RESULT_t COM_WriteSignal(EN_COM_SIGNAL_ID_t en_fSignal, INT32U u32_fValue)
+{
+    EN_COM_RESULT_t en_lResult = COM_OK;
+    const ST_COM_SIGNAL_CONFIG_t * p_stlSignal;
+
+    if((en_fSignal >= COM_SIGNAL_NUM) || \
+       (COM_PDU_TX != st_gaComPduConfig[st_gaComSignalConfig[en_fSignal].en_mPdu].en_mDirection))
+    {
+        en_lResult = COM_ERROR;
+    }
+    else
+    {
+        p_stlSignal = &st_gaComSignalConfig[en_fSignal];
+
+        /* Read-modify-write of the window, shared with the other signals of the PDU */
+        INT_SYS_DisableIRQGlobal();
+        COM_PackSignal(en_fSignal, &st_gaComPdu[p_stlSignal->en_mPdu].u8_maData[0], u32_fValue);
+        u32_gaComSignal[en_fSignal] = ((u32_fValue & p_stlSignal->u32_mMask) ^ \
+                                    p_stlSignal->u32_mSignBit) - p_stlSignal->u32_mSignBit;
+        INT_SYS_EnableIRQGlobal();
+    }
+
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : COM_WriteSignalPhys                                                          */
+/*                                                                                                */
+/* Description     : Packs a physical value, (value - offset) / factor rounded to nearest         */
+/*                                                                                                */
+/* In Params       : EN_COM_SIGNAL_ID_t en_fSignal : Signal                                       */
+/*                   INT32F f_fValue : Physical value                                             */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_COM_RESULT_t : COM_ERROR on an unknown signal or a signal of an Rx PDU    */
+/**************************************************************************************************/
+
+EN_COM_RESULT_t COM_WriteSignalPhys(EN_COM_SIGNAL_ID_t en_fSignal, INT32F f_fValue)
+{
+    EN_COM_RESULT_t en_lResult = COM_ERROR;
+    INT32F f_lRaw;
+
+    if(en_fSignal < COM_SIGNAL_NUM)
+    {
+        f_lRaw = (f_fValue - st_gaComSignalConfig[en_fSignal].f_mOffset) / \
+                                                    st_gaComSignalConfig[en_fSignal].f_mFactor;
+        f_lRaw += (f_lRaw < 0.0F) ? -0.5F : 0.5F;
+        en_lResult = COM_WriteSignal(en_fSignal, (INT32U)(INT32S)f_lRaw);
+    }
+
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : COM_SendPdu                                                                  */
+/*                                                                                                */
+/* Description     : Queues a Tx PDU to CAN IF with the signal values written so far              */
+/*                                                                                                */
+/* In Params       : EN_COM_PDU_ID_t en_fPdu : PDU                                                */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_COM_RESULT_t : COM_ERROR on an unknown or Rx PDU, or if CAN IF refuses    */
+/*                   the frame                                                                    */
+/**************************************************************************************************/
+
+EN_COM_RESULT_t COM_SendPdu(EN_COM_PDU_ID_t en_fPdu)
+{
+    EN_COM_RESULT_t en_lResult = COM_OK;
+    const ST_COM_PDU_CONFIG_t * p_stlPduConfig;
+
+    if((en_fPdu >= COM_PDU_NUM) || (COM_PDU_TX != st_gaComPduConfig[en_fPdu].en_mDirection))
+    {
+        en_lResult = COM_ERROR;
+    }
+    else
+    {
+        p_stlPduConfig = &st_gaComPduConfig[en_fPdu];
+
+        /* CAN IF copies the payload, no signal update can slip in between */
+        INT_SYS_DisableIRQGlobal();
+        if(CAN_IF_OK != CAN_IF_WriteMsg(p_stlPduConfig->u8_mChannel, p_stlPduConfig->u32_mCanID, \
+                                        st_gaComPdu[en_fPdu].u8_mMailBox, \
+                                        &st_gaComPdu[en_fPdu].u8_maData[0], \
+                                        p_stlPduConfig->u8_mLength))
+        {
+            en_lResult = COM_ERROR;
+        }
+        INT_SYS_EnableIRQGlobal();
+    }
+
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : COM_GetPduCounter                                                            */
+/*                                                                                                */
+/* Description     : Reception counter of a PDU, odd while its signals are updated                */
+/*                                                                                                */
+/* In Params       : EN_COM_PDU_ID_t en_fPdu : PDU                                                */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT32U : Counter, 0 for an unknown PDU                                       */
+/**************************************************************************************************/
+
+INT32U COM_GetPduCounter(EN_COM_PDU_ID_t en_fPdu)
+{
+    INT32U u32_lCounter = 0U;
+
+    if(en_fPdu < COM_PDU_NUM)
+    {
+        u32_lCounter = st_gaComPdu[en_fPdu].u32_mCounter;
+    }
+
+    return u32_lCounter;
+}
+
+/**************************************************************************************************/
+/* End of COM.c                                                                                   */
+/**************************************************************************************************/
@@ -0,0 +1,137 @@
+
+#ifndef _COM_H_
+#define _COM_H_
+
+/**************************************************************************************************/
+/* System Header Files Section                                                                    */
+/**************************************************************************************************/
+#include "Includes.h"
+
+/**************************************************************************************************/
+/* User Header Files Section                                                                      */
+/**************************************************************************************************/
+#include "COM_Config.h"
+
+/**************************************************************************************************/
+/* Export Global Definitions Section                                                              */
+/**************************************************************************************************/
+
+/* Mask of a signal of len bits (1 .. 32) */
+#define COM_SIGNAL_MASK(len)                          (0xFFFFFFFFUL >> (32U - (len)))
+
+/* Layout of a signal of the DBC SG_ line "start|len@1" (little endian, Intel) : the        */
+/* signal is extracted from the 8 byte little endian window starting at the byte of its LSB */
+#define COM_BIG_ENDIAN_LE                             (0U)
+#define COM_SHIFT_LE(start, len)                      ((INT8U)((start) % 8U))
+#define COM_END_BYTE_LE(start, len)                   ((INT8U)((((start) + (len) - 1U) / 8U) + 1U))
+
+/* Layout of a signal of the DBC SG_ line "start|len@0" (big endian, Motorola, start is */
+/* the MSB) : the signal is extracted from the 8 byte big endian window starting at the */
+/* byte of its MSB                                                                      */
+#define COM_BIG_ENDIAN_BE                             (1U)
+#define COM_SHIFT_BE(start, len)                      ((INT8U)(57U + ((start) % 8U) - (len)))
+#define COM_END_BYTE_BE(start, len)                                                           \
+        ((INT8U)(((((start) & ~7U) + 7U - ((start) % 8U) + (len) - 1U) / 8U) + 1U))
+
+/* Layout fields of a signal descriptor, order is LE or BE */
+#define COM_SIGNAL_LAYOUT(order, start, len)                                                  \
+        .u8_mByte = (INT8U)((start) / 8U),                                                    \
+        .b_mBigEndian = COM_BIG_ENDIAN_##order,                                               \
+        .u8_mShift = COM_SHIFT_##order(start, len),                                           \
+        .u32_mMask = COM_SIGNAL_MASK(len),                                                    \
+        .u8_mEndByte = COM_END_BYTE_##order(start, len)
+#define COM_SIGNAL_LE(start, len)                     COM_SIGNAL_LAYOUT(LE, start, len)
+#define COM_SIGNAL_BE(start, len)                     COM_SIGNAL_LAYOUT(BE, start, len)
+
+/* Sign bit of a signal of len bits ("+" / "-" of the DBC SG_ line), 0 for an unsigned one */
+#define COM_SIGN_BIT_UNSIGNED(len)                    (0UL)
+#define COM_SIGN_BIT_SIGNED(len)                      (1UL << ((len) - 1U))
+#define COM_SIGNAL_UNSIGNED(len)                      .u32_mSignBit = COM_SIGN_BIT_UNSIGNED(len)
+#define COM_SIGNAL_SIGNED(len)                        .u32_mSignBit = COM_SIGN_BIT_SIGNED(len)
+
+/* Lock-free read of the last received raw value of a signal, signed signals are sign extended */
+#define COM_READ_SIGNAL_U(sig)                        (u32_gaComSignal[(sig)])
+#define COM_READ_SIGNAL_S(sig)                        ((INT32S)u32_gaComSignal[(sig)])
+
+typedef enum
+{
+    COM_OK = 0x00,
+    COM_ERROR
+
+}EN_COM_RESULT_t;
+
+typedef enum
+{
+    COM_PDU_RX = 0x00,
+    COM_PDU_TX
+
+}EN_COM_PDU_DIRECTION_t;
+
+/* PDU, bound at COM_Init to the entry of the CAN IF configuration table with the same */
+/* channel, ID and direction                                                           */
+typedef struct
+{
+    INT8U u8_mChannel;
+    INT32U u32_mCanID;
+    EN_COM_PDU_DIRECTION_t en_mDirection;
+    /* Payload size in bytes (DLC of the DBC BO_ line) */
+    INT8U u8_mLength;
+
+}ST_COM_PDU_CONFIG_t;
+
+/* Signal, the layout fields are filled by COM_SIGNAL_LE() / COM_SIGNAL_BE(). Pack and */
+/* unpack do not read them, they are expanded per signal from COM_SIGNAL_LIST.         */
+typedef struct
+{
+    /* PDU carrying the signal, signals of a PDU are consecutive in the signal table */
+    EN_COM_PDU_ID_t en_mPdu;
+    /* First byte and byte order of the 8 byte window holding the signal */
+    INT8U u8_mByte;
+    BOOLEAN b_mBigEndian;
+    /* Position of the LSB in the window and mask of the signal */
+    INT8U u8_mShift;
+    INT32U u32_mMask;
+    /* Payload bytes needed by the signal */
+    INT8U u8_mEndByte;
+    /* Sign bit of a signed signal, 0 for an unsigned one */
+    INT32U u32_mSignBit;
+    /* Physical value = raw value * factor + offset */
+    INT32F f_mFactor;
+    INT32F f_mOffset;
+
+}ST_COM_SIGNAL_CONFIG_t;
+
+/**************************************************************************************************/
+/* Export Global Variable Section                                                                 */
+/**************************************************************************************************/
+
+/* Raw value of each signal, see COM_READ_SIGNAL_U() */
+extern volatile INT32U u32_gaComSignal[COM_SIGNAL_NUM];
+
+/**************************************************************************************************/
+/* Export Functions Section                                                                       */
+/**************************************************************************************************/
+
+/* Binds the PDUs to CAN IF and registers the COM Rx indication and cyclic Tx payload source */
+extern EN_COM_RESULT_t COM_Init(void);
+
+/* Raw and physical value of a signal */
+extern EN_COM_RESULT_t COM_ReadSignal(EN_COM_SIGNAL_ID_t en_fSignal, INT32U * p_fValue);
+extern EN_COM_RESULT_t COM_ReadSignalPhys(EN_COM_SIGNAL_ID_t en_fSignal, INT32F * p_fValue);
+
+/* Updates a signal of a Tx PDU, sent with the next COM_SendPdu() or cycle of the PDU */
+extern EN_COM_RESULT_t COM_WriteSignal(EN_COM_SIGNAL_ID_t en_fSignal, INT32U u32_fValue);
+extern EN_COM_RESULT_t COM_WriteSignalPhys(EN_COM_SIGNAL_ID_t en_fSignal, INT32F f_fValue);
+
+/* Queues a Tx PDU with its current signal values */
+extern EN_COM_RESULT_t COM_SendPdu(EN_COM_PDU_ID_t en_fPdu);
+
+/* Number of receptions of a PDU, odd while its signals are being updated. Signals of one */
+/* PDU read between two equal even counts come from the same frame.                       */
+extern INT32U COM_GetPduCounter(EN_COM_PDU_ID_t en_fPdu);
+
+#endif
+
+/**************************************************************************************************/
+/* End of COM.h                                                                                   */
+/**************************************************************************************************/
@@ -0,0 +1,59 @@
+
+#include "Includes.h"
+
+#include "./CAN_IF/CAN_IF.h"
+#include "COM.h"
+#include "COM_Priv.h"
+
+/* PDU Configuration structure, from the BO_ lines of the DBC */
+const ST_COM_PDU_CONFIG_t st_gaComPduConfig[COM_PDU_NUM] =
+{
+    /* BO_ 536 EBCM_STA1_CH: 8 EBCM */
+    [COM_PDU_EBCM_STA1_CH] = {CAN_IF_CHANNEL_0, 536, COM_PDU_RX, 8},
+    /* BO_ 600 EBCM_STA3_CH: 8 EBCM */
+    [COM_PDU_EBCM_STA3_CH] = {CAN_IF_CHANNEL_0, 600, COM_PDU_RX, 8},
+    /* BO_ 520 EBCM_STA2_CH: 8 EBCM */
+    [COM_PDU_EBCM_STA2_CH] = {CAN_IF_CHANNEL_0, 520, COM_PDU_RX, 8},
+    /* BO_ 545 EPCM_STA1_CH: 8 EPCM */
+    [COM_PDU_EPCM_STA1_CH] = {CAN_IF_CHANNEL_0, 545, COM_PDU_RX, 8},
+    /* BO_ 256 AVAS_STAT_CH: 1 AVAS */
+    [COM_PDU_AVAS_STAT_CH] = {CAN_IF_CHANNEL_0, 256, COM_PDU_TX, 1},
+    /* BO_ 257 AVAS_CTRL_CH: 1 CIU */
+    [COM_PDU_AVAS_CTRL_CH] = {CAN_IF_CHANNEL_0, 257, COM_PDU_TX, 1},
+    /* BO_ 1278 EMCM_STAT_CH: 8 CIU */
+    [COM_PDU_EMCM_STAT_CH] = {CAN_IF_CHANNEL_0, 1278, COM_PDU_RX, 8},
+    /* BO_ 801 SAS_STAT_CH: 5 SAS */
+    [COM_PDU_SAS_STAT_CH] = {CAN_IF_CHANNEL_0, 801, COM_PDU_RX, 5},
+    /* BO_ 517 EPCM_STA2_CH: 8 EPCM */
+    [COM_PDU_EPCM_STA2_CH] = {CAN_IF_CHANNEL_0, 517, COM_PDU_RX, 8},
+    /* BO_ 597 EPCM_STA3_CH: 8 EPCM */
+    [COM_PDU_EPCM_STA3_CH] = {CAN_IF_CHANNEL_0, 597, COM_PDU_RX, 8},
+    /* BO_ 613 EPCM_STA4_CH: 8 EPCM */
+    [COM_PDU_EPCM_STA4_CH] = {CAN_IF_CHANNEL_0, 613, COM_PDU_RX, 8},
+    /* BO_ 616 EPCM_STA5_CH: 8 EPCM */
+    [COM_PDU_EPCM_STA5_CH] = {CAN_IF_CHANNEL_0, 616, COM_PDU_RX, 8},
+    /* BO_ 458 GSM_CTRL_CH: 8 EPCM */
+    [COM_PDU_GSM_CTRL_CH] = {CAN_IF_CHANNEL_0, 458, COM_PDU_RX, 8},
+    /* BO_ 1120 IPC_ILLM_CH: 3 CIU */
+    [COM_PDU_IPC_ILLM_CH] = {CAN_IF_CHANNEL_0, 1120, COM_PDU_RX, 3},
+};
+
+/* Signal Configuration structure, one entry per line of COM_SIGNAL_LIST */
+#define COM_SIGNAL_ENTRY(sig, pdu, order, start, len, sign, factor, offset)                   \
+    [sig] =                                                                                   \
+    {                                                                                         \
+        .en_mPdu = (pdu),                                                                     \
+        COM_SIGNAL_LAYOUT(order, start, len),                                                 \
+        COM_SIGNAL_##sign(len),                                                               \
+        .f_mFactor = (factor),                                                                \
+        .f_mOffset = (offset)                                                                 \
+    },
+
+const ST_COM_SIGNAL_CONFIG_t st_gaComSignalConfig[COM_SIGNAL_NUM] =
+{
+    COM_SIGNAL_LIST(COM_SIGNAL_ENTRY)
+};
+
+/**************************************************************************************************/
+/* End of COM_Config.c                                                                            */
+/**************************************************************************************************/
@@ -0,0 +1,53 @@
+
+#ifndef _COM_CONFIG_H_
+#define _COM_CONFIG_H_
+
+/* Highest CAN IF PDU handle (entry index of st_gMailBoxConfig) COM can be bound to, plus one */
+#define COM_CANIF_HANDLE_MAX                (32U)
+
+/* PDUs of the DBC, index of st_gaComPduConfig */
+typedef enum
+{
+    COM_PDU_EBCM_STA1_CH = 0,
+    COM_PDU_EBCM_STA3_CH,
+    COM_PDU_EBCM_STA2_CH,
+    COM_PDU_EPCM_STA1_CH,
+    COM_PDU_AVAS_STAT_CH,
+    COM_PDU_AVAS_CTRL_CH,
+    COM_PDU_EMCM_STAT_CH,
+    COM_PDU_SAS_STAT_CH,
+    COM_PDU_EPCM_STA2_CH,
+    COM_PDU_EPCM_STA3_CH,
+    COM_PDU_EPCM_STA4_CH,
+    COM_PDU_EPCM_STA5_CH,
+    COM_PDU_GSM_CTRL_CH,
+    COM_PDU_IPC_ILLM_CH,
+    COM_PDU_NUM
+
+}EN_COM_PDU_ID_t;
+
+/* Signals grouped by PDU : X(signal, PDU, byte order LE / BE, start bit, length,          */
+/* UNSIGNED / SIGNED, factor, offset). Expanded into the signal IDs, st_gaComSignalConfig  */
+/* and the pack / unpack code of each signal, with its layout as constants.                */
+/* The signal layouts of the DBC are not imported yet : the entries below are placeholders */
+/* covering the whole payload of their PDU.                                                */
+#define COM_SIGNAL_LIST(X)                                                                    \
+    X(COM_SIG_AVAS_STAT, COM_PDU_AVAS_STAT_CH, LE, 0U, 8U, UNSIGNED, 1.0F, 0.0F)              \
+    X(COM_SIG_AVAS_CTRL, COM_PDU_AVAS_CTRL_CH, LE, 0U, 8U, UNSIGNED, 1.0F, 0.0F)              \
+    X(COM_SIG_IPC_ILLM, COM_PDU_IPC_ILLM_CH, LE, 0U, 24U, UNSIGNED, 1.0F, 0.0F)
+
+/* Signals, index of st_gaComSignalConfig */
+#define COM_SIGNAL_ID(sig, pdu, order, start, len, sign, factor, offset)    sig,
+typedef enum
+{
+    COM_SIGNAL_LIST(COM_SIGNAL_ID)
+    COM_SIGNAL_NUM
+
+}EN_COM_SIGNAL_ID_t;
+#undef COM_SIGNAL_ID
+
+#endif
+
+/**************************************************************************************************/
+/* End of COM_Config.h                                                                            */
+/**************************************************************************************************/
@@ -0,0 +1,54 @@
+#ifndef _COM_PRIV_H_
+#define _COM_PRIV_H_
+
+/**************************************************************************************************/
+/* System Header Files Section                                                                    */
+/**************************************************************************************************/
+
+/**************************************************************************************************/
+/* User Header Files Section                                                                      */
+/**************************************************************************************************/
+
+/**************************************************************************************************/
+/* Private Global Definitions Section                                                             */
+/**************************************************************************************************/
+
+/* PDU buffer : largest payload and room for the 8 byte window of a signal in its last byte */
+#define COM_PDU_BUFFER_SIZE                 (CAN_IF_MAX_PAYLOAD + 8U)
+
+/* CAN IF PDU handle not bound to a COM PDU */
+#define COM_PDU_NONE                        (0xFFU)
+
+/* Runtime context of a PDU */
+typedef struct
+{
+    /* Entry of the CAN IF configuration table and its mailbox */
+    INT16U u16_mCanIfPdu;
+    INT8U u8_mMailBox;
+    /* Signals of the PDU in st_gaComSignalConfig */
+    INT8U u8_mFirstSignal;
+    INT8U u8_mSignalCount;
+    /* Receptions, odd while the signals are updated */
+    volatile INT32U u32_mCounter;
+    /* Last received or next transmitted payload */
+    INT8U u8_maData[COM_PDU_BUFFER_SIZE];
+
+}ST_COM_PDU_t;
+
+/**************************************************************************************************/
+/* Private Global Variables Section                                                               */
+/**************************************************************************************************/
+
+extern const ST_COM_PDU_CONFIG_t st_gaComPduConfig[COM_PDU_NUM];
+
+extern const ST_COM_SIGNAL_CONFIG_t st_gaComSignalConfig[COM_SIGNAL_NUM];
+
+/**************************************************************************************************/
+/* Private Functions Section                                                                      */
+/**************************************************************************************************/
+
+#endif
+
+/**************************************************************************************************/
+/* End of COM_Priv.h                                                                              */
+/**************************************************************************************************/
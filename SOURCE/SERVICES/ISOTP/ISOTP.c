@@ -0,0 +1,959 @@
+/**************************************************************************************************/
+/* System Header Files Section                                                                    */
+/**************************************************************************************************/
+#include <string.h>
+
+/**************************************************************************************************/
+/* User Header Files Section                                                                      */
+/**************************************************************************************************/
+#include "Includes.h"
+#include "./CAN_IF/CAN_IF.h"
+#include "ISOTP.h"
+#include "ISOTP_Config.h"
+#include "ISOTP_Priv.h"
+
+/**************************************************************************************************/
+/* Global Definitions Section                                                                     */
+/**************************************************************************************************/
+
+/* Largest single frame payload for a Tx / Rx CAN frame length */
+#define ISOTP_SF_DL_MAX(dl)                 (((dl) <= 8U) ? 7UL : (INT32U)((dl) - 2U))
+
+#if ((ISOTP_TX_RING_SIZE & (ISOTP_TX_RING_SIZE - 1U)) != 0U)
+#error "ISOTP_TX_RING_SIZE must be a power of two"
+#endif
+
+/**************************************************************************************************/
+/* Global Variables Section                                                                       */
+/**************************************************************************************************/
+
+/* CAN FD frame lengths, the frame of a PDU is padded to the first one holding it */
+static const INT8U u8_gaFrameLength[] = {8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U};
+
+/* Connection context */
+static ST_ISOTP_CONTEXT_t st_gIsoTp;
+
+/* ISOTP_Init() has been called */
+static BOOLEAN b_gIsoTpInit = 0U;
+
+static void ISOTP_TxConfirmation(INT16U u16_fMsgID);
+static void ISOTP_RxIndication(void * p_fRxData);
+
+/**************************************************************************************************/
+/* Function Name   : ISOTP_FrameLength                                                            */
+/*                                                                                                */
+/* Description     : CAN frame length carrying a PDU, see ISOTP_PADDING                           */
+/*                                                                                                */
+/* In Params       : INT8U u8_fUsed : PCI and payload bytes of the PDU                            */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT8U : Frame length in bytes                                                */
+/**************************************************************************************************/
+
+static INT8U ISOTP_FrameLength(INT8U u8_fUsed)
+{
+    INT8U u8_lLength = u8_fUsed;
+    INT32U u32_lIndex;
+
+    if(u8_fUsed <= 8U)
+    {
+#if (ISOTP_PADDING == 1U)
+        u8_lLength = 8U;
+#endif
+    }
+    else
+    {
+        for(u32_lIndex = 0U; u32_lIndex < sizeof(u8_gaFrameLength); u32_lIndex++)
+        {
+            if(u8_gaFrameLength[u32_lIndex] >= u8_fUsed)
+            {
+                u8_lLength = u8_gaFrameLength[u32_lIndex];
+                break;
+            }
+        }
+    }
+
+    return u8_lLength;
+}
+
+/**************************************************************************************************/
+/* Function Name   : ISOTP_BitsPerMs                                                              */
+/*                                                                                                */
+/* Description     : Converts the ms timings into the CAN IF timebase (bit times)                 */
+/*                                                                                                */
+/* In Params       : None                                                                         */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT32U : Nominal bits per ms, 0 while the channel is not initialized         */
+/**************************************************************************************************/
+
+static INT32U ISOTP_BitsPerMs(void)
+{
+    flexcan_bit_timing_t st_lTiming;
+    INT32U u32_lBitsPerMs = 0U;
+
+    if(CAN_IF_OK == CAN_IF_GetBitTiming(st_gIsoTp.st_mConfig.u8_mChannel, &st_lTiming))
+    {
+        u32_lBitsPerMs = st_lTiming.bitrate / 1000UL;
+    }
+
+    return u32_lBitsPerMs;
+}
+
+/**************************************************************************************************/
+/* Function Name   : ISOTP_StMinToBits                                                            */
+/*                                                                                                */
+/* Description     : Decodes the STmin of a flow control frame, reserved values are handled as    */
+/*                   the largest STmin                                                            */
+/*                                                                                                */
+/* In Params       : INT8U u8_fStMin : STmin byte                                                 */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT32U : STmin in bit times                                                  */
+/**************************************************************************************************/
+
+static INT32U ISOTP_StMinToBits(INT8U u8_fStMin)
+{
+    INT32U u32_lMicroSec;
+
+    if(u8_fStMin <= ISOTP_STMIN_MS_MAX)
+    {
+        u32_lMicroSec = (INT32U)u8_fStMin * 1000UL;
+    }
+    else if((u8_fStMin >= 0xF1U) && (u8_fStMin <= 0xF9U))
+    {
+        u32_lMicroSec = (INT32U)(u8_fStMin - 0xF0U) * 100UL;
+    }
+    else
+    {
+        u32_lMicroSec = ISOTP_STMIN_MS_MAX * 1000UL;
+    }
+
+    return (u32_lMicroSec * ISOTP_BitsPerMs()) / 1000UL;
+}
+
+/**************************************************************************************************/
+/* Function Name   : ISOTP_SendFrame                                                              */
+/*                                                                                                */
+/* Description     : Pads a PDU and queues it to CAN IF, the tag is handed back with the          */
+/*                   confirmation of the frame. Called with interrupts disabled.                  */
+/*                                                                                                */
+/* In Params       : INT8U * p_fFrame : Frame buffer (CAN_IF_MAX_PAYLOAD bytes), PDU at the start */
+/*                   INT8U u8_fUsed : PCI and payload bytes of the PDU                            */
+/*                   INT8U u8_fTag : ISOTP_TX_TAG_FC or number of the transfer                    */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_ISOTP_RESULT_t : ISOTP_ERROR if CAN IF or the Tx ring is full             */
+/**************************************************************************************************/
+
+static EN_ISOTP_RESULT_t ISOTP_SendFrame(INT8U * p_fFrame, INT8U u8_fUsed, INT8U u8_fTag)
+{
+    EN_ISOTP_RESULT_t en_lResult = ISOTP_OK;
+    INT8U u8_lLength = ISOTP_FrameLength(u8_fUsed);
+
+    memset((void *)&p_fFrame[u8_fUsed], ISOTP_PADDING_BYTE, (size_t)(u8_lLength - u8_fUsed));
+
+    if(st_gIsoTp.u8_mTxRingCount >= ISOTP_TX_RING_SIZE)
+    {
+        en_lResult = ISOTP_ERROR;
+    }
+    else if(CAN_IF_OK != CAN_IF_ISOTP_WriteMsg((INT32U)st_gIsoTp.st_mConfig.u16_mRespID, \
+                                                                        p_fFrame, u8_lLength))
+    {
+        en_lResult = ISOTP_ERROR;
+    }
+    else
+    {
+        st_gIsoTp.u8_maTxRing[(st_gIsoTp.u8_mTxRingHead + st_gIsoTp.u8_mTxRingCount) & \
+                                                        (ISOTP_TX_RING_SIZE - 1U)] = u8_fTag;
+        st_gIsoTp.u8_mTxRingCount++;
+    }
+
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : ISOTP_SendFlowControl                                                        */
+/*                                                                                                */
+/* Description     : Queues a flow control frame with our block size and STmin. Called with       */
+/*                   interrupts disabled.                                                         */
+/*                                                                                                */
+/* In Params       : INT8U u8_fFlowStatus : ISOTP_FS_CTS, ISOTP_FS_WAIT or ISOTP_FS_OVFLW         */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_ISOTP_RESULT_t : ISOTP_ERROR if the frame could not be queued             */
+/**************************************************************************************************/
+
+static EN_ISOTP_RESULT_t ISOTP_SendFlowControl(INT8U u8_fFlowStatus)
+{
+    INT8U u8_laFrame[CAN_IF_MAX_PAYLOAD];
+
+    u8_laFrame[0] = ISOTP_PCI_FC | u8_fFlowStatus;
+    u8_laFrame[1] = st_gIsoTp.st_mConfig.u8_mRxBs;
+    u8_laFrame[2] = st_gIsoTp.st_mConfig.u8_mRxStMin;
+
+    return ISOTP_SendFrame(&u8_laFrame[0], 3U, ISOTP_TX_TAG_FC);
+}
+
+/**************************************************************************************************/
+/* Function Name   : ISOTP_TxAbort                                                                */
+/*                                                                                                */
+/* Description     : Ends the transmission, the confirmation is given by ISOTP_MainFunction().    */
+/*                   Frames already queued to CAN IF are sent and their confirmation ignored.     */
+/*                                                                                                */
+/* In Params       : EN_ISOTP_N_RESULT_t en_fResult : Result of the transmission                  */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void ISOTP_TxAbort(EN_ISOTP_N_RESULT_t en_fResult)
+{
+    st_gIsoTp.en_mTxState = ISOTP_TX_IDLE;
+    st_gIsoTp.u8_mTxInFlight = 0U;
+    st_gIsoTp.en_mTxResult = en_fResult;
+    st_gIsoTp.b_mTxConfPending = 1U;
+}
+
+/**************************************************************************************************/
+/* Function Name   : ISOTP_TxFill                                                                 */
+/*                                                                                                */
+/* Description     : Queues the consecutive frames the flow control allows : up to                */
+/*                   ISOTP_TX_PIPELINE ahead of their confirmation for STmin 0, otherwise one     */
+/*                   frame once STmin has elapsed since the last confirmation. Called with        */
+/*                   interrupts disabled.                                                         */
+/*                                                                                                */
+/* In Params       : INT32U u32_fNow : Current time in bit times                                  */
+/*                   BOOLEAN b_fNoWait : 1 for the first frame of a block, sent without STmin     */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void ISOTP_TxFill(INT32U u32_fNow, BOOLEAN b_fNoWait)
+{
+    INT8U u8_laFrame[CAN_IF_MAX_PAYLOAD];
+    INT32U u32_lSize;
+
+    while((ISOTP_TX_SENDING == st_gIsoTp.en_mTxState) && \
+          (st_gIsoTp.u32_mTxOffset < st_gIsoTp.u32_mTxLength) && \
+          ((0U != st_gIsoTp.b_mTxBsUnlimited) || (st_gIsoTp.u8_mTxBsLeft > 0U)))
+    {
+        if(0U == st_gIsoTp.u32_mTxStMin)
+        {
+            if(st_gIsoTp.u8_mTxInFlight >= ISOTP_TX_PIPELINE)
+            {
+                break;
+            }
+        }
+        else if((st_gIsoTp.u8_mTxInFlight > 0U) || \
+                ((0U == b_fNoWait) && \
+                 ((INT32U)(u32_fNow - st_gIsoTp.u32_mTxTimer) < st_gIsoTp.u32_mTxStMin)))
+        {
+            break;
+        }
+        else
+        {
+            /* No Action */
+        }
+
+        u32_lSize = st_gIsoTp.u32_mTxLength - st_gIsoTp.u32_mTxOffset;
+        if(u32_lSize > (INT32U)(st_gIsoTp.st_mConfig.u8_mTxDl - 1U))
+        {
+            u32_lSize = (INT32U)(st_gIsoTp.st_mConfig.u8_mTxDl - 1U);
+        }
+
+        u8_laFrame[0] = ISOTP_PCI_CF | st_gIsoTp.u8_mTxSN;
+        memcpy((void *)&u8_laFrame[1], \
+               (const void *)&st_gIsoTp.p_mTxData[st_gIsoTp.u32_mTxOffset], (size_t)u32_lSize);
+
+        /* CAN IF full, retried from ISOTP_MainFunction() */
+        if(ISOTP_OK != ISOTP_SendFrame(&u8_laFrame[0], (INT8U)(u32_lSize + 1U), \
+                                                                        st_gIsoTp.u8_mTxTag))
+        {
+            break;
+        }
+
+        if(0U == st_gIsoTp.u8_mTxInFlight)
+        {
+            st_gIsoTp.u32_mTxTimer = u32_fNow;
+        }
+        st_gIsoTp.u8_mTxInFlight++;
+        st_gIsoTp.u32_mTxOffset += u32_lSize;
+        st_gIsoTp.u8_mTxSN = (st_gIsoTp.u8_mTxSN + 1U) & 0x0FU;
+        if(0U == st_gIsoTp.b_mTxBsUnlimited)
+        {
+            st_gIsoTp.u8_mTxBsLeft--;
+        }
+        b_fNoWait = 0U;
+    }
+}
+
+/**************************************************************************************************/
+/* Function Name   : ISOTP_TxConfirmation                                                         */
+/*                                                                                                */
+/* Description     : CAN IF confirmation of a frame sent on the response ID, called from the      */
+/*                   FlexCAN ISR. Refills the Tx pipeline, ends the transmission after its last   */
+/*                   frame or waits for the flow control at the end of a block.                   */
+/*                                                                                                */
+/* In Params       : INT16U u16_fMsgID : Transmitted Message ID                                   */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void ISOTP_TxConfirmation(INT16U u16_fMsgID)
+{
+    INT8U u8_lTag;
+    INT32U u32_lNow;
+
+    (void)u16_fMsgID;
+
+    INT_SYS_DisableIRQGlobal();
+
+    /* CAN IF sends the frames of one ID in queueing order */
+    if(st_gIsoTp.u8_mTxRingCount > 0U)
+    {
+        u8_lTag = st_gIsoTp.u8_maTxRing[st_gIsoTp.u8_mTxRingHead];
+        st_gIsoTp.u8_mTxRingHead = (st_gIsoTp.u8_mTxRingHead + 1U) & (ISOTP_TX_RING_SIZE - 1U);
+        st_gIsoTp.u8_mTxRingCount--;
+
+        if((ISOTP_TX_TAG_FC != u8_lTag) && (u8_lTag == st_gIsoTp.u8_mTxTag) && \
+           (ISOTP_TX_IDLE != st_gIsoTp.en_mTxState) && (st_gIsoTp.u8_mTxInFlight > 0U))
+        {
+            u32_lNow = CAN_IF_GetTxTimeStamp(st_gIsoTp.st_mConfig.u8_mChannel);
+            st_gIsoTp.u8_mTxInFlight--;
+            st_gIsoTp.u32_mTxTimer = u32_lNow;
+
+            if(0U != st_gIsoTp.u8_mTxInFlight)
+            {
+                /* No Action */
+            }
+            else if(st_gIsoTp.u32_mTxOffset >= st_gIsoTp.u32_mTxLength)
+            {
+                st_gIsoTp.en_mTxState = ISOTP_TX_IDLE;
+                st_gIsoTp.en_mTxResult = ISOTP_N_OK;
+                st_gIsoTp.b_mTxConfPending = 1U;
+            }
+            else if((0U == st_gIsoTp.b_mTxBsUnlimited) && (0U == st_gIsoTp.u8_mTxBsLeft))
+            {
+                /* First frame or last frame of the block sent, N_Bs starts */
+                st_gIsoTp.en_mTxState = ISOTP_TX_WAIT_FC;
+            }
+            else
+            {
+                /* No Action */
+            }
+
+            if(0U == st_gIsoTp.u32_mTxStMin)
+            {
+                ISOTP_TxFill(u32_lNow, 0U);
+            }
+        }
+    }
+
+    INT_SYS_EnableIRQGlobal();
+}
+
+/**************************************************************************************************/
+/* Function Name   : ISOTP_RxFlowControl                                                          */
+/*                                                                                                */
+/* Description     : Flow control frame of the receiver of our transmission. Called with          */
+/*                   interrupts disabled.                                                         */
+/*                                                                                                */
+/* In Params       : const ST_RX_PDU_t * p_stfPdu : Received frame                                */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void ISOTP_RxFlowControl(const ST_RX_PDU_t * p_stfPdu)
+{
+    const INT8U * p_lData = p_stfPdu->p_mDataBuff;
+
+    /* The flow control may overtake the confirmation of the last frames of the block */
+    if(((ISOTP_TX_WAIT_FC != st_gIsoTp.en_mTxState) && \
+        ((ISOTP_TX_SENDING != st_gIsoTp.en_mTxState) || (0U != st_gIsoTp.b_mTxBsUnlimited) || \
+         (0U != st_gIsoTp.u8_mTxBsLeft))) || (p_stfPdu->u8_mDataSize < 3U))
+    {
+        /* No Action */
+    }
+    else if(ISOTP_FS_CTS == (p_lData[0] & 0x0FU))
+    {
+        st_gIsoTp.u8_mTxBsLeft = p_lData[1];
+        st_gIsoTp.b_mTxBsUnlimited = (0U == p_lData[1]) ? 1U : 0U;
+        st_gIsoTp.u32_mTxStMin = ISOTP_StMinToBits(p_lData[2]);
+        st_gIsoTp.u8_mTxWaitCount = 0U;
+        st_gIsoTp.u32_mTxTimer = p_stfPdu->u32_mTimeStamp;
+        st_gIsoTp.en_mTxState = ISOTP_TX_SENDING;
+        ISOTP_TxFill(p_stfPdu->u32_mTimeStamp, 1U);
+    }
+    else if(ISOTP_FS_WAIT == (p_lData[0] & 0x0FU))
+    {
+        st_gIsoTp.u8_mTxWaitCount++;
+        if(st_gIsoTp.u8_mTxWaitCount > ISOTP_WFT_MAX)
+        {
+            ISOTP_TxAbort(ISOTP_N_WFT_OVRN);
+        }
+        else
+        {
+            /* N_Bs restarts */
+            st_gIsoTp.u32_mTxTimer = p_stfPdu->u32_mTimeStamp;
+        }
+    }
+    else if(ISOTP_FS_OVFLW == (p_lData[0] & 0x0FU))
+    {
+        ISOTP_TxAbort(ISOTP_N_BUFFER_OVFLW);
+    }
+    else
+    {
+        ISOTP_TxAbort(ISOTP_N_INVALID_FS);
+    }
+}
+
+/**************************************************************************************************/
+/* Function Name   : ISOTP_RxStop                                                                 */
+/*                                                                                                */
+/* Description     : Ends the reception in progress, the indication is made by the caller once    */
+/*                   interrupts are enabled again. Called with interrupts disabled.               */
+/*                                                                                                */
+/* In Params       : EN_ISOTP_N_RESULT_t en_fResult : Result of the reception                     */
+/*                                                                                                */
+/* Out Params      : ST_ISOTP_INDICATION_t * p_stfInd : Indication to make                        */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void ISOTP_RxStop(EN_ISOTP_N_RESULT_t en_fResult, ST_ISOTP_INDICATION_t * p_stfInd)
+{
+    p_stfInd->b_mPending = 1U;
+    p_stfInd->p_mData = st_gIsoTp.p_mRxData;
+    p_stfInd->u32_mLength = (ISOTP_N_OK == en_fResult) ? st_gIsoTp.u32_mRxLength : \
+                                                                        st_gIsoTp.u32_mRxOffset;
+    p_stfInd->en_mResult = en_fResult;
+    st_gIsoTp.en_mRxState = ISOTP_RX_IDLE;
+}
+
+/**************************************************************************************************/
+/* Function Name   : ISOTP_RxConsecutive                                                          */
+/*                                                                                                */
+/* Description     : Copies a consecutive frame into the buffer of the message and sends the      */
+/*                   flow control of the next block. Called with interrupts disabled.             */
+/*                                                                                                */
+/* In Params       : const ST_RX_PDU_t * p_stfPdu : Received frame                                */
+/*                                                                                                */
+/* Out Params      : ST_ISOTP_INDICATION_t * p_stfInd : Indication to make                        */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void ISOTP_RxConsecutive(const ST_RX_PDU_t * p_stfPdu, ST_ISOTP_INDICATION_t * p_stfInd)
+{
+    INT32U u32_lSize;
+
+    if((ISOTP_RX_WAIT_CF != st_gIsoTp.en_mRxState) || (p_stfPdu->u8_mDataSize < 2U))
+    {
+        /* No Action */
+    }
+    else if((p_stfPdu->p_mDataBuff[0] & 0x0FU) != st_gIsoTp.u8_mRxSN)
+    {
+        ISOTP_RxStop(ISOTP_N_WRONG_SN, p_stfInd);
+    }
+    else
+    {
+        u32_lSize = st_gIsoTp.u32_mRxLength - st_gIsoTp.u32_mRxOffset;
+        if(u32_lSize > (INT32U)(p_stfPdu->u8_mDataSize - 1U))
+        {
+            u32_lSize = (INT32U)(p_stfPdu->u8_mDataSize - 1U);
+        }
+        memcpy((void *)&st_gIsoTp.p_mRxData[st_gIsoTp.u32_mRxOffset], \
+                                        (const void *)&p_stfPdu->p_mDataBuff[1], (size_t)u32_lSize);
+        st_gIsoTp.u32_mRxOffset += u32_lSize;
+        st_gIsoTp.u8_mRxSN = (st_gIsoTp.u8_mRxSN + 1U) & 0x0FU;
+        st_gIsoTp.u32_mRxTimer = p_stfPdu->u32_mTimeStamp;
+
+        if(st_gIsoTp.u32_mRxOffset >= st_gIsoTp.u32_mRxLength)
+        {
+            ISOTP_RxStop(ISOTP_N_OK, p_stfInd);
+        }
+        else if(0U == st_gIsoTp.st_mConfig.u8_mRxBs)
+        {
+            /* No Action */
+        }
+        else if(0U != --st_gIsoTp.u8_mRxBsLeft)
+        {
+            /* No Action */
+        }
+        else if(ISOTP_OK != ISOTP_SendFlowControl(ISOTP_FS_CTS))
+        {
+            ISOTP_RxStop(ISOTP_N_ERROR, p_stfInd);
+        }
+        else
+        {
+            st_gIsoTp.u8_mRxBsLeft = st_gIsoTp.st_mConfig.u8_mRxBs;
+        }
+    }
+}
+
+/**************************************************************************************************/
+/* Function Name   : ISOTP_Indicate                                                               */
+/*                                                                                                */
+/* Description     : Reports a finished reception to the upper layer                              */
+/*                                                                                                */
+/* In Params       : const ST_ISOTP_INDICATION_t * p_stfInd : Indication to make                  */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void ISOTP_Indicate(const ST_ISOTP_INDICATION_t * p_stfInd)
+{
+    if(0U != p_stfInd->b_mPending)
+    {
+        st_gIsoTp.st_mConfig.fp_mRxIndication(p_stfInd->p_mData, p_stfInd->u32_mLength, \
+                                                                            p_stfInd->en_mResult);
+    }
+}
+
+/**************************************************************************************************/
+/* Function Name   : ISOTP_RxFrame                                                                */
+/*                                                                                                */
+/* Description     : Handles a frame of the request ID. A single or first frame interrupts a      */
+/*                   reception in progress with ISOTP_N_UNEXP_PDU. The upper layer is called      */
+/*                   outside the critical section.                                                */
+/*                                                                                                */
+/* In Params       : const ST_RX_PDU_t * p_stfPdu : Received frame, at least one byte             */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void ISOTP_RxFrame(const ST_RX_PDU_t * p_stlPdu)
+{
+    const INT8U * p_lData = p_stlPdu->p_mDataBuff;
+    ST_ISOTP_INDICATION_t st_lAbort = {0U, PNULL, 0U, ISOTP_N_OK};
+    ST_ISOTP_INDICATION_t st_lDone = {0U, PNULL, 0U, ISOTP_N_OK};
+    INT32U u32_lLength = 0U;
+    INT32U u32_lOffset = 0U;
+    INT8U * p_lBuffer;
+
+    /* Length and payload offset of a single or first frame, 0 : invalid frame */
+    if(ISOTP_PCI_SF == (p_lData[0] & ISOTP_PCI_TYPE_MASK))
+    {
+        if(p_stlPdu->u8_mDataSize <= 8U)
+        {
+            u32_lLength = p_lData[0] & 0x0FU;
+            u32_lOffset = 1U;
+        }
+        else if(0U == p_lData[0])
+        {
+            u32_lLength = p_lData[1];
+            u32_lOffset = 2U;
+        }
+        else
+        {
+            /* No Action */
+        }
+
+        if(u32_lLength > (p_stlPdu->u8_mDataSize - u32_lOffset))
+        {
+            u32_lLength = 0U;
+        }
+    }
+    else if((ISOTP_PCI_FF == (p_lData[0] & ISOTP_PCI_TYPE_MASK)) && \
+            (p_stlPdu->u8_mDataSize >= 8U))
+    {
+        u32_lLength = ((INT32U)(p_lData[0] & 0x0FU) << 8) | p_lData[1];
+        u32_lOffset = 2U;
+        if(0U == u32_lLength)
+        {
+            u32_lLength = ((INT32U)p_lData[2] << 24) | ((INT32U)p_lData[3] << 16) | \
+                                                    ((INT32U)p_lData[4] << 8) | p_lData[5];
+            u32_lOffset = 6U;
+            if(u32_lLength <= ISOTP_FF_DL_12BIT_MAX)
+            {
+                u32_lLength = 0U;
+            }
+        }
+
+        /* A message fitting a single frame is not segmented */
+        if(u32_lLength <= ISOTP_SF_DL_MAX(p_stlPdu->u8_mDataSize))
+        {
+            u32_lLength = 0U;
+        }
+    }
+    else
+    {
+        /* No Action */
+    }
+
+    INT_SYS_DisableIRQGlobal();
+
+    switch(p_lData[0] & ISOTP_PCI_TYPE_MASK)
+    {
+        case ISOTP_PCI_SF:
+        case ISOTP_PCI_FF:
+            if((0U == u32_lLength) || (ISOTP_RX_ALLOC == st_gIsoTp.en_mRxState))
+            {
+                u32_lLength = 0U;
+            }
+            else if(ISOTP_RX_WAIT_CF == st_gIsoTp.en_mRxState)
+            {
+                ISOTP_RxStop(ISOTP_N_UNEXP_PDU, &st_lAbort);
+            }
+            else
+            {
+                /* No Action */
+            }
+
+            if((0U != u32_lLength) && (ISOTP_PCI_FF == (p_lData[0] & ISOTP_PCI_TYPE_MASK)))
+            {
+                /* Further single / first frames are ignored until the buffer is known */
+                st_gIsoTp.en_mRxState = ISOTP_RX_ALLOC;
+            }
+            break;
+
+        case ISOTP_PCI_CF:
+            ISOTP_RxConsecutive(p_stlPdu, &st_lDone);
+            break;
+
+        case ISOTP_PCI_FC:
+            ISOTP_RxFlowControl(p_stlPdu);
+            break;
+
+        default:
+            break;
+    }
+
+    INT_SYS_EnableIRQGlobal();
+
+    ISOTP_Indicate(&st_lAbort);
+    ISOTP_Indicate(&st_lDone);
+
+    if(0U == u32_lLength)
+    {
+        /* No Action */
+    }
+    else if(ISOTP_PCI_SF == (p_lData[0] & ISOTP_PCI_TYPE_MASK))
+    {
+        p_lBuffer = st_gIsoTp.st_mConfig.fp_mGetRxBuffer(u32_lLength);
+        if(PNULL != p_lBuffer)
+        {
+            memcpy((void *)p_lBuffer, (const void *)&p_lData[u32_lOffset], (size_t)u32_lLength);
+            st_gIsoTp.st_mConfig.fp_mRxIndication(p_lBuffer, u32_lLength, ISOTP_N_OK);
+        }
+    }
+    else
+    {
+        p_lBuffer = st_gIsoTp.st_mConfig.fp_mGetRxBuffer(u32_lLength);
+
+        INT_SYS_DisableIRQGlobal();
+
+        if(ISOTP_RX_ALLOC != st_gIsoTp.en_mRxState)
+        {
+            /* No Action */
+        }
+        else if(PNULL == p_lBuffer)
+        {
+            (void)ISOTP_SendFlowControl(ISOTP_FS_OVFLW);
+            st_gIsoTp.en_mRxState = ISOTP_RX_IDLE;
+        }
+        else
+        {
+            st_gIsoTp.p_mRxData = p_lBuffer;
+            st_gIsoTp.u32_mRxLength = u32_lLength;
+            st_gIsoTp.u32_mRxOffset = (INT32U)p_stlPdu->u8_mDataSize - u32_lOffset;
+            memcpy((void *)p_lBuffer, (const void *)&p_lData[u32_lOffset], \
+                                                            (size_t)st_gIsoTp.u32_mRxOffset);
+            st_gIsoTp.u8_mRxSN = 1U;
+            st_gIsoTp.u8_mRxBsLeft = st_gIsoTp.st_mConfig.u8_mRxBs;
+            st_gIsoTp.u32_mRxTimer = p_stlPdu->u32_mTimeStamp;
+            st_gIsoTp.en_mRxState = ISOTP_RX_WAIT_CF;
+
+            if(ISOTP_OK != ISOTP_SendFlowControl(ISOTP_FS_CTS))
+            {
+                ISOTP_RxStop(ISOTP_N_ERROR, &st_lDone);
+            }
+        }
+
+        INT_SYS_EnableIRQGlobal();
+
+        ISOTP_Indicate(&st_lDone);
+    }
+}
+
+/**************************************************************************************************/
+/* Function Name   : ISOTP_RxIndication                                                           */
+/*                                                                                                */
+/* Description     : Frame received on the request ID, called by CAN IF in the context it         */
+/*                   delivers frames in (CAN_IF_MainFunction() with CAN_IF_RX_DEFERRED)           */
+/*                                                                                                */
+/* In Params       : void * p_fRxData : Received frame, ST_RX_PDU_t                               */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void ISOTP_RxIndication(void * p_fRxData)
+{
+    const ST_RX_PDU_t * p_stlPdu = (const ST_RX_PDU_t *)p_fRxData;
+
+    if((0U != b_gIsoTpInit) && (PNULL != p_stlPdu) && (0U != p_stlPdu->u8_mDataSize))
+    {
+        ISOTP_RxFrame(p_stlPdu);
+    }
+}
+
+/**************************************************************************************************/
+/* Function Name   : ISOTP_Init                                                                   */
+/*                                                                                                */
+/* Description     : Initializes the connection and registers its frame handlers and IDs with     */
+/*                   CAN IF. To be called before CAN_IF_Init(), which compiles the request ID     */
+/*                   into the acceptance filters of the channel.                                  */
+/*                                                                                                */
+/* In Params       : const ST_ISOTP_INIT_t * p_stfInit : Connection parameters and callbacks      */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_ISOTP_RESULT_t : ISOTP_ERROR on an invalid parameter or if CAN IF         */
+/*                   refuses the IDs                                                              */
+/**************************************************************************************************/
+
+EN_ISOTP_RESULT_t ISOTP_Init(const ST_ISOTP_INIT_t * p_stfInit)
+{
+    EN_ISOTP_RESULT_t en_lResult = ISOTP_ERROR;
+    ST_ISOTP_CONFIG_PARAMS_t st_lCanIfParams;
+    INT32U u32_lIndex;
+
+    if((PNULL == p_stfInit) || (PNULL == p_stfInit->fp_mGetRxBuffer) || \
+       (PNULL == p_stfInit->fp_mRxIndication) || (PNULL == p_stfInit->fp_mTxConfirmation))
+    {
+        /* No Action */
+    }
+    else
+    {
+        for(u32_lIndex = 0U; u32_lIndex < sizeof(u8_gaFrameLength); u32_lIndex++)
+        {
+            if(p_stfInit->u8_mTxDl == u8_gaFrameLength[u32_lIndex])
+            {
+                en_lResult = ISOTP_OK;
+            }
+        }
+    }
+
+    if(ISOTP_OK == en_lResult)
+    {
+        st_lCanIfParams.fp_mIsoTpTxHandler = &ISOTP_TxConfirmation;
+        st_lCanIfParams.fp_mIsoTpRxHandler = &ISOTP_RxIndication;
+        st_lCanIfParams.u16_mIsoTpReqID = p_stfInit->u16_mReqID;
+        st_lCanIfParams.u16_mIsoTpRespID = p_stfInit->u16_mRespID;
+        st_lCanIfParams.u8_mIsoTpChannel = p_stfInit->u8_mChannel;
+
+        INT_SYS_DisableIRQGlobal();
+        memset((void *)&st_gIsoTp, 0, sizeof(st_gIsoTp));
+        st_gIsoTp.st_mConfig = *p_stfInit;
+        st_gIsoTp.u8_mTxTag = 1U;
+        INT_SYS_EnableIRQGlobal();
+
+        if(CAN_IF_OK != CAN_IF_InitIsoTp(&st_lCanIfParams))
+        {
+            en_lResult = ISOTP_ERROR;
+        }
+    }
+
+    b_gIsoTpInit = (ISOTP_OK == en_lResult) ? 1U : 0U;
+
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : ISOTP_Transmit                                                               */
+/*                                                                                                */
+/* Description     : Starts sending a message as a single frame or as a first frame followed by   */
+/*                   consecutive frames, FF_DL above 4095 bytes uses the 32 bit escape. The       */
+/*                   frames are built from p_fData as they are queued, the buffer must not        */
+/*                   change until the confirmation.                                               */
+/*                                                                                                */
+/* In Params       : const INT8U * p_fData : Message                                              */
+/*                   INT32U u32_fLength : Message length in bytes                                 */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_ISOTP_RESULT_t : ISOTP_ERROR if a transmission is in progress or its      */
+/*                   confirmation is not given yet, or the first frame could not be queued        */
+/**************************************************************************************************/
+
+EN_ISOTP_RESULT_t ISOTP_Transmit(const INT8U * p_fData, INT32U u32_fLength)
+{
+    EN_ISOTP_RESULT_t en_lResult = ISOTP_OK;
+    INT8U u8_laFrame[CAN_IF_MAX_PAYLOAD];
+    INT8U u8_lTxDl;
+    INT32U u32_lOffset;
+    INT32U u32_lSize;
+
+    u8_lTxDl = st_gIsoTp.st_mConfig.u8_mTxDl;
+
+    INT_SYS_DisableIRQGlobal();
+
+    if((0U == b_gIsoTpInit) || (PNULL == p_fData) || (0U == u32_fLength) || \
+       (ISOTP_TX_IDLE != st_gIsoTp.en_mTxState) || (0U != st_gIsoTp.b_mTxConfPending))
+    {
+        en_lResult = ISOTP_ERROR;
+    }
+    else
+    {
+        if(u32_fLength <= 7U)
+        {
+            u8_laFrame[0] = ISOTP_PCI_SF | (INT8U)u32_fLength;
+            u32_lOffset = 1U;
+            u32_lSize = u32_fLength;
+        }
+        else if(u32_fLength <= ISOTP_SF_DL_MAX(u8_lTxDl))
+        {
+            /* CAN FD single frame, SF_DL in the second byte */
+            u8_laFrame[0] = ISOTP_PCI_SF;
+            u8_laFrame[1] = (INT8U)u32_fLength;
+            u32_lOffset = 2U;
+            u32_lSize = u32_fLength;
+        }
+        else if(u32_fLength <= ISOTP_FF_DL_12BIT_MAX)
+        {
+            u8_laFrame[0] = ISOTP_PCI_FF | (INT8U)(u32_fLength >> 8);
+            u8_laFrame[1] = (INT8U)u32_fLength;
+            u32_lOffset = 2U;
+            u32_lSize = (INT32U)u8_lTxDl - 2U;
+        }
+        else
+        {
+            u8_laFrame[0] = ISOTP_PCI_FF;
+            u8_laFrame[1] = 0U;
+            u8_laFrame[2] = (INT8U)(u32_fLength >> 24);
+            u8_laFrame[3] = (INT8U)(u32_fLength >> 16);
+            u8_laFrame[4] = (INT8U)(u32_fLength >> 8);
+            u8_laFrame[5] = (INT8U)u32_fLength;
+            u32_lOffset = 6U;
+            u32_lSize = (INT32U)u8_lTxDl - 6U;
+        }
+        memcpy((void *)&u8_laFrame[u32_lOffset], (const void *)p_fData, (size_t)u32_lSize);
+
+        /* Frames of an aborted transfer still queued in CAN IF keep their old tag */
+        st_gIsoTp.u8_mTxTag++;
+        if(ISOTP_TX_TAG_FC == st_gIsoTp.u8_mTxTag)
+        {
+            st_gIsoTp.u8_mTxTag++;
+        }
+
+        if(ISOTP_OK != ISOTP_SendFrame(&u8_laFrame[0], (INT8U)(u32_lOffset + u32_lSize), \
+                                                                        st_gIsoTp.u8_mTxTag))
+        {
+            en_lResult = ISOTP_ERROR;
+        }
+        else
+        {
+            st_gIsoTp.p_mTxData = p_fData;
+            st_gIsoTp.u32_mTxLength = u32_fLength;
+            st_gIsoTp.u32_mTxOffset = u32_lSize;
+            st_gIsoTp.u8_mTxSN = 1U;
+            st_gIsoTp.u8_mTxInFlight = 1U;
+            /* The first frame is followed by a flow control */
+            st_gIsoTp.u8_mTxBsLeft = 0U;
+            st_gIsoTp.b_mTxBsUnlimited = 0U;
+            st_gIsoTp.u8_mTxWaitCount = 0U;
+            st_gIsoTp.u32_mTxStMin = 0U;
+            st_gIsoTp.u32_mTxTimer = CAN_IF_GetTimeStamp(st_gIsoTp.st_mConfig.u8_mChannel);
+            st_gIsoTp.en_mTxState = ISOTP_TX_SENDING;
+        }
+    }
+
+    INT_SYS_EnableIRQGlobal();
+
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : ISOTP_MainFunction                                                           */
+/*                                                                                                */
+/* Description     : Supervises N_As, N_Bs and N_Cr, sends the consecutive frames paced by STmin  */
+/*                   and gives the Tx confirmation. STmin below the call period is rounded up to  */
+/*                   it.                                                                          */
+/*                                                                                                */
+/* In Params       : None                                                                         */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+void ISOTP_MainFunction(void)
+{
+    ST_ISOTP_INDICATION_t st_lDone = {0U, PNULL, 0U, ISOTP_N_OK};
+    BOOLEAN b_lTxConf = 0U;
+    EN_ISOTP_N_RESULT_t en_lTxResult = ISOTP_N_OK;
+    INT32U u32_lBitsPerMs;
+    INT32U u32_lNow;
+
+    /* Timers run once CAN IF has initialized the channel */
+    u32_lBitsPerMs = (0U != b_gIsoTpInit) ? ISOTP_BitsPerMs() : 0U;
+
+    INT_SYS_DisableIRQGlobal();
+
+    u32_lNow = CAN_IF_GetTimeStamp(st_gIsoTp.st_mConfig.u8_mChannel);
+
+    if(0U == u32_lBitsPerMs)
+    {
+        /* No Action */
+    }
+    else if((ISOTP_TX_SENDING == st_gIsoTp.en_mTxState) && \
+            ((INT32U)(u32_lNow - st_gIsoTp.u32_mTxTimer) > (ISOTP_N_AS_MS * u32_lBitsPerMs)))
+    {
+        ISOTP_TxAbort(ISOTP_N_TIMEOUT_A);
+    }
+    else if((ISOTP_TX_WAIT_FC == st_gIsoTp.en_mTxState) && \
+            ((INT32U)(u32_lNow - st_gIsoTp.u32_mTxTimer) > (ISOTP_N_BS_MS * u32_lBitsPerMs)))
+    {
+        ISOTP_TxAbort(ISOTP_N_TIMEOUT_BS);
+    }
+    else
+    {
+        /* Frames paced by STmin or refused by a full CAN IF queue */
+        ISOTP_TxFill(u32_lNow, 0U);
+    }
+
+    if((0U != u32_lBitsPerMs) && (ISOTP_RX_WAIT_CF == st_gIsoTp.en_mRxState) && \
+       ((INT32U)(u32_lNow - st_gIsoTp.u32_mRxTimer) > (ISOTP_N_CR_MS * u32_lBitsPerMs)))
+    {
+        ISOTP_RxStop(ISOTP_N_TIMEOUT_CR, &st_lDone);
+    }
+
+    if(0U != st_gIsoTp.b_mTxConfPending)
+    {
+        st_gIsoTp.b_mTxConfPending = 0U;
+        b_lTxConf = 1U;
+        en_lTxResult = st_gIsoTp.en_mTxResult;
+    }
+
+    INT_SYS_EnableIRQGlobal();
+
+    ISOTP_Indicate(&st_lDone);
+
+    if(0U != b_lTxConf)
+    {
+        st_gIsoTp.st_mConfig.fp_mTxConfirmation(en_lTxResult);
+    }
+}
+
+/**************************************************************************************************/
+/* End of ISOTP.c                                                                                 */
+/**************************************************************************************************/
@@ -0,0 +1,95 @@
+
+#ifndef _ISOTP_H_
+#define _ISOTP_H_
+
+/**************************************************************************************************/
+/* System Header Files Section                                                                    */
+/**************************************************************************************************/
+#include "Includes.h"
+
+/**************************************************************************************************/
+/* User Header Files Section                                                                      */
+/**************************************************************************************************/
+
+/**************************************************************************************************/
+/* Export Global Definitions Section                                                              */
+/**************************************************************************************************/
+
+/* Largest message of the 12 bit FF_DL, longer messages use the 32 bit FF_DL escape */
+#define ISOTP_FF_DL_12BIT_MAX                         (4095UL)
+
+typedef enum
+{
+    ISOTP_OK = 0x00,
+    ISOTP_ERROR
+
+}EN_ISOTP_RESULT_t;
+
+/* N_Result of a transfer, ISO 15765-2 */
+typedef enum
+{
+    ISOTP_N_OK = 0x00,
+    /* N_As / N_Ar : a frame was not transmitted in time */
+    ISOTP_N_TIMEOUT_A,
+    /* N_Bs : no flow control frame in time */
+    ISOTP_N_TIMEOUT_BS,
+    /* N_Cr : no consecutive frame in time */
+    ISOTP_N_TIMEOUT_CR,
+    /* Unexpected consecutive frame sequence number */
+    ISOTP_N_WRONG_SN,
+    /* Invalid flow status in a flow control frame */
+    ISOTP_N_INVALID_FS,
+    /* Reception interrupted by a new single or first frame */
+    ISOTP_N_UNEXP_PDU,
+    /* More than ISOTP_WFT_MAX flow control WAIT frames */
+    ISOTP_N_WFT_OVRN,
+    /* The receiver has no buffer for the message */
+    ISOTP_N_BUFFER_OVFLW,
+    /* Frame could not be queued to CAN IF */
+    ISOTP_N_ERROR
+
+}EN_ISOTP_N_RESULT_t;
+
+typedef struct
+{
+    /* CAN IF channel and IDs of the connection (normal addressing, standard IDs) */
+    INT8U u8_mChannel;
+    INT16U u16_mReqID;
+    INT16U u16_mRespID;
+    /* Tx CAN frame length : 8 for classic CAN, 12 .. 64 sends CAN FD frames */
+    INT8U u8_mTxDl;
+    /* Block size and STmin sent in our flow control frames */
+    INT8U u8_mRxBs;
+    INT8U u8_mRxStMin;
+    /* Buffer for an incoming message of u32_fLength bytes, PNULL rejects the message. The      */
+    /* payload is reassembled in place, the buffer belongs to ISO TP until the indication      */
+    INT8U * (* fp_mGetRxBuffer)(INT32U u32_fLength);
+    /* End of a reception, u32_fLength is the number of bytes received so far on an error */
+    void (* fp_mRxIndication)(INT8U * p_fData, INT32U u32_fLength, EN_ISOTP_N_RESULT_t en_fResult);
+    /* End of the transmission started by ISOTP_Transmit() */
+    void (* fp_mTxConfirmation)(EN_ISOTP_N_RESULT_t en_fResult);
+
+}ST_ISOTP_INIT_t;
+
+/**************************************************************************************************/
+/* Export Global Variable Section                                                                 */
+/**************************************************************************************************/
+
+/**************************************************************************************************/
+/* Export Functions Section                                                                       */
+/**************************************************************************************************/
+
+/* Registers the transport layer with CAN IF, to be called before CAN_IF_Init() */
+extern EN_ISOTP_RESULT_t ISOTP_Init(const ST_ISOTP_INIT_t * p_stfInit);
+
+/* Starts sending a message, p_fData is not copied and must stay valid until the confirmation */
+extern EN_ISOTP_RESULT_t ISOTP_Transmit(const INT8U * p_fData, INT32U u32_fLength);
+
+/* Timeouts, STmin pacing and the Tx confirmation, to be called cyclically (1 ms) */
+extern void ISOTP_MainFunction(void);
+
+#endif
+
+/**************************************************************************************************/
+/* End of ISOTP.h                                                                                 */
+/**************************************************************************************************/
@@ -0,0 +1,27 @@
+
+#ifndef _ISOTP_CONFIG_H_
+#define _ISOTP_CONFIG_H_
+
+/* Network layer timeouts in ms : N_As (frame transmission), N_Bs (flow control reception) */
+/* and N_Cr (consecutive frame reception)                                                 */
+#define ISOTP_N_AS_MS                       (1000UL)
+#define ISOTP_N_BS_MS                       (1000UL)
+#define ISOTP_N_CR_MS                       (1000UL)
+
+/* Maximum number of consecutive flow control WAIT frames accepted by the sender */
+#define ISOTP_WFT_MAX                       (8U)
+
+/* Consecutive frames queued to CAN IF ahead of their confirmation when the receiver asks */
+/* for STmin 0, keeps the Tx mailboxes of the channel busy back to back                    */
+#define ISOTP_TX_PIPELINE                   (4U)
+
+/* 1 : frames are padded to the full CAN frame (8 bytes or the next CAN FD length) */
+/* 0 : classic frames carry only the used bytes                                     */
+#define ISOTP_PADDING                       (1U)
+#define ISOTP_PADDING_BYTE                  (0xCCU)
+
+#endif
+
+/**************************************************************************************************/
+/* End of ISOTP_Config.h                                                                          */
+/**************************************************************************************************/
@@ -0,0 +1,125 @@
+#ifndef _ISOTP_PRIV_H_
+#define _ISOTP_PRIV_H_
+
+/**************************************************************************************************/
+/* System Header Files Section                                                                    */
+/**************************************************************************************************/
+
+/**************************************************************************************************/
+/* User Header Files Section                                                                      */
+/**************************************************************************************************/
+
+/**************************************************************************************************/
+/* Private Global Definitions Section                                                             */
+/**************************************************************************************************/
+
+/* Protocol control information, high nibble of the first byte */
+#define ISOTP_PCI_SF                        (0x00U)
+#define ISOTP_PCI_FF                        (0x10U)
+#define ISOTP_PCI_CF                        (0x20U)
+#define ISOTP_PCI_FC                        (0x30U)
+#define ISOTP_PCI_TYPE_MASK                 (0xF0U)
+
+/* Flow status of a flow control frame */
+#define ISOTP_FS_CTS                        (0x00U)
+#define ISOTP_FS_WAIT                       (0x01U)
+#define ISOTP_FS_OVFLW                      (0x02U)
+
+/* Largest STmin in ms, reserved STmin values are handled as this one */
+#define ISOTP_STMIN_MS_MAX                  (0x7FU)
+
+/* Frames queued to CAN IF and not yet confirmed, power of two */
+#define ISOTP_TX_RING_SIZE                  (16U)
+
+/* Ring tag of a flow control frame, data frames carry the number of their transfer */
+#define ISOTP_TX_TAG_FC                     (0x00U)
+
+typedef enum
+{
+    ISOTP_TX_IDLE = 0,
+    /* Single, first or consecutive frames are being queued and confirmed */
+    ISOTP_TX_SENDING,
+    /* Block (or first frame) confirmed, waiting for the flow control of the receiver */
+    ISOTP_TX_WAIT_FC
+
+}EN_ISOTP_TX_STATE_t;
+
+typedef enum
+{
+    ISOTP_RX_IDLE = 0,
+    /* First frame received, the upper layer is asked for the buffer */
+    ISOTP_RX_ALLOC,
+    /* Waiting for the consecutive frames */
+    ISOTP_RX_WAIT_CF
+
+}EN_ISOTP_RX_STATE_t;
+
+/* Deferred upper layer call, made once the critical section is left */
+typedef struct
+{
+    BOOLEAN b_mPending;
+    INT8U * p_mData;
+    INT32U u32_mLength;
+    EN_ISOTP_N_RESULT_t en_mResult;
+
+}ST_ISOTP_INDICATION_t;
+
+/* Runtime context of the connection */
+typedef struct
+{
+    ST_ISOTP_INIT_t st_mConfig;
+
+    /* Tx side */
+    EN_ISOTP_TX_STATE_t en_mTxState;
+    const INT8U * p_mTxData;
+    INT32U u32_mTxLength;
+    /* Bytes queued to CAN IF so far */
+    INT32U u32_mTxOffset;
+    INT8U u8_mTxSN;
+    /* Data frames of the current transfer queued and not yet confirmed */
+    INT8U u8_mTxInFlight;
+    /* Consecutive frames left in the block, ignored while b_mTxBsUnlimited */
+    INT8U u8_mTxBsLeft;
+    BOOLEAN b_mTxBsUnlimited;
+    INT8U u8_mTxWaitCount;
+    /* STmin of the receiver in bit times */
+    INT32U u32_mTxStMin;
+    /* Reference time of the N_As / N_Bs supervision and of STmin */
+    INT32U u32_mTxTimer;
+    /* Transfer number, tags the data frames in the Tx ring */
+    INT8U u8_mTxTag;
+    /* Confirmation waiting for ISOTP_MainFunction() */
+    BOOLEAN b_mTxConfPending;
+    EN_ISOTP_N_RESULT_t en_mTxResult;
+
+    /* Tags of the frames queued to CAN IF, in transmission order */
+    INT8U u8_maTxRing[ISOTP_TX_RING_SIZE];
+    INT8U u8_mTxRingHead;
+    INT8U u8_mTxRingCount;
+
+    /* Rx side */
+    EN_ISOTP_RX_STATE_t en_mRxState;
+    INT8U * p_mRxData;
+    INT32U u32_mRxLength;
+    INT32U u32_mRxOffset;
+    INT8U u8_mRxSN;
+    /* Consecutive frames left before the next flow control frame */
+    INT8U u8_mRxBsLeft;
+    /* Reference time of the N_Cr supervision */
+    INT32U u32_mRxTimer;
+
+}ST_ISOTP_CONTEXT_t;
+
+/**************************************************************************************************/
+/* Private Global Variables Section                                                               */
+/**************************************************************************************************/
+
+/**************************************************************************************************/
+/* Private Functions Section                                                                      */
+/**************************************************************************************************/
+
+#endif
+
+/**************************************************************************************************/
+/* End of ISOTP_Priv.h                                                                            */
+/**************************************************************************************************/
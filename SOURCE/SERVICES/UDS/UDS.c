@@ -0,0 +1,321 @@
+/**************************************************************************************************/
+/* System Header Files Section                                                                    */
+/**************************************************************************************************/
+#include <string.h>
+
+/**************************************************************************************************/
+/* User Header Files Section                                                                      */
+/**************************************************************************************************/
+#include "Includes.h"
+#include "./CAN_IF/CAN_IF.h"
+#include "./CAN_IF/CAN_IF_Config.h"
+#include "./ISOTP/ISOTP.h"
+#include "UDS.h"
+#include "UDS_Config.h"
+#include "UDS_Priv.h"
+
+/**************************************************************************************************/
+/* Global Definitions Section                                                                     */
+/**************************************************************************************************/
+
+/* S3 in CAN IF ticks */
+#define UDS_S3_TICKS                        ((UDS_S3_MS * 1000UL) / CAN_IF_TICK_US)
+
+/**************************************************************************************************/
+/* Global Variables Section                                                                       */
+/**************************************************************************************************/
+
+/* Server context */
+static ST_UDS_CONTEXT_t st_gUds;
+
+/**************************************************************************************************/
+/* Function Name   : UDS_GetRxBuffer                                                              */
+/*                                                                                                */
+/* Description     : Buffer of an incoming request, refused while the previous request is not     */
+/*                   answered yet or if it does not fit                                           */
+/*                                                                                                */
+/* In Params       : INT32U u32_fLength : Request length in bytes                                 */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT8U * : Request buffer, PNULL to reject the request                        */
+/**************************************************************************************************/
+
+static INT8U * UDS_GetRxBuffer(INT32U u32_fLength)
+{
+    INT8U * p_lBuffer = PNULL;
+
+    if((0U == st_gUds.u32_mRxLength) && (u32_fLength <= UDS_BUFFER_SIZE))
+    {
+        p_lBuffer = &st_gUds.u8_maRxData[0];
+    }
+    else
+    {
+        /* No Action */
+    }
+
+    return p_lBuffer;
+}
+
+/**************************************************************************************************/
+/* Function Name   : UDS_RxIndication                                                             */
+/*                                                                                                */
+/* Description     : End of the reception of a request, a complete request is answered by         */
+/*                   UDS_MainFunction()                                                           */
+/*                                                                                                */
+/* In Params       : INT8U * p_fData : Request buffer                                             */
+/*                   INT32U u32_fLength : Request length in bytes                                 */
+/*                   EN_ISOTP_N_RESULT_t en_fResult : Result of the reception                     */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void UDS_RxIndication(INT8U * p_fData, INT32U u32_fLength, EN_ISOTP_N_RESULT_t en_fResult)
+{
+    (void)p_fData;
+
+    if((ISOTP_N_OK == en_fResult) && (0U != u32_fLength))
+    {
+        st_gUds.u32_mRxLength = u32_fLength;
+    }
+    else
+    {
+        /* No Action */
+    }
+}
+
+/**************************************************************************************************/
+/* Function Name   : UDS_TxConfirmation                                                           */
+/*                                                                                                */
+/* Description     : End of the transmission of a response, releases the response buffer          */
+/*                                                                                                */
+/* In Params       : EN_ISOTP_N_RESULT_t en_fResult : Result of the transmission                  */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+static void UDS_TxConfirmation(EN_ISOTP_N_RESULT_t en_fResult)
+{
+    (void)en_fResult;
+
+    st_gUds.b_mTxBusy = 0U;
+}
+
+/**************************************************************************************************/
+/* Function Name   : UDS_NegativeResponse                                                         */
+/*                                                                                                */
+/* Description     : Builds the negative response to a request                                    */
+/*                                                                                                */
+/* In Params       : INT8U u8_fSid : Service of the request                                       */
+/*                   INT8U u8_fNrc : Negative response code                                       */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT32U : Response length in bytes                                            */
+/**************************************************************************************************/
+
+static INT32U UDS_NegativeResponse(INT8U u8_fSid, INT8U u8_fNrc)
+{
+    st_gUds.u8_maTxData[0] = UDS_SID_NEGATIVE_RESPONSE;
+    st_gUds.u8_maTxData[1] = u8_fSid;
+    st_gUds.u8_maTxData[2] = u8_fNrc;
+
+    return 3U;
+}
+
+/**************************************************************************************************/
+/* Function Name   : UDS_SessionControl                                                           */
+/*                                                                                                */
+/* Description     : DiagnosticSessionControl : switches between the default and the extended     */
+/*                   session and reports P2 and P2*                                               */
+/*                                                                                                */
+/* In Params       : const INT8U * p_fReq : Request                                               */
+/*                   INT32U u32_fLength : Request length in bytes                                 */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT32U : Response length in bytes, 0 for no response                         */
+/**************************************************************************************************/
+
+static INT32U UDS_SessionControl(const INT8U * p_fReq, INT32U u32_fLength)
+{
+    INT32U u32_lLength;
+    INT8U u8_lSession;
+
+    u8_lSession = (u32_fLength > 1U) ? (INT8U)(p_fReq[1] & UDS_SUBFUNCTION_MASK) : 0U;
+
+    if(2U != u32_fLength)
+    {
+        u32_lLength = UDS_NegativeResponse(p_fReq[0], UDS_NRC_INVALID_LENGTH);
+    }
+    else if((UDS_SESSION_DEFAULT != u8_lSession) && (UDS_SESSION_EXTENDED != u8_lSession))
+    {
+        u32_lLength = UDS_NegativeResponse(p_fReq[0], UDS_NRC_SUBFUNCTION_NOT_SUPPORTED);
+    }
+    else
+    {
+        st_gUds.u8_mSession = u8_lSession;
+
+        st_gUds.u8_maTxData[0] = UDS_SID_SESSION_CONTROL + UDS_SID_RESPONSE_OFFSET;
+        st_gUds.u8_maTxData[1] = u8_lSession;
+        st_gUds.u8_maTxData[2] = (INT8U)(UDS_P2_MS >> 8);
+        st_gUds.u8_maTxData[3] = (INT8U)UDS_P2_MS;
+        st_gUds.u8_maTxData[4] = (INT8U)(UDS_P2_EXT_10MS >> 8);
+        st_gUds.u8_maTxData[5] = (INT8U)UDS_P2_EXT_10MS;
+        u32_lLength = (0U != (p_fReq[1] & UDS_SUPPRESS_POS_RSP)) ? 0U : 6U;
+    }
+
+    return u32_lLength;
+}
+
+/**************************************************************************************************/
+/* Function Name   : UDS_TesterPresent                                                            */
+/*                                                                                                */
+/* Description     : TesterPresent : keeps the current session alive                              */
+/*                                                                                                */
+/* In Params       : const INT8U * p_fReq : Request                                               */
+/*                   INT32U u32_fLength : Request length in bytes                                 */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : INT32U : Response length in bytes, 0 for no response                         */
+/**************************************************************************************************/
+
+static INT32U UDS_TesterPresent(const INT8U * p_fReq, INT32U u32_fLength)
+{
+    INT32U u32_lLength;
+
+    if(2U != u32_fLength)
+    {
+        u32_lLength = UDS_NegativeResponse(p_fReq[0], UDS_NRC_INVALID_LENGTH);
+    }
+    else if(0U != (p_fReq[1] & UDS_SUBFUNCTION_MASK))
+    {
+        u32_lLength = UDS_NegativeResponse(p_fReq[0], UDS_NRC_SUBFUNCTION_NOT_SUPPORTED);
+    }
+    else
+    {
+        st_gUds.u8_maTxData[0] = UDS_SID_TESTER_PRESENT + UDS_SID_RESPONSE_OFFSET;
+        st_gUds.u8_maTxData[1] = 0U;
+        u32_lLength = (0U != (p_fReq[1] & UDS_SUPPRESS_POS_RSP)) ? 0U : 2U;
+    }
+
+    return u32_lLength;
+}
+
+/**************************************************************************************************/
+/* Function Name   : UDS_Init                                                                     */
+/*                                                                                                */
+/* Description     : Resets the server to the default session and opens its ISO TP connection.    */
+/*                   To be called before CAN_IF_Init(), which compiles the request ID into the    */
+/*                   acceptance filters of the channel.                                           */
+/*                                                                                                */
+/* In Params       : None                                                                         */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : EN_UDS_RESULT_t : UDS_ERROR if ISO TP refuses the connection                 */
+/**************************************************************************************************/
+
+EN_UDS_RESULT_t UDS_Init(void)
+{
+    EN_UDS_RESULT_t en_lResult = UDS_OK;
+    const ST_ISOTP_INIT_t st_lIsoTp =
+    {
+        .u8_mChannel = UDS_CHANNEL,
+        .u16_mReqID = UDS_REQ_ID,
+        .u16_mRespID = UDS_RESP_ID,
+        .u8_mTxDl = UDS_TX_DL,
+        .u8_mRxBs = UDS_RX_BS,
+        .u8_mRxStMin = UDS_RX_STMIN,
+        .fp_mGetRxBuffer = &UDS_GetRxBuffer,
+        .fp_mRxIndication = &UDS_RxIndication,
+        .fp_mTxConfirmation = &UDS_TxConfirmation
+    };
+
+    memset((void *)&st_gUds, 0, sizeof(st_gUds));
+    st_gUds.u8_mSession = UDS_SESSION_DEFAULT;
+
+    if(ISOTP_OK != ISOTP_Init(&st_lIsoTp))
+    {
+        en_lResult = UDS_ERROR;
+    }
+
+    return en_lResult;
+}
+
+/**************************************************************************************************/
+/* Function Name   : UDS_MainFunction                                                             */
+/*                                                                                                */
+/* Description     : Answers the pending request through ISOTP_Transmit() once the previous       */
+/*                   response is confirmed, and falls back to the default session after S3        */
+/*                   without request. A request ISO TP cannot take yet is retried on the next     */
+/*                   call.                                                                        */
+/*                                                                                                */
+/* In Params       : None                                                                         */
+/*                                                                                                */
+/* Out Params      : None                                                                         */
+/*                                                                                                */
+/* Return Value    : void                                                                         */
+/**************************************************************************************************/
+
+void UDS_MainFunction(void)
+{
+    const INT8U * p_lReq = &st_gUds.u8_maRxData[0];
+    INT32U u32_lRxLength = st_gUds.u32_mRxLength;
+    INT32U u32_lTxLength;
+    INT32U u32_lNow;
+
+    u32_lNow = CAN_IF_GetTickCount();
+
+    if((0U != u32_lRxLength) && (0U == st_gUds.b_mTxBusy))
+    {
+        switch(p_lReq[0])
+        {
+            case UDS_SID_SESSION_CONTROL:
+                u32_lTxLength = UDS_SessionControl(p_lReq, u32_lRxLength);
+                break;
+
+            case UDS_SID_TESTER_PRESENT:
+                u32_lTxLength = UDS_TesterPresent(p_lReq, u32_lRxLength);
+                break;
+
+            default:
+                u32_lTxLength = UDS_NegativeResponse(p_lReq[0], UDS_NRC_SERVICE_NOT_SUPPORTED);
+                break;
+        }
+
+        if(0U == u32_lTxLength)
+        {
+            st_gUds.u32_mRxLength = 0U;
+        }
+        else if(ISOTP_OK == ISOTP_Transmit(&st_gUds.u8_maTxData[0], u32_lTxLength))
+        {
+            st_gUds.b_mTxBusy = 1U;
+            st_gUds.u32_mRxLength = 0U;
+        }
+        else
+        {
+            /* No Action */
+        }
+
+        st_gUds.u32_mLastRequest = u32_lNow;
+    }
+    else if((UDS_SESSION_DEFAULT != st_gUds.u8_mSession) && \
+            ((INT32U)(u32_lNow - st_gUds.u32_mLastRequest) > UDS_S3_TICKS))
+    {
+        st_gUds.u8_mSession = UDS_SESSION_DEFAULT;
+    }
+    else
+    {
+        /* No Action */
+    }
+}
+
+/**************************************************************************************************/
+/* End of UDS.c                                                                                   */
+/**************************************************************************************************/
@@ -0,0 +1,43 @@
+#ifndef _UDS_H_
+#define _UDS_H_
+
+/**************************************************************************************************/
+/* System Header Files Section                                                                    */
+/**************************************************************************************************/
+#include "Includes.h"
+
+/**************************************************************************************************/
+/* User Header Files Section                                                                      */
+/**************************************************************************************************/
+
+/**************************************************************************************************/
+/* Export Global Definitions Section                                                              */
+/**************************************************************************************************/
+
+typedef enum
+{
+    UDS_OK = 0x00,
+    UDS_ERROR
+
+}EN_UDS_RESULT_t;
+
+/**************************************************************************************************/
+/* Export Global Variable Section                                                                 */
+/**************************************************************************************************/
+
+/**************************************************************************************************/
+/* Export Functions Section                                                                       */
+/**************************************************************************************************/
+
+/* Opens the ISO TP connection of the server, to be called before CAN_IF_Init() */
+extern EN_UDS_RESULT_t UDS_Init(void);
+
+/* Answers the pending request and runs S3, to be called cyclically (1 ms) after */
+/* ISOTP_MainFunction()                                                            */
+extern void UDS_MainFunction(void);
+
+#endif
+
+/**************************************************************************************************/
+/* End of UDS.h                                                                                   */
+/**************************************************************************************************/
@@ -0,0 +1,29 @@
+#ifndef _UDS_CONFIG_H_
+#define _UDS_CONFIG_H_
+
+/* ISO TP connection of the diagnostic server : CAN IF channel, physical request and response */
+/* IDs, Tx CAN frame length (8 for classic CAN, 12 .. 64 for CAN FD)                           */
+#define UDS_CHANNEL                         (CAN_IF_CHANNEL_0)
+#define UDS_REQ_ID                          (0x7E5U)
+#define UDS_RESP_ID                         (0x7EDU)
+#define UDS_TX_DL                           (8U)
+
+/* Block size and STmin sent in the flow control frames of the requests */
+#define UDS_RX_BS                           (0U)
+#define UDS_RX_STMIN                        (0U)
+
+/* Longest request and response in bytes */
+#define UDS_BUFFER_SIZE                     (64U)
+
+/* Session timing reported by DiagnosticSessionControl : P2 in ms, P2* in units of 10 ms */
+#define UDS_P2_MS                           (50U)
+#define UDS_P2_EXT_10MS                     (500U)
+
+/* S3 : a non default session without request for this long falls back to the default one */
+#define UDS_S3_MS                           (5000UL)
+
+#endif
+
+/**************************************************************************************************/
+/* End of UDS_Config.h                                                                            */
+/**************************************************************************************************/
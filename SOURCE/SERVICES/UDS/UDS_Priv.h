@@ -0,0 +1,64 @@
+#ifndef _UDS_PRIV_H_
+#define _UDS_PRIV_H_
+
+/**************************************************************************************************/
+/* System Header Files Section                                                                    */
+/**************************************************************************************************/
+
+/**************************************************************************************************/
+/* User Header Files Section                                                                      */
+/**************************************************************************************************/
+
+/**************************************************************************************************/
+/* Private Global Definitions Section                                                             */
+/**************************************************************************************************/
+
+/* Service identifiers, the positive response is the SID plus UDS_SID_RESPONSE_OFFSET */
+#define UDS_SID_SESSION_CONTROL             (0x10U)
+#define UDS_SID_TESTER_PRESENT              (0x3EU)
+#define UDS_SID_NEGATIVE_RESPONSE           (0x7FU)
+#define UDS_SID_RESPONSE_OFFSET             (0x40U)
+
+/* Sub-function byte : suppressPosRspMsgIndicationBit and sub-function value */
+#define UDS_SUPPRESS_POS_RSP                (0x80U)
+#define UDS_SUBFUNCTION_MASK                (0x7FU)
+
+/* Sessions of DiagnosticSessionControl */
+#define UDS_SESSION_DEFAULT                 (0x01U)
+#define UDS_SESSION_EXTENDED                (0x03U)
+
+/* Negative response codes */
+#define UDS_NRC_SERVICE_NOT_SUPPORTED       (0x11U)
+#define UDS_NRC_SUBFUNCTION_NOT_SUPPORTED   (0x12U)
+#define UDS_NRC_INVALID_LENGTH              (0x13U)
+
+/* Server context */
+typedef struct
+{
+    /* Request, owned by ISO TP between UDS_GetRxBuffer() and UDS_RxIndication() */
+    INT8U u8_maRxData[UDS_BUFFER_SIZE];
+    /* Response, owned by ISO TP between ISOTP_Transmit() and UDS_TxConfirmation() */
+    INT8U u8_maTxData[UDS_BUFFER_SIZE];
+    /* Length of the request waiting for UDS_MainFunction(), 0 for none */
+    volatile INT32U u32_mRxLength;
+    /* A response is being sent */
+    volatile BOOLEAN b_mTxBusy;
+    INT8U u8_mSession;
+    /* CAN IF tick of the last request, reference of S3 */
+    INT32U u32_mLastRequest;
+
+}ST_UDS_CONTEXT_t;
+
+/**************************************************************************************************/
+/* Private Global Variables Section                                                               */
+/**************************************************************************************************/
+
+/**************************************************************************************************/
+/* Private Functions Section                                                                      */
+/**************************************************************************************************/
+
+#endif
+
+/**************************************************************************************************/
+/* End of UDS_Priv.h                                                                              */
+/**************************************************************************************************/
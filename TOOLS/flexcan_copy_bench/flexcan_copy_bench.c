@@ -0,0 +1,233 @@
+/*
+ * Host microbenchmark of the FlexCAN payload copy : byte-wise copy through
+ * FLEXCAN_SWAP_BYTES_IN_WORD_INDEX (before) against the word-wise copy with one
+ * byte reverse per word of FLEXCAN_HAL_ReadMsgBuffData / WriteMsgBuffData
+ * (fsl_flexcan_hal.c). The MB data area is a volatile array standing for the
+ * FlexCAN RAM, so both versions keep their peripheral access pattern.
+ *
+ * Build and run on the host :
+ *     gcc -O2 -o flexcan_copy_bench flexcan_copy_bench.c && ./flexcan_copy_bench
+ *
+ * Host timings only show the relative cost, the cycle counts on target come from
+ * FLEXCAN_DRV_GetIsrStats() in a FLEXCAN_ISR_PROFILING build.
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define FLEXCAN_REV(x)                          ((uint32_t)__builtin_bswap32(x))
+#define FLEXCAN_SWAP_BYTES_IN_WORD_INDEX(index) (((index) & ~3U) + (3U - ((index) & 3U)))
+#define FLEXCAN_PADDING_WORD(padding)           ((uint32_t)(padding) * 0x01010101U)
+
+#define BENCH_ITERATIONS                        (2000000UL)
+
+/* MB data area, 64 bytes for CAN FD */
+static volatile uint32_t mb_data[16];
+
+/* Sink keeping the copies alive */
+static volatile uint32_t sink;
+
+/* Byte-wise versions, as in SetTxMsgBuff / GetMsgBuff before the change */
+static void ReadBytewise(volatile const uint32_t *mbData, uint8_t *data, uint32_t len)
+{
+    volatile const uint8_t *mbBytes = (volatile const uint8_t *)mbData;
+    uint32_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        data[i] = mbBytes[FLEXCAN_SWAP_BYTES_IN_WORD_INDEX(i)];
+    }
+}
+
+static void WriteBytewise(volatile uint32_t *mbData, const uint8_t *data, uint32_t len,
+                          uint32_t payloadSize, uint8_t padding)
+{
+    volatile uint8_t *mbBytes = (volatile uint8_t *)mbData;
+    uint32_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        mbBytes[FLEXCAN_SWAP_BYTES_IN_WORD_INDEX(i)] = data[i];
+    }
+    for (i = len; i < payloadSize; i++)
+    {
+        mbBytes[FLEXCAN_SWAP_BYTES_IN_WORD_INDEX(i)] = padding;
+    }
+}
+
+/* Word-wise versions, same code as FLEXCAN_HAL_ReadMsgBuffData / WriteMsgBuffData */
+static void ReadWordwise(volatile const uint32_t *mbData, uint8_t *data, uint32_t len)
+{
+    uint32_t words = len >> 2U;
+    uint32_t word;
+    uint32_t i;
+
+    for (i = 0; i < words; i++)
+    {
+        word = FLEXCAN_REV(mbData[i]);
+        memcpy(&data[i << 2U], &word, sizeof(word));
+    }
+
+    len &= 3U;
+    if (len != 0U)
+    {
+        word = mbData[words];
+        data += words << 2U;
+        for (i = 0; i < len; i++)
+        {
+            data[i] = (uint8_t)(word >> (24U - (i << 3U)));
+        }
+    }
+}
+
+static void WriteWordwise(volatile uint32_t *mbData, const uint8_t *data, uint32_t len,
+                          uint32_t payloadSize, uint8_t padding)
+{
+    uint32_t words = len >> 2U;
+    uint32_t pad_word = FLEXCAN_PADDING_WORD(padding);
+    uint32_t word;
+    uint32_t i;
+
+    for (i = 0; i < words; i++)
+    {
+        memcpy(&word, &data[i << 2U], sizeof(word));
+        mbData[i] = FLEXCAN_REV(word);
+    }
+
+    len &= 3U;
+    if (len != 0U)
+    {
+        word = pad_word;
+        data += words << 2U;
+        for (i = 0; i < len; i++)
+        {
+            word &= ~(0xFF000000U >> (i << 3U));
+            word |= (uint32_t)data[i] << (24U - (i << 3U));
+        }
+        mbData[words] = word;
+        words++;
+    }
+
+    for (i = words; i < ((payloadSize + 3U) >> 2U); i++)
+    {
+        mbData[i] = pad_word;
+    }
+}
+
+static double NowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec;
+}
+
+/* Both versions must give the same bytes for every length and payload size */
+static int Check(void)
+{
+    static const uint8_t sizes[] = {8, 12, 16, 20, 24, 32, 48, 64};
+    uint8_t src[65];
+    uint8_t a[64];
+    uint8_t b[64];
+    uint32_t mbA[16];
+    uint32_t s;
+    uint32_t len;
+    uint32_t i;
+
+    for (i = 0; i < sizeof(src); i++)
+    {
+        src[i] = (uint8_t)(i * 37U + 1U);
+    }
+
+    for (s = 0; s < sizeof(sizes); s++)
+    {
+        for (len = 0; len <= sizes[s]; len++)
+        {
+            /* Unaligned user buffer */
+            WriteBytewise(mb_data, &src[1], len, sizes[s], 0xCC);
+            for (i = 0; i < 16U; i++)
+            {
+                mbA[i] = mb_data[i];
+            }
+            WriteWordwise(mb_data, &src[1], len, sizes[s], 0xCC);
+            for (i = 0; i < ((sizes[s] + 3U) >> 2U); i++)
+            {
+                if (mbA[i] != mb_data[i])
+                {
+                    return -1;
+                }
+            }
+
+            ReadBytewise(mb_data, a, sizes[s]);
+            ReadWordwise(mb_data, b, sizes[s]);
+            if (memcmp(a, b, sizes[s]) != 0)
+            {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static void Bench(uint32_t len)
+{
+    uint8_t src[64];
+    uint8_t dst[64];
+    double t0;
+    double tReadB, tReadW, tWriteB, tWriteW;
+    unsigned long n;
+
+    memset(src, 0x5A, sizeof(src));
+
+    t0 = NowNs();
+    for (n = 0; n < BENCH_ITERATIONS; n++)
+    {
+        WriteBytewise(mb_data, src, len, len, 0);
+    }
+    tWriteB = (NowNs() - t0) / (double)BENCH_ITERATIONS;
+
+    t0 = NowNs();
+    for (n = 0; n < BENCH_ITERATIONS; n++)
+    {
+        WriteWordwise(mb_data, src, len, len, 0);
+    }
+    tWriteW = (NowNs() - t0) / (double)BENCH_ITERATIONS;
+
+    t0 = NowNs();
+    for (n = 0; n < BENCH_ITERATIONS; n++)
+    {
+        ReadBytewise(mb_data, dst, len);
+        sink = dst[len - 1U];
+    }
+    tReadB = (NowNs() - t0) / (double)BENCH_ITERATIONS;
+
+    t0 = NowNs();
+    for (n = 0; n < BENCH_ITERATIONS; n++)
+    {
+        ReadWordwise(mb_data, dst, len);
+        sink = dst[len - 1U];
+    }
+    tReadW = (NowNs() - t0) / (double)BENCH_ITERATIONS;
+
+    printf("%2u bytes : write byte-wise %6.2f ns, word-wise %6.2f ns (x%.1f)\n",
+           (unsigned)len, tWriteB, tWriteW, tWriteB / tWriteW);
+    printf("%2u bytes : read  byte-wise %6.2f ns, word-wise %6.2f ns (x%.1f)\n",
+           (unsigned)len, tReadB, tReadW, tReadB / tReadW);
+}
+
+int main(void)
+{
+    if (Check() != 0)
+    {
+        printf("Mismatch between the byte-wise and word-wise copies\n");
+        return 1;
+    }
+
+    Bench(8U);
+    Bench(64U);
+
+    return 0;
+}